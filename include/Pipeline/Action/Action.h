@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Pipeline/Common.h"
+#include "Pipeline/CancellationToken.h"
+#include "Pipeline/Clock.h"
 #include <memory>
 #include <variant>
 #include <string>
@@ -10,6 +12,8 @@ namespace Pipeline {
 
 // 前向声明
 class RecognitionResult;
+class Pipeline;
+class VariableManager;
 
 // 动作类型枚举
 enum class ActionType {
@@ -24,6 +28,29 @@ enum class ActionType {
     Command      // 执行命令
 };
 
+// 动作执行上下文，由流水线在每次执行动作时传入
+struct PIPELINE_API ActionContext {
+    VariableManager* variables = nullptr;       // 变量管理器
+    Pipeline* pipeline = nullptr;               // 所属流水线
+    const CancellationToken* token = nullptr;   // 取消令牌，流水线停止或暂停时被取消
+    Clock* clock = nullptr;                     // 运行时的时钟，为空时使用steady_clock
+
+    // 是否已取消
+    bool isCancelled() const { return token && token->isCancelled(); }
+
+    // 等待指定时长，期间被取消时立即返回false，虚拟时钟下推进时钟而不实际等待
+    bool waitFor(std::chrono::milliseconds duration) const {
+        if (clock) {
+            return clock->sleepFor(duration, token);
+        }
+        if (token) {
+            return token->waitFor(duration);
+        }
+        std::this_thread::sleep_for(duration);
+        return true;
+    }
+};
+
 // 动作基类
 class PIPELINE_API Action {
 public:
@@ -35,20 +62,18 @@ public:
     ActionType getType() const { return m_type; }
 
     // 纯虚函数，由派生类实现
-    virtual bool execute(const RecognitionResult& result) = 0;
+    // 耗时的动作应在执行过程中检查context.isCancelled()，被取消时尽快返回false
+    // 动作对象在流水线实例之间共享，执行时不能修改自身状态
+    virtual bool execute(const RecognitionResult& result, const ActionContext& context) const = 0;
     
     // 解析参数，由派生类实现
     virtual bool parseConfig(const nlohmann::json& config) = 0;
     
-    // 设置变量管理器
-    void setVariableManager(VariableManager* variableManager) { m_variableManager = variableManager; }
-    
     // 工厂方法，根据类型创建动作对象
     static std::unique_ptr<Action> create(ActionType type, const nlohmann::json& config);
 
 protected:
     ActionType m_type;
-    VariableManager* m_variableManager = nullptr;
 };
 
 // 将字符串转换为动作类型
@@ -8,7 +8,7 @@ namespace Pipeline {
 class PIPELINE_API StartAppAction : public Action {
 public:
     StartAppAction();
-    virtual bool execute(const RecognitionResult& result) override;
+    virtual bool execute(const RecognitionResult& result, const ActionContext& context) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
 
 private:
@@ -19,7 +19,7 @@ private:
 class PIPELINE_API StopAppAction : public Action {
 public:
     StopAppAction();
-    virtual bool execute(const RecognitionResult& result) override;
+    virtual bool execute(const RecognitionResult& result, const ActionContext& context) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
 
 private:
@@ -8,7 +8,7 @@ namespace Pipeline {
 class PIPELINE_API DoNothingAction : public Action {
 public:
     DoNothingAction();
-    virtual bool execute(const RecognitionResult& result) override;
+    virtual bool execute(const RecognitionResult& result, const ActionContext& context) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
 };
 
@@ -16,7 +16,7 @@ public:
 class PIPELINE_API StopTaskAction : public Action {
 public:
     StopTaskAction();
-    virtual bool execute(const RecognitionResult& result) override;
+    virtual bool execute(const RecognitionResult& result, const ActionContext& context) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
 };
 
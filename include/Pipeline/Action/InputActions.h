@@ -8,7 +8,7 @@ namespace Pipeline {
 class PIPELINE_API ClickAction : public Action {
 public:
     ClickAction();
-    virtual bool execute(const RecognitionResult& result) override;
+    virtual bool execute(const RecognitionResult& result, const ActionContext& context) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
 
 private:
@@ -20,7 +20,7 @@ private:
 class PIPELINE_API SwipeAction : public Action {
 public:
     SwipeAction();
-    virtual bool execute(const RecognitionResult& result) override;
+    virtual bool execute(const RecognitionResult& result, const ActionContext& context) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
 
 private:
@@ -35,7 +35,7 @@ private:
 class PIPELINE_API KeyAction : public Action {
 public:
     KeyAction();
-    virtual bool execute(const RecognitionResult& result) override;
+    virtual bool execute(const RecognitionResult& result, const ActionContext& context) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
 
 private:
@@ -46,7 +46,7 @@ private:
 class PIPELINE_API TextAction : public Action {
 public:
     TextAction();
-    virtual bool execute(const RecognitionResult& result) override;
+    virtual bool execute(const RecognitionResult& result, const ActionContext& context) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
 
 private:
@@ -8,7 +8,7 @@ namespace Pipeline {
 class PIPELINE_API CommandAction : public Action {
 public:
     CommandAction();
-    virtual bool execute(const RecognitionResult& result) override;
+    virtual bool execute(const RecognitionResult& result, const ActionContext& context) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
 
 private:
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace Pipeline {
+
+// 取消令牌，流水线停止或暂停时取消，识别、动作和各种等待据此尽快返回
+class PIPELINE_API CancellationToken {
+public:
+    using CallbackId = uint64_t;
+
+    CancellationToken() = default;
+
+    // 不可复制
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    // 取消令牌，唤醒所有等待者并调用已注册的回调
+    void cancel();
+
+    // 重置为未取消状态，已注册的回调保持不变
+    void reset();
+
+    // 是否已取消
+    bool isCancelled() const { return m_cancelled.load(std::memory_order_acquire); }
+
+    // 阻塞等待指定时长，期间被取消时立即返回false
+    bool waitFor(std::chrono::milliseconds duration) const;
+
+    // 注册取消回调，令牌已取消时立即在当前线程调用并返回0
+    // 回调在cancel()的调用线程上执行，不能阻塞，也不能注销本令牌的回调
+    CallbackId registerCallback(std::function<void()> callback);
+
+    // 注销取消回调，回调正在被cancel()调用时等待调用结束
+    // 返回后回调不会再被调用，回调可以只捕获调用者的裸指针
+    void unregisterCallback(CallbackId id);
+
+    // 永远不会被取消的令牌，用于不需要取消的调用
+    static const CancellationToken& none();
+
+private:
+    std::atomic<bool> m_cancelled{false};
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_condition;
+    std::vector<std::pair<CallbackId, std::function<void()>>> m_callbacks;
+    CallbackId m_nextCallbackId = 1;
+    size_t m_invoking = 0;                          // 正在锁外调用回调的cancel()数量
+};
+
+} // namespace Pipeline
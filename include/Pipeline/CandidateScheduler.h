@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include "Pipeline/Node.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace Pipeline {
+
+// 一条候选边（当前节点到候选节点）的统计信息
+struct PIPELINE_API EdgeStats {
+    NodeId from = InvalidNodeId;    // 当前节点
+    NodeId to = InvalidNodeId;      // 候选节点
+    uint64_t attempts = 0;          // 识别次数
+    uint64_t hits = 0;              // 命中次数
+    double averageCost = 0.0;       // 平均识别耗时（毫秒）
+    double score = 0.0;             // 预期耗时得分，越小越先评估
+};
+
+// 候选节点调度器，记录每条候选边的命中率和识别耗时
+// 按预期的命中耗时（平均耗时 / 命中率）从小到大排列候选节点
+// 同时保存设置了最小评估间隔的节点最近一次的识别结果，间隔内直接复用
+class PIPELINE_API CandidateScheduler {
+public:
+    CandidateScheduler() = default;
+
+    // 不可复制
+    CandidateScheduler(const CandidateScheduler&) = delete;
+    CandidateScheduler& operator=(const CandidateScheduler&) = delete;
+
+    // 记录一次候选节点识别，可以在多个线程上同时调用
+    void record(NodeId from, NodeId to, bool hit, std::chrono::steady_clock::duration cost);
+
+    // 按预期耗时重新排列候选节点，得分相同时保持原有顺序
+    // 还没有识别过的候选节点得分为0，优先评估；原地插入排序，不分配内存
+    void order(NodeId from, std::vector<NodeId>& candidates) const;
+
+    // 获取候选边的统计信息，按candidates的顺序返回
+    std::vector<EdgeStats> getStats(NodeId from, const std::vector<NodeId>& candidates) const;
+
+    // 查找节点在now之前minInterval之内的识别结果，没有时返回空值
+    std::optional<RecognitionResult> lookupSample(NodeId node, std::chrono::steady_clock::time_point now,
+                                                  std::chrono::milliseconds minInterval) const;
+
+    // 保存节点在time时刻的识别结果
+    void storeSample(NodeId node, std::chrono::steady_clock::time_point time, const RecognitionResult& result);
+
+    // 清空保存的识别结果，统计信息保持不变
+    void clearSamples();
+
+    // 清空统计信息和保存的识别结果
+    void clear();
+
+private:
+    struct Entry {
+        uint64_t attempts = 0;
+        uint64_t hits = 0;
+        double totalCost = 0.0;     // 总耗时（毫秒）
+    };
+
+    // 节点最近一次的识别结果
+    struct Sample {
+        std::chrono::steady_clock::time_point time;
+        RecognitionResult result;
+    };
+
+    static uint64_t makeKey(NodeId from, NodeId to) { return (static_cast<uint64_t>(from) << 32) | to; }
+
+    // 计算预期耗时得分，调用时需持有m_mutex
+    static double score(const Entry& entry);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<uint64_t, Entry> m_entries;  // 以候选边为键的统计信息
+    std::unordered_map<NodeId, Sample> m_samples;   // 以节点为键的最近一次识别结果
+};
+
+} // namespace Pipeline
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include "Pipeline/Node.h"
+#include "Pipeline/VariableManager.h"
+
+namespace Pipeline {
+
+// 检查点记录的主流程执行阶段
+enum class CheckpointPhase : uint8_t {
+    Enter,          // 即将执行节点（条件处理、识别和动作都还没有进行），恢复后从头执行该节点
+    Recognize,      // 条件处理已经执行，正在识别，恢复后使用保存的分支重新识别，不重复执行变量操作
+    PostAction,     // 动作已经执行，正在等待后置延迟，恢复后等待剩余的延迟，不重新执行动作
+    Waiting         // 正在等待后继节点，恢复后继续评估候选节点，超时时间只剩下未用完的部分
+};
+
+// 流水线检查点，保存主流程的执行位置、等待中的定时、条件处理分支和所有变量
+// 节点按名称保存，可以恢复到另一个进程中加载了相同流水线定义的实例
+struct PIPELINE_API Checkpoint {
+    std::string nodeName;                                   // 主流程的当前节点
+    CheckpointPhase phase = CheckpointPhase::Enter;         // 当前节点的执行阶段
+    uint32_t remaining = 0;                                 // PostAction为剩余的后置延迟，Waiting为剩余的超时时间（毫秒）
+    bool actionSuccess = true;                              // PostAction阶段动作是否成功，失败时恢复后转到错误处理节点
+    std::vector<std::pair<std::string, BranchIndex>> branches;  // 生效的条件处理分支
+    std::vector<std::pair<std::string, Variable>> variables;    // 所有变量
+
+    // 序列化为紧凑的二进制格式，整数按小端序写入
+    std::vector<uint8_t> serialize() const;
+
+    // 从二进制数据解析，格式或版本不匹配时返回空值
+    static std::optional<Checkpoint> deserialize(const uint8_t* data, size_t size);
+    static std::optional<Checkpoint> deserialize(const std::vector<uint8_t>& data) {
+        return deserialize(data.data(), data.size());
+    }
+};
+
+} // namespace Pipeline
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include "Pipeline/CancellationToken.h"
+#include <atomic>
+
+namespace Pipeline {
+
+// 时钟接口，运行时、流水线和动作通过它获取当前时间和等待
+// 运行时持有一个时钟，未指定时使用steady_clock
+class PIPELINE_API Clock {
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    virtual ~Clock() = default;
+
+    // 获取当前时间
+    virtual time_point now() const = 0;
+
+    // 在当前线程上等待指定时长，期间token被取消时立即返回false
+    virtual bool sleepFor(std::chrono::milliseconds duration, const CancellationToken* token = nullptr) = 0;
+
+    // 进程内共享的steady_clock时钟
+    static std::shared_ptr<Clock> steady();
+};
+
+// 使用std::chrono::steady_clock的时钟
+class PIPELINE_API SteadyClock : public Clock {
+public:
+    time_point now() const override { return std::chrono::steady_clock::now(); }
+    bool sleepFor(std::chrono::milliseconds duration, const CancellationToken* token = nullptr) override;
+};
+
+// 虚拟时钟，时间只在advance/advanceTo时前进，可以在任意线程上调用
+// 交给运行时后，运行时在所有工作线程都空闲时直接把时间推进到最近的定时器到期时间，等待不消耗实际时间
+// 帧源和动作需要按同一个时钟工作，才能在虚拟时间下得到可重复的结果
+class PIPELINE_API VirtualClock : public Clock {
+public:
+    explicit VirtualClock(time_point start = time_point{}) : m_now(start.time_since_epoch().count()) {}
+
+    time_point now() const override { return time_point(time_point::duration(m_now.load(std::memory_order_acquire))); }
+
+    // 等待即推进时钟，相当于当前线程执行了duration的工作；token已经取消时不推进并返回false
+    bool sleepFor(std::chrono::milliseconds duration, const CancellationToken* token = nullptr) override;
+
+    // 将时钟推进到deadline，时间不会倒退，deadline早于当前时间时不改变时钟
+    void advanceTo(time_point deadline);
+
+    // 将时钟推进duration
+    void advance(std::chrono::steady_clock::duration duration) { advanceTo(now() + duration); }
+
+private:
+    std::atomic<time_point::rep> m_now;     // 当前时间，steady_clock的刻度数
+};
+
+} // namespace Pipeline
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+
+namespace Pipeline {
+
+class FrameSource;
+
+// 帧结构体，表示一次截图
+// 同一轮评估中的所有候选节点共享同一帧，保证判断结果的一致性
+struct PIPELINE_API Frame {
+    uint64_t id = 0;                                        // 帧序号，由流水线分配，识别缓存按它区分画面，0表示无效帧
+                                                            // epoch为0的逻辑帧也有帧序号，但每次识别自行截图，不缓存
+    uint64_t epoch = 0;                                     // 帧源的帧序号（纪元），同一帧源单调递增，0表示不是帧源产生的帧
+    std::chrono::steady_clock::time_point captureTime;      // 画面实际截取的时间，按流水线运行时的时钟计，缓存帧为截取时而不是取出时的时间
+    void* vision = nullptr;                                 // vision库的VisionHandle，为空时由VisionEngine自行截图
+    std::shared_ptr<const void> holder;                     // 持有帧数据，保证帧在使用期间有效
+    const FrameSource* source = nullptr;                    // 产生该帧的帧源，帧源据此确认holder中的数据类型
+
+    bool isValid() const { return id != 0; }
+};
+
+// 帧源接口，负责为流水线提供截图
+class PIPELINE_API FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    // 采集一帧，设置epoch而不是id，可以返回缓存的帧，流水线按captureTime判断帧是否在动作之后采集
+    // captureTime需要与流水线运行时的时钟（Clock）可比，使用虚拟时钟时帧源也按它计时
+    // 在holder中放置帧数据时同时把source设为自身，compareRegion据此识别自己产生的帧
+    // epoch为0表示采集失败
+    virtual Frame capture() = 0;
+
+    // 等待纪元大于lastEpoch的新帧，最多等待maxWait
+    // 有新帧时返回true，超时返回false；默认实现不支持通知，直接等待maxWait
+    virtual bool waitForNewFrame([[maybe_unused]] uint64_t lastEpoch, std::chrono::milliseconds maxWait) {
+        std::this_thread::sleep_for(maxWait);
+        return false;
+    }
+
+    // 注册一次性的新帧回调，产生纪元大于lastEpoch的新帧时调用，回调不能阻塞
+    // key由调用者提供，在回调调用或注销之前保持唯一；已经有新帧时可以立即调用；不支持通知时返回false
+    virtual bool notifyOnNewFrame([[maybe_unused]] uint64_t lastEpoch, [[maybe_unused]] const void* key,
+                                  [[maybe_unused]] std::function<void()> callback) {
+        return false;
+    }
+
+    // 注销key对应的尚未调用的新帧回调，等待超时或被取消后调用；回调已经调用或不存在时什么也不做
+    virtual void cancelNewFrameNotification([[maybe_unused]] const void* key) {}
+
+    // 比较两帧在roi内的差异，返回0到1之间的差异程度（例如变化像素的比例或归一化的平均像素差），roi为空时比较整帧
+    // 不支持比较时返回空值，此时只有纪元相同才视为画面未变化
+    virtual std::optional<double> compareRegion([[maybe_unused]] const Frame& previous,
+                                                [[maybe_unused]] const Frame& current,
+                                                [[maybe_unused]] const std::optional<Rect>& roi) {
+        return std::nullopt;
+    }
+};
+
+} // namespace Pipeline
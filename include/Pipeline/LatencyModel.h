@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include "Pipeline/Node.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace Pipeline {
+
+// 一次动作延迟的测量结果，均为相对动作结束的毫秒数
+struct PIPELINE_API LatencySample {
+    uint32_t start = 0;     // 画面开始变化的时间，画面没有变化时为0
+    uint32_t settle = 0;    // 画面停止变化的时间，画面没有变化时为0
+};
+
+// 动作延迟模型，按节点记录动作结束后画面开始和停止变化的时间
+// 每个节点只保留最近windowSize次测量，以其中的百分位数作为"post_delay": "auto"的后置延迟
+class PIPELINE_API LatencyModel {
+public:
+    // 样本少于minSamples时每次都测量，之后每remeasureInterval次执行重新测量一次，其余执行直接使用百分位数
+    explicit LatencyModel(size_t windowSize = 32, size_t minSamples = 5, size_t remeasureInterval = 8);
+
+    // 不可复制
+    LatencyModel(const LatencyModel&) = delete;
+    LatencyModel& operator=(const LatencyModel&) = delete;
+
+    // 记录一次测量，窗口已满时替换最旧的样本，可以在多个线程上同时调用
+    void record(NodeId node, const LatencySample& sample);
+
+    // 节点的本次执行是否需要测量，每次执行调用一次
+    bool shouldMeasure(NodeId node);
+
+    // 获取窗口内样本的百分位数（0到100），开始和停止变化的时间分别计算，没有样本时返回空值
+    std::optional<LatencySample> getPercentile(NodeId node, double percentile) const;
+
+    // 获取节点窗口内的样本数
+    size_t getSampleCount(NodeId node) const;
+
+    // 获取所有节点窗口内的样本，从旧到新排列，用于持久化
+    std::vector<std::pair<NodeId, std::vector<LatencySample>>> getSamples() const;
+
+    // 清空所有样本
+    void clear();
+
+private:
+    // 一个节点的滑动窗口
+    struct Window {
+        std::vector<LatencySample> samples;     // 环形缓冲区
+        size_t next = 0;                        // 下一个写入位置，窗口已满时也是最旧的样本
+        uint64_t executions = 0;                // 不需要测量时的执行次数，用于定期重新测量
+    };
+
+    size_t m_windowSize;
+    size_t m_minSamples;
+    size_t m_remeasureInterval;
+    mutable std::mutex m_mutex;
+    std::unordered_map<NodeId, Window> m_windows;   // 以节点ID为键的滑动窗口
+};
+
+} // namespace Pipeline
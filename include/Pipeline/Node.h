@@ -1,7 +1,10 @@
 #pragma once
 
 #include "Pipeline/Common.h"
+#include "Pipeline/Frame.h"
 #include "Pipeline/Recognition.h"
+#include "Pipeline/RecognitionCache.h"
+#include "Pipeline/RecognitionPool.h"
 #include "Pipeline/Action.h"
 #include "Pipeline/VariableManager.h"
 #include <map>
@@ -20,25 +23,71 @@ namespace nlohmann {
 // 前向声明
 class VariableManager;
 
+// 节点ID，加载时为每个节点分配的连续整数下标
+using NodeId = uint32_t;
+constexpr NodeId InvalidNodeId = static_cast<NodeId>(-1);
+
+// condition_process的分支下标，0为false分支，1为true分支
+// 生效的分支属于流水线实例的运行状态，由调用者保存并传给节点
+using BranchIndex = int8_t;
+constexpr BranchIndex NoBranch = -1;
+
+// 分叉节点的汇合方式
+enum class JoinMode {
+    All,    // 等待全部子流程结束，全部成功才算成功
+    Race    // 等待第一个结束的子流程，以它的结果为准，其余子流程被取消
+};
+
+// 画面稳定检测参数，pre_delay为"stable"时在识别前等待画面稳定，代替固定的前置延迟
+struct StableWait {
+    uint32_t minDelay = 0;          // 最少等待时间（毫秒）
+    uint32_t maxDelay = 1000;       // 最多等待时间（毫秒），画面一直变化时到达上限后直接识别
+    uint32_t frames = 3;            // 连续未变化的采样次数
+    uint32_t interval = 30;         // 两次采样之间最多等待的时间（毫秒），期间没有新帧也算一次未变化
+    double tolerance = 0.01;        // 识别区域内变化像素的比例不超过该值时视为未变化
+};
+
+// 自动后置延迟参数，post_delay为"auto"时按测量的动作延迟等待，采样方式与画面稳定检测相同
+struct AutoPostDelay {
+    uint32_t maxDelay = 2000;       // 测量时最多等待的时间，也是自动后置延迟的上限（毫秒）
+    double percentile = 90.0;       // 取最近测量结果的百分位数
+};
+
 // 节点类，表示流水线中的单个节点
+// 初始化之后不再修改，可以在多个流水线实例和线程之间共享
 class PIPELINE_API Node {
 public:
-    Node(const std::string& name);
+    Node(const std::string& name, NodeId id = InvalidNodeId);
     ~Node() = default;
 
-    // 从JSON配置初始化节点
-    bool initialize(const nlohmann::json& config, std::map<std::string, std::shared_ptr<Node>>& allNodes);
+    // 从JSON配置初始化节点，并将next/interrupt/on_error等节点名解析为节点ID
+    // 引用了不存在的节点时返回false
+    // 指定pool时，参数相同的识别对象从池中共享
+    bool initialize(const nlohmann::json& config, const std::unordered_map<std::string, NodeId>& nodeIds,
+                    RecognitionPool* pool = nullptr);
+
+    // 检查引用的节点在nodeIds中是否都存在且节点ID没有变化，用于热重载时判断节点能否复用
+    bool hasValidReferences(const std::unordered_map<std::string, NodeId>& nodeIds) const;
 
     // 执行节点的识别和动作
-    RecognitionResult executeRecognition();
-    std::vector<RecognitionResult> executeRecognitionBatch();
-    bool executeAction(const RecognitionResult& result);
+    RecognitionResult executeRecognition() const;
+    std::vector<RecognitionResult> executeRecognitionBatch() const;
+    bool executeAction(const RecognitionResult& result) const;
+
+    // 在指定帧上执行识别，不包含前置延迟
+    // 指定cache时，同一帧上参数相同的识别直接复用缓存的结果
+    RecognitionResult recognize(const Frame& frame, const CancellationToken& token = CancellationToken::none(),
+                                RecognitionCache* cache = nullptr) const;
+
+    // 在指定上下文中执行动作，不包含后置延迟，由调用者负责等待
+    bool performAction(const RecognitionResult& result, const ActionContext& context) const;
 
     // 检查条件是否满足
     bool checkCondition(VariableManager& variableManager) const;
 
-    // 处理条件过程
-    void processCondition(VariableManager& variableManager, bool conditionResult);
+    // 处理条件过程，执行变量操作和条件日志，返回此后生效的分支
+    // 没有配置条件处理或对应分支不存在时返回NoBranch
+    BranchIndex processCondition(VariableManager& variableManager, bool conditionResult) const;
 
     // 处理条件日志
     void processConditionLog(VariableManager& variableManager, bool conditionResult) const;
@@ -49,53 +98,120 @@ public:
     // 处理日志
     void processLog(VariableManager& variableManager, bool success) const;
 
-    // 获取动态重写后的节点列表
-    std::vector<std::string> getOverrideNextNodes() const { return m_overrideNextNodes; }
-    std::vector<std::string> getOverrideInterruptNodes() const { return m_overrideInterruptNodes; }
+    // 获取指定分支重写的节点列表
+    std::vector<std::string> getOverrideNextNodes(BranchIndex branch) const { return getBranch(branch) ? getBranch(branch)->overrideNext : std::vector<std::string>{}; }
+    std::vector<std::string> getOverrideInterruptNodes(BranchIndex branch) const { return getBranch(branch) ? getBranch(branch)->overrideInterrupt : std::vector<std::string>{}; }
 
     // 获取变量定义
     const std::vector<std::string>& getVariableDefinitions() const { return m_variableDefinitions; }
 
     // Getters
     const std::string& getName() const { return m_name; }
-    const std::vector<std::string>& getNextNodes() const {
-        // 如果有动态重写的next节点，则返回重写后的节点
-        return m_overrideNextNodes.empty() ? m_nextNodes : m_overrideNextNodes;
+    NodeId getId() const { return m_id; }
+    const std::shared_ptr<const Recognition>& getRecognition() const { return m_recognition; }
+    const std::vector<std::string>& getNextNodes(BranchIndex branch = NoBranch) const {
+        // 如果分支重写了next节点，则返回重写后的节点
+        const ConditionBranch* active = getBranch(branch);
+        return (active && !active->overrideNext.empty()) ? active->overrideNext : m_nextNodes;
     }
-    const std::vector<std::string>& getInterruptNodes() const {
-        // 如果有动态重写的interrupt节点，则返回重写后的节点
-        return m_overrideInterruptNodes.empty() ? m_interruptNodes : m_overrideInterruptNodes;
+    const std::vector<std::string>& getInterruptNodes(BranchIndex branch = NoBranch) const {
+        // 如果分支重写了interrupt节点，则返回重写后的节点
+        const ConditionBranch* active = getBranch(branch);
+        return (active && !active->overrideInterrupt.empty()) ? active->overrideInterrupt : m_interruptNodes;
     }
     const std::vector<std::string>& getOnErrorNodes() const { return m_onErrorNodes; }
+
+    // 获取解析后的节点ID列表，与上面的节点名列表一一对应
+    const std::vector<NodeId>& getNextNodeIds(BranchIndex branch = NoBranch) const {
+        const ConditionBranch* active = getBranch(branch);
+        return (active && !active->overrideNextIds.empty()) ? active->overrideNextIds : m_nextNodeIds;
+    }
+    const std::vector<NodeId>& getInterruptNodeIds(BranchIndex branch = NoBranch) const {
+        const ConditionBranch* active = getBranch(branch);
+        return (active && !active->overrideInterruptIds.empty()) ? active->overrideInterruptIds : m_interruptNodeIds;
+    }
+    const std::vector<NodeId>& getOnErrorNodeIds() const { return m_onErrorNodeIds; }
+
+    // 获取分叉出的子流程的起始节点
+    const std::vector<std::string>& getForkNodes() const { return m_forkNodes; }
+    const std::vector<NodeId>& getForkNodeIds() const { return m_forkNodeIds; }
+    JoinMode getJoinMode() const { return m_joinMode; }
+
     bool isEnabled() const { return m_enabled; }
     uint32_t getTimeout() const { return m_timeout; }
     uint32_t getPreDelay() const { return m_preDelay; }
+    bool isStablePreDelay() const { return m_stablePreDelay; }
+    const StableWait& getStableWait() const { return m_stableWait; }
     uint32_t getPostDelay() const { return m_postDelay; }
+    bool isAutoPostDelay() const { return m_autoPostDelay; }
+    const AutoPostDelay& getAutoPostDelay() const { return m_autoPostDelayConfig; }
     bool isFocused() const { return m_focus; }
+    bool isParallel() const { return m_parallel; }
+    bool isSpeculative() const { return m_speculative; }
+    uint32_t getSettleTime() const { return m_settleTime; }
+    bool isAdaptiveOrder() const { return m_adaptiveOrder; }
+    uint32_t getMinInterval() const { return m_minInterval; }
 
 private:
+    // condition_process的单个分支，加载时解析完毕，执行时只需切换当前分支
+    struct ConditionBranch {
+        std::vector<std::string> overrideNext;          // 重写的next节点列表
+        std::vector<std::string> overrideInterrupt;     // 重写的interrupt节点列表
+        std::vector<NodeId> overrideNextIds;            // 重写的next节点ID列表
+        std::vector<NodeId> overrideInterruptIds;       // 重写的interrupt节点ID列表
+        std::string varOperation;                       // 变量操作
+        std::string conditionLog;                       // 条件日志
+        bool present = false;                           // 配置中是否存在该分支
+    };
+
+    // 获取指定下标的分支，分支不存在时返回nullptr
+    const ConditionBranch* getBranch(BranchIndex branch) const {
+        return (branch == 0 || branch == 1) && m_conditionBranches[branch].present ? &m_conditionBranches[branch] : nullptr;
+    }
+
+    // 解析分支配置
+    bool parseConditionBranch(const nlohmann::json& branchObj, ConditionBranch& branch,
+                              const std::unordered_map<std::string, NodeId>& nodeIds) const;
+
+    // 将节点名列表解析为节点ID列表
+    bool resolveNodeIds(const std::vector<std::string>& names, std::vector<NodeId>& ids,
+                        const std::unordered_map<std::string, NodeId>& nodeIds) const;
+
     std::string m_name;
-    std::unique_ptr<Recognition> m_recognition;
+    NodeId m_id = InvalidNodeId;
+    std::shared_ptr<const Recognition> m_recognition;   // 识别对象，可能与其他节点共享
     std::unique_ptr<Action> m_action;
     std::vector<std::string> m_nextNodes;                // 原始的next节点列表
     std::vector<std::string> m_interruptNodes;          // 原始的interrupt节点列表
     std::vector<std::string> m_onErrorNodes;            // 错误处理节点列表
+    std::vector<NodeId> m_nextNodeIds;                  // 原始的next节点ID列表
+    std::vector<NodeId> m_interruptNodeIds;             // 原始的interrupt节点ID列表
+    std::vector<NodeId> m_onErrorNodeIds;               // 错误处理节点ID列表
+    std::vector<std::string> m_forkNodes;               // 分叉出的子流程的起始节点列表
+    std::vector<NodeId> m_forkNodeIds;                  // 分叉出的子流程的起始节点ID列表
+    JoinMode m_joinMode = JoinMode::All;                // 子流程的汇合方式
     std::vector<std::string> m_variableDefinitions;     // 变量定义列表
     std::string m_condition;                            // 条件表达式
     std::unordered_map<std::string, std::string> m_logs; // 日志配置
 
     // condition_process相关成员
-    nlohmann::json m_conditionProcess;                  // 条件处理配置
-    std::vector<std::string> m_overrideNextNodes;       // 动态重写的next节点列表
-    std::vector<std::string> m_overrideInterruptNodes;   // 动态重写的interrupt节点列表
-    std::unordered_map<std::string, std::string> m_conditionLogs; // 条件日志配置
-    std::unordered_map<std::string, std::string> m_varOperations; // 变量操作配置
+    bool m_hasConditionProcess = false;                 // 是否配置了条件处理
+    ConditionBranch m_conditionBranches[2];             // 条件处理分支，下标0为false分支，1为true分支
     bool m_enabled = true;
     bool m_inverse = false;
     uint32_t m_timeout = 20000; // 默认20秒
-    uint32_t m_preDelay = 200;  // 默认200毫秒
-    uint32_t m_postDelay = 200; // 默认200毫秒
+    uint32_t m_preDelay = 200;  // 默认200毫秒，画面稳定检测时为等待上限
+    bool m_stablePreDelay = false; // 前置延迟是否为画面稳定检测
+    StableWait m_stableWait;    // 画面稳定检测参数
+    uint32_t m_postDelay = 200; // 默认200毫秒，自动后置延迟时为还没有测量结果或无法测量时的延迟
+    bool m_autoPostDelay = false; // 后置延迟是否按测量的动作延迟自动调整
+    AutoPostDelay m_autoPostDelayConfig; // 自动后置延迟参数
     bool m_focus = false;
+    bool m_parallel = false;   // 是否并行评估后继候选节点
+    bool m_speculative = false; // 是否在后置延迟期间提前评估后继候选节点
+    uint32_t m_settleTime = 50; // 推测模式下动作后画面稳定所需的时间，默认50毫秒
+    bool m_adaptiveOrder = false; // 是否按命中率和识别耗时调整候选节点的评估顺序
+    uint32_t m_minInterval = 0; // 作为候选节点时两次识别的最小间隔，间隔内复用上次的结果，0表示每轮都识别
 };
 
 } // namespace Pipeline
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include "Pipeline/CancellationToken.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace Pipeline {
+
+// 前向声明
+class Runtime;
+class WorkerPool;
+
+// 并行匹配，在线程池中同时评估一组按优先级排列的候选项，选出命中的优先级最高的一项
+// 某一项命中后取消优先级更低的项：尚未开始的直接跳过，正在进行的通过各自的取消令牌尽快结束
+// 所有任务结束后恢复co_await的协程，不阻塞运行时的工作线程；没有运行时时在当前线程上阻塞等待
+// 同一个对象在多轮评估之间复用，稳定运行后不再分配内存
+class PIPELINE_API ParallelMatch {
+public:
+    // 评估第index项，命中时返回true；token被取消时应尽快返回，被取消的项的结果不采用
+    using Evaluator = std::function<bool(size_t index, const CancellationToken& token)>;
+
+    ParallelMatch();
+
+    // 等待本轮尚未结束的任务
+    ~ParallelMatch();
+
+    // 不可复制
+    ParallelMatch(const ParallelMatch&) = delete;
+    ParallelMatch& operator=(const ParallelMatch&) = delete;
+
+    // 在线程池中开始一轮评估，上一轮必须已经等待结束
+    // parent被取消时取消所有项；runtime为空时等待在当前线程上阻塞
+    void start(WorkerPool& workerPool, Runtime* runtime, CancellationToken& parent, size_t count, Evaluator evaluator);
+
+    // 等待器，本轮所有任务结束后恢复协程，返回命中的优先级最高的下标，没有命中时返回候选项数量
+    struct Awaiter {
+        ParallelMatch* match;
+
+        bool await_ready() const;
+        bool await_suspend(std::coroutine_handle<> handle) const;
+        size_t await_resume() const;
+    };
+
+    // co_await wait() 等待本轮评估结束
+    Awaiter wait() { return Awaiter{this}; }
+
+    // 本轮开始之前就被取消而跳过的项数
+    size_t getSkippedCount() const { return m_skipped.load(std::memory_order_acquire); }
+
+private:
+    // 在线程池中执行第index项
+    void run(size_t index);
+
+    // 一个任务结束，最后一个结束的任务唤醒等待的协程
+    void finishOne();
+
+    // 取消下标在[first, m_count)内的项
+    void cancelFrom(size_t first);
+
+    Runtime* m_runtime = nullptr;
+    CancellationToken* m_parent = nullptr;
+    CancellationToken::CallbackId m_parentCallback = 0;    // 注册在上级令牌上的回调
+    Evaluator m_evaluator;
+    size_t m_count = 0;
+    std::deque<CancellationToken> m_tokens;                 // 每项的取消令牌，只在候选项变多时增加
+    std::atomic<size_t> m_best{0};                          // 命中的优先级最高的下标
+    std::atomic<size_t> m_remaining{0};                     // 尚未结束的任务数量
+    std::atomic<size_t> m_skipped{0};                       // 跳过的项数
+    std::atomic<void*> m_waiter;                            // 等待的协程句柄，本轮结束后为完成标记
+    std::mutex m_mutex;                                     // 没有运行时时等待结束，以及析构时等待任务
+    std::condition_variable m_condition;
+};
+
+} // namespace Pipeline
@@ -1,9 +1,22 @@
 #pragma once
 
 #include "Pipeline/Common.h"
+#include "Pipeline/CancellationToken.h"
+#include "Pipeline/CandidateScheduler.h"
+#include "Pipeline/Checkpoint.h"
+#include "Pipeline/Frame.h"
 #include "Pipeline/Node.h"
+#include "Pipeline/PipelineDefinition.h"
+#include "Pipeline/RecognitionCache.h"
+#include "Pipeline/Runtime.h"
 #include "Pipeline/Task.h"
+#include "Pipeline/TransitionModel.h"
+#include "Pipeline/LatencyModel.h"
 #include "Pipeline/VariableManager.h"
+#include "Pipeline/WorkerPool.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 namespace Pipeline {
 
@@ -23,40 +36,81 @@ enum class PipelineState {
 };
 
 // Pipeline类，管理节点的执行
+// 节点表保存在共享的只读PipelineDefinition中，Pipeline只持有一次执行的运行状态
 class PIPELINE_API Pipeline {
 public:
     Pipeline();
+    explicit Pipeline(std::shared_ptr<const PipelineDefinition> definition);
     ~Pipeline();
 
-    // 获取当前流水线实例
-    static Pipeline* getInstance() { return s_instance; }
-
     // 从JSON文件加载流水线
     bool loadFromFile(const std::string& filePath);
 
     // 从JSON字符串加载流水线
     bool loadFromString(const std::string& jsonString);
 
+    // 使用已加载的流水线定义，多个实例可以共享同一个定义
+    // 全局变量和节点变量按定义初始化，只能在流水线停止时调用
+    bool setDefinition(std::shared_ptr<const PipelineDefinition> definition);
+
+    // 获取当前的流水线定义
+    std::shared_ptr<const PipelineDefinition> getDefinition() const;
+
+    // 热重载流水线，在调用者线程上解析新的定义并与当前节点逐个比较
+    // 配置没有变化的节点和参数相同的识别对象被保留，已有节点的节点ID保持不变
+    // 流水线运行时，新的节点表在两个节点之间的安全点整体替换，当前节点和变量的值保持不变
+    // 流水线停止时立即替换；新的定义无法解析或引用了不存在的节点时返回false，当前定义不受影响
+    bool reloadFromFile(const std::string& filePath);
+    bool reloadFromString(const std::string& jsonString);
+
+    // 是否有尚未应用的热重载
+    bool hasPendingReload() const;
+
     // 通过名称获取节点
-    std::shared_ptr<Node> getNode(const std::string& name) const;
+    std::shared_ptr<const Node> getNode(const std::string& name) const;
+
+    // 通过名称获取节点ID，节点不存在时返回InvalidNodeId
+    NodeId getNodeId(const std::string& name) const;
+
+    // 通过节点ID获取节点名，节点不存在时返回空字符串
+    std::string getNodeName(NodeId id) const;
+
+    // 获取节点数量
+    size_t getNodeCount() const;
+
+    // 获取合并后不同识别对象的数量
+    size_t getRecognitionCount() const;
 
     // 从特定节点开始执行流水线
+    // 返回的任务处于挂起状态，需要通过Task::start交给运行时执行
     Task execute(const std::string& startNodeName);
 
+    // 生成主流程当前执行位置的检查点，包含等待中的后置延迟或超时、条件处理分支和所有变量
+    // 流水线停止时返回空值；分叉出的子流程不保存，从分叉节点恢复时重新启动子流程
+    std::optional<Checkpoint> checkpoint() const;
+
+    // 从检查点恢复执行，变量和条件处理分支被替换为检查点中的值
+    // 检查点中的节点在当前定义中不存在时，返回的任务立即结束
+    // 返回的任务处于挂起状态，需要通过Task::start交给运行时执行
+    Task restore(const Checkpoint& checkpoint);
+
+    // 控制接口可以在任意线程上调用，只原子地切换状态并向命令队列发送命令，不会阻塞，也不会执行流水线代码
+    // 处于暂停状态的协程交给运行时在工作线程上恢复
+
     // 停止当前执行
     void stop();
 
-    // 暂停当前执行
+    // 暂停当前执行，协程在下一个暂停点挂起
     void suspend();
 
     // 继续执行
     void resume();
 
     // 获取当前状态
-    PipelineState getState() const { return m_state; }
+    PipelineState getState() const { return m_state.load(std::memory_order_acquire); }
 
     // 获取当前节点名称
-    std::string getCurrentNodeName() const { return m_currentNodeName; }
+    std::string getCurrentNodeName() const;
 
     // 获取变量管理器
     VariableManager& getVariableManager() { return m_variableManager; }
@@ -71,27 +125,339 @@ public:
     // 初始化全局变量
     bool initializeGlobalVariables(const nlohmann::json& json);
 
-private:
-    static Pipeline* s_instance;                    // 当前实例
+    // 设置帧源，未设置时由VisionEngine在每次识别时自行截图
+    void setFrameSource(std::shared_ptr<FrameSource> frameSource) { m_frameSource = std::move(frameSource); }
+
+    // 设置等待新帧的最长时间，超时后即使画面没有变化也会重新评估候选节点
+    void setMaxFrameWait(std::chrono::milliseconds maxWait) { m_maxFrameWait = maxWait; }
+
+    // 设置调度协程的运行时，节点之间、暂停和恢复时通过运行时让出执行权
+    // 未设置时协程在调用者线程上连续执行
+    void setRuntime(Runtime* runtime) { m_runtime = runtime; }
+
+    // 设置并行识别使用的线程池，未设置时使用运行时的共享线程池，或在首次需要时创建
+    void setWorkerPool(std::shared_ptr<WorkerPool> workerPool) { m_workerPool = std::move(workerPool); }
+
+    // 获取识别结果缓存的命中统计
+    RecognitionCacheStats getRecognitionCacheStats() const { return m_recognitionCache->getStats(); }
+
+    // 获取节点到各候选节点的统计信息，按下一轮的评估顺序排列（先next后interrupt）
+    // 只有"order": "adaptive"的节点会记录统计信息
+    std::vector<EdgeStats> getEdgeStats(const std::string& nodeName) const;
+
+    // 获取节点在本实例中生效的条件处理分支
+    BranchIndex getActiveBranch(NodeId id) const;
+
+    // 获取节点转移模型，记录本实例在节点之间的每次转移
+    const TransitionModel& getTransitionModel() const { return m_transitionModel; }
+
+    // 设置动作执行期间预热的最可能后继节点的数量，0表示不预热，默认2
+    void setPrefetchCount(size_t count) { m_prefetchCount = count; }
+
+    // 将转移模型按节点名保存为JSON文件
+    bool saveTransitionModel(const std::string& filePath) const;
 
-    std::map<std::string, std::shared_ptr<Node>> m_nodes;
+    // 从JSON文件加载转移模型，记录累加到当前模型中，当前定义中不存在的节点被忽略
+    bool loadTransitionModel(const std::string& filePath);
+
+    // 获取动作延迟模型，记录"post_delay": "auto"的节点测量到的动作延迟
+    const LatencyModel& getLatencyModel() const { return m_latencyModel; }
+
+    // 获取节点学习到的后置延迟，节点不是自动后置延迟或还没有测量结果时返回空值
+    std::optional<uint32_t> getLearnedPostDelay(const std::string& nodeName) const;
+
+    // 将动作延迟模型按节点名保存为JSON文件
+    bool saveLatencyModel(const std::string& filePath) const;
+
+    // 从JSON文件加载动作延迟模型，样本追加到当前模型中，当前定义中不存在的节点被忽略
+    bool loadLatencyModel(const std::string& filePath);
+
+private:
+    std::shared_ptr<const PipelineDefinition> m_definition; // 共享的流水线定义
+    mutable std::mutex m_graphMutex;                // 保护按名称查找节点与热重载替换流水线定义之间的并发
+    std::unordered_map<NodeId, BranchIndex> m_activeBranches; // 生效的条件处理分支，只记录存在分支的节点
     VariableManager m_variableManager; // 变量管理器
-    PipelineState m_state = PipelineState::Stopped; // 当前状态
-    std::string m_currentNodeName;                  // 当前节点名称
-    std::shared_ptr<Node> m_currentNode;            // 当前节点
-    TaskAwaiter m_awaiter;                          // 协程等待器
-    std::vector<std::string> m_globalVariables;     // 全局变量定义
+    std::atomic<PipelineState> m_state{PipelineState::Stopped}; // 当前状态，控制接口通过CAS切换
+    std::atomic<NodeId> m_currentNodeId{InvalidNodeId}; // 主流程的当前节点ID
+    std::atomic<bool> m_resumePending{false};       // resume()之后令牌尚未在协程中重置，由第一个取到的流程处理
+    Runtime* m_runtime = nullptr;                   // 协程运行时
+    std::shared_ptr<CancellationToken> m_cancellationToken; // 取消令牌，停止和暂停时取消，并行识别任务共享持有
+    std::shared_ptr<CancellationToken> m_mainToken; // 主流程的取消令牌，随m_cancellationToken取消，看门狗抢占时单独取消
+    std::mutex m_linkMutex;                         // 保护子令牌的重置和挂到上级令牌上的取消回调
+    CancellationToken::CallbackId m_mainCallbackId = 0; // 主流程令牌注册在m_cancellationToken上的回调
     TaskStopCallback m_taskStopCallback;            // 任务停止回调
+    std::shared_ptr<FrameSource> m_frameSource;     // 帧源
+    std::atomic<uint64_t> m_frameCounter{0};        // 分配帧序号的计数器
+    std::mutex m_frameMutex;                        // 保护最近一次采集到的纪元和为它分配的帧序号
+    uint64_t m_lastEpoch = 0;                       // 最近一次采集到的帧源纪元
+    uint64_t m_lastEpochFrameId = 0;                // 为m_lastEpoch分配的帧序号
+    std::shared_ptr<WorkerPool> m_workerPool;       // 并行识别线程池
+    std::shared_ptr<RecognitionCache> m_recognitionCache; // 按帧缓存识别结果，并行识别任务共享持有
+    std::shared_ptr<CandidateScheduler> m_candidateScheduler; // 候选边的命中统计，并行识别任务共享持有
+    std::chrono::milliseconds m_maxFrameWait{100};  // 等待新帧的最长时间
+    TransitionModel m_transitionModel;              // 节点转移模型
+    LatencyModel m_latencyModel;                    // 动作延迟模型
+    size_t m_prefetchCount = 2;                     // 动作执行期间预热的后继节点数量
+
+    // 主流程的执行位置，用于生成检查点
+    struct Progress {
+        NodeId nodeId = InvalidNodeId;
+        CheckpointPhase phase = CheckpointPhase::Enter;
+        std::chrono::steady_clock::time_point deadline; // 后置延迟或超时的结束时间
+        bool actionSuccess = true;
+    };
+    mutable std::mutex m_progressMutex;             // 保护m_progress
+    Progress m_progress;                            // 主流程的执行位置
+
+    // 从检查点恢复时主流程在第一个节点上跳过的部分
+    struct ResumePoint {
+        CheckpointPhase phase = CheckpointPhase::Enter;
+        std::chrono::milliseconds remaining{0};     // 剩余的后置延迟或超时
+        bool actionSuccess = true;
+    };
+
+    mutable std::mutex m_reloadMutex;               // 保护热重载的构建和应用
+    std::shared_ptr<const PipelineDefinition> m_pendingDefinition; // 等待在安全点应用的流水线定义
+
+    // 分叉节点启动的一组子流程，定义在Pipeline.cpp中
+    struct ForkGroup;
+
+    // 一个流程的并行评估状态，在多轮评估之间复用，定义在Pipeline.cpp中
+    struct ParallelEvaluation;
+
+    // 一条执行流程的运行状态，主流程和分叉出的每个子流程各有一份，保存在各自的协程帧中
+    struct Flow {
+        const Node* currentNode = nullptr;                  // 当前节点
+        std::optional<RecognitionResult> pendingResult;     // 切换节点时已命中的识别结果，避免重复识别
+        std::shared_ptr<CancellationToken> token;           // 取消令牌，主流程使用m_mainToken，子流程使用所属分叉组的令牌
+        std::shared_ptr<ForkGroup> group;                   // 所属的分叉组，主流程为空
+        ActionContext actionContext;                        // 动作执行上下文
+        std::chrono::steady_clock::time_point actionEndTime; // 最近一次动作结束的时间，之后的识别只接受此后采集的帧
+        std::optional<ResumePoint> resume;                  // 从检查点恢复时的执行位置，只作用于第一个节点
+        bool succeeded = false;                             // 流程是否正常结束
+
+        // 每个节点复用的缓冲区，稳定运行后不再分配内存
+        std::vector<NodeId> predicted;                      // 预热时预测的后继节点
+        std::vector<NodeId> orderedNext;                    // 按自适应顺序排列的next候选节点
+        std::vector<NodeId> orderedInterrupt;               // 按自适应顺序排列的interrupt候选节点
+        std::unique_ptr<ParallelEvaluation> parallelEvaluation; // 并行评估的状态，第一次并行评估时创建
+    };
+
+    // 看门狗命中后等待主流程应用的抢占
+    struct Preemption {
+        NodeId nodeId = InvalidNodeId;
+        int priority = 0;
+        RecognitionResult result;
+    };
+    std::mutex m_preemptionMutex;                   // 保护m_preemption
+    std::optional<Preemption> m_preemption;         // 等待应用的抢占
+    std::atomic<bool> m_preempted{false};           // 是否有等待应用的抢占
+    std::shared_ptr<ForkGroup> m_watchdogGroup;     // 看门狗协程所在的分组，由主流程启动
+
+    // 在暂停点挂起的协程，以链表形式保存在m_parkedHandles中，节点位于暂停点所在的协程帧
+    struct ParkedHandle {
+        std::coroutine_handle<> handle;
+        ParkedHandle* next = nullptr;
+    };
+    std::atomic<ParkedHandle*> m_parkedHandles{nullptr}; // 挂起的协程，由控制接口整体取出后交给运行时
+
+    // 流水线执行协程，group为空时执行主流程，否则执行分叉组中的一个子流程
+    // 指定resume时从检查点保存的执行位置继续执行第一个节点
+    Task run(NodeId startNodeId, std::shared_ptr<ForkGroup> group = nullptr,
+             std::optional<ResumePoint> resume = std::nullopt);
+
+    // 开始新的执行前重置令牌、抢占和缓存，记录起始的执行位置，并将状态切换为运行中
+    void prepareRun(const Progress& progress);
+
+    // 看门狗协程，按各自的间隔在共享的帧上评估看门狗节点，命中时抢占主流程
+    Task watch(std::shared_ptr<ForkGroup> group);
+
+    // 启动看门狗协程，没有看门狗节点或没有运行时时不启动
+    void startWatchdog();
+
+    // 等待上次执行的看门狗协程结束并释放，不能在协程中调用
+    void joinWatchdog();
+
+    // 请求主流程转到命中的看门狗节点，尚未应用的抢占只会被优先级更高的看门狗替换
+    void preempt(const Watchdog& watchdog, RecognitionResult result);
+
+    // 在主流程中应用等待中的抢占，切换当前节点并使用命中时的识别结果
+    void applyPreemption(Flow& flow);
+
+    // 流程结束时调用，主流程结束即流水线停止，子流程结束时通知所属的分叉组
+    void finishFlow(Flow& flow);
+
+    // 启动当前节点的子流程，没有运行时时返回nullptr
+    std::shared_ptr<ForkGroup> startFork(Flow& flow);
+
+    // 等待子流程的协程全部结束并释放，返回分叉的结果
+    bool finishFork(ForkGroup& group);
+
+    // 流程是否应当继续执行，流水线停止、所属的分叉组已经有了结果或主流程即将被抢占时返回false
+    bool isFlowActive(const Flow& flow) const;
+
+    // 将流程的取消令牌与上级流程同步，上级恢复运行且没有等待中的抢占时重置取消的令牌
+    void syncFlowToken(const Flow& flow);
+
+    // 从最外层开始同步分叉组及其上级分叉组的取消令牌
+    void syncGroupToken(ForkGroup* group);
+
+    // 上级令牌被取消时同时取消子令牌，替换callbackId原先注册的回调，调用时持有m_linkMutex
+    // 取消回调只调用一次，子令牌每次被上级取消并重置后都要重新注册
+    void linkToken(CancellationToken& parent, const std::shared_ptr<CancellationToken>& child,
+                   CancellationToken::CallbackId& callbackId);
+
+    // 汇合等待器，分叉组中的子流程全部结束后恢复协程
+    struct JoinAwaiter {
+        ForkGroup* group;
+
+        bool await_ready() const;
+        bool await_suspend(std::coroutine_handle<> handle) const;
+        void await_resume() const {}
+    };
 
     // 解析JSON的辅助方法
     bool parseJson(const nlohmann::json& json);
 
+    // 替换当前的流水线定义
+    void swapDefinition(std::shared_ptr<const PipelineDefinition> definition);
+
+    // 热重载的辅助方法
+    bool reload(const nlohmann::json& json);
+
+    // 应用等待中的流水线定义，只定义新增的变量并重新定位主流程的当前节点，调用时需持有m_reloadMutex
+    // 流水线停止时flow为空
+    void applyPendingDefinition(Flow* flow);
+
+    // 只定义尚不存在的变量，已有变量保持当前值
+    void defineMissingVariables(const std::vector<std::string>& definitions);
+
     // 初始化节点变量
-    void initializeNodeVariables(const std::shared_ptr<Node>& node);
+    void initializeNodeVariables(const Node& node);
+
+    // 将转移模型转换为以节点名为键的JSON对象
+    nlohmann::json transitionsToJson() const;
+
+    // 将以节点名为键的转移记录累加到转移模型中
+    void addTransitions(const nlohmann::json& json);
+
+    // 动作延迟模型转换为以节点名为键的JSON
+    nlohmann::json latenciesToJson() const;
+
+    // 将以节点名为键的动作延迟样本追加到动作延迟模型中
+    void addLatencies(const nlohmann::json& json);
+
+    // 获取节点生效的后置延迟，自动后置延迟取测量结果的百分位数，没有测量结果时使用post_delay
+    uint32_t getEffectivePostDelay(const Node& node) const;
+
+    // 在线程池中预热转移模型预测的最可能后继节点的识别，没有可用的线程池时跳过
+    // 预测结果写入predicted，复用它的内存
+    void prefetchSuccessors(NodeId from, std::vector<NodeId>& predicted);
+
+    // 获取并行识别和预热使用的线程池，未设置时使用运行时的共享线程池，或在首次需要时创建
+    std::shared_ptr<WorkerPool> acquireWorkerPool();
+
+    // 获取运行时的时钟，没有运行时时使用steady_clock
+    std::shared_ptr<Clock> getClock() const { return m_runtime ? m_runtime->getClock() : Clock::steady(); }
+
+    // 按运行时的时钟获取当前时间，节点的超时、前置和后置延迟都以它为准
+    Clock::time_point currentTime() const { return m_runtime ? m_runtime->now() : std::chrono::steady_clock::now(); }
+
+    // 通过节点ID获取节点，只能在协程中或持有m_graphMutex时调用
+    const Node* getNodeById(NodeId id) const { return m_definition ? m_definition->getNodeById(id) : nullptr; }
+
+    // 获取节点生效的条件处理分支，只能在持有m_graphMutex时调用
+    BranchIndex getBranchLocked(NodeId id) const;
+
+    // 新帧等待器，帧源产生新帧、等待超过m_maxFrameWait或取消令牌被取消时恢复协程
+    struct FrameWaitAwaiter {
+        Pipeline* pipeline;
+        uint64_t lastEpoch;
+        DelayAwaiter delay;
+        FrameSource* notifiedSource = nullptr;              // 注册了新帧回调的帧源
+        const void* notificationKey = nullptr;              // 新帧回调的注册键
+
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume();
+    };
+
+    // 暂停点，流水线处于暂停状态时挂起协程，恢复后返回流水线是否仍在运行
+    // 有运行时时协程句柄交给控制接口唤醒，没有运行时时在当前线程上等待状态变化
+    struct SuspendPoint {
+        Pipeline* pipeline;
+        Flow* flow;
+        ParkedHandle parked;
+
+        bool await_ready() const;
+        bool await_suspend(std::coroutine_handle<> handle);
+        bool await_resume() const;
+    };
+
+    // co_await suspendPoint(flow) 返回false时协程应当退出
+    SuspendPoint suspendPoint(Flow& flow) { return SuspendPoint{this, &flow, {}}; }
+
+    // 一轮评估的前置延迟
+    struct TickPreDelay {
+        uint32_t fixed = 0;                 // 固定延迟（毫秒），包含画面稳定检测的最少等待时间
+        std::optional<StableWait> stable;   // 合并后的画面稳定检测参数，没有候选节点使用时为空
+        std::optional<Rect> roi;            // 需要检测的区域，为空时检测整帧
+    };
+
+    // 计算一轮评估的前置延迟，固定延迟取所有候选节点中的最大值，画面稳定检测的参数取最严格的组合
+    TickPreDelay getTickPreDelay(const std::vector<NodeId>& nextNodes, const std::vector<NodeId>& interruptNodes) const;
+
+    // 两帧在roi内是否没有变化，帧源不支持比较时只有帧序号相同才视为没有变化
+    bool isFrameStable(const Frame& previous, const Frame& current, const std::optional<Rect>& roi, double tolerance) const;
+
+    // 从帧源采集一帧，每轮评估只采集一次
+    Frame captureFrame();
+
+    // 等待帧源产生新帧，没有帧源时等待m_maxFrameWait，最晚在deadline恢复
+    FrameWaitAwaiter waitForNextFrame(const Frame& lastFrame, CancellationToken* token,
+                                      std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    // 候选节点评估等待器，顺序评估时已经得到结果，不挂起；并行评估时所有识别任务结束后恢复协程
+    // 恢复后返回命中的节点ID，命中时识别结果写入result
+    struct CandidateMatchAwaiter {
+        ParallelEvaluation* evaluation;     // 并行评估的状态，顺序评估时为空
+        NodeId candidate;                   // 顺序评估的结果
+        RecognitionResult* result;
+
+        bool await_ready() const;
+        bool await_suspend(std::coroutine_handle<> handle) const;
+        NodeId await_resume() const;
+    };
+
+    // 在同一帧上按优先级（先next后interrupt，各自按列表顺序）评估候选节点，co_await返回第一个命中的节点ID
+    // source为当前节点ID时按自适应顺序评估并记录统计信息，为InvalidNodeId时按列表顺序评估
+    // 使用流程的取消令牌，自适应顺序排列在流程的缓冲区中；frame和result在co_await结束之前必须有效
+    CandidateMatchAwaiter matchCandidates(Flow& flow, const std::vector<NodeId>& nextNodes,
+                                          const std::vector<NodeId>& interruptNodes, const Frame& frame,
+                                          RecognitionResult& result, bool parallel, NodeId source);
+
+    // 按给定顺序逐个评估候选节点，命中第一个即返回
+    NodeId evaluateCandidates(const std::vector<NodeId>& nextNodes, const std::vector<NodeId>& interruptNodes,
+                              const Frame& frame, RecognitionResult& result, NodeId source,
+                              const CancellationToken& token);
+
+    // 在线程池中并行评估候选节点，仍按给定顺序选出命中的节点，使用流程中复用的并行评估状态
+    CandidateMatchAwaiter matchCandidatesParallel(Flow& flow, const std::vector<NodeId>& nextNodes,
+                                                  const std::vector<NodeId>& interruptNodes, const Frame& frame,
+                                                  RecognitionResult& result, NodeId source);
+
+    // 设置流程的当前节点并记录转移，主流程同时更新m_currentNodeId
+    void setCurrentNode(Flow& flow, NodeId nodeId);
+
+    // 更新主流程在当前节点上的执行阶段，子流程不记录
+    void setProgress(const Flow& flow, CheckpointPhase phase,
+                     std::chrono::steady_clock::time_point deadline = {}, bool actionSuccess = true);
+
+    // 在协程中完成resume()，重置暂停时取消的令牌，只能在协程中调用
+    void finishResume();
 
-    // 设置当前节点
-    void setCurrentNode(const std::string& nodeName);
-    void setCurrentNode(const std::shared_ptr<Node>& node);
+    // 取出在暂停点挂起的协程，交给运行时重新调度
+    void wakeParked();
 };
 
 } // namespace Pipeline
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include "Pipeline/Node.h"
+#include "Pipeline/RecognitionPool.h"
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+
+namespace Pipeline {
+
+// 前向声明
+namespace nlohmann {
+    template<typename T>
+    class basic_json;
+
+    using json = basic_json<>;
+}
+
+// 看门狗，在主流程之外按自己的间隔评估的节点，命中时抢占主流程的当前节点
+struct Watchdog {
+    NodeId nodeId = InvalidNodeId;
+    std::chrono::milliseconds interval{1000};   // 评估间隔，默认1秒
+    int priority = 0;                           // 优先级，数值越大越优先
+};
+
+// 流水线定义，加载后只读，可以在多个流水线实例和线程之间共享
+// 包含节点表、节点名映射和合并后的识别对象，运行状态（当前节点、生效的分支、变量等）由各个Pipeline实例持有
+class PIPELINE_API PipelineDefinition {
+public:
+    // 从JSON文件加载流水线定义，失败时返回nullptr
+    static std::shared_ptr<const PipelineDefinition> loadFromFile(const std::string& filePath);
+
+    // 从JSON字符串加载流水线定义，失败时返回nullptr
+    static std::shared_ptr<const PipelineDefinition> loadFromString(const std::string& jsonString);
+
+    // 从JSON对象构建流水线定义，无法解析或引用了不存在的节点时返回nullptr
+    // 指定previous时保留其中节点的节点ID，并复用配置没有变化的节点和参数相同的识别对象
+    static std::shared_ptr<const PipelineDefinition> build(const nlohmann::json& json, const PipelineDefinition* previous = nullptr);
+
+    // 解析var_global中的全局变量定义
+    static std::vector<std::string> parseGlobalVariables(const nlohmann::json& json);
+
+    // 不可复制
+    PipelineDefinition(const PipelineDefinition&) = delete;
+    PipelineDefinition& operator=(const PipelineDefinition&) = delete;
+
+    // 通过名称获取节点
+    std::shared_ptr<const Node> getNode(const std::string& name) const;
+
+    // 通过名称获取节点ID，节点不存在时返回InvalidNodeId
+    NodeId getNodeId(const std::string& name) const;
+
+    // 通过节点ID获取节点，节点不存在或已在热重载中删除时返回nullptr
+    const Node* getNodeById(NodeId id) const { return id < m_nodeTable.size() ? m_nodeTable[id].get() : nullptr; }
+
+    // 通过节点ID获取共享的节点
+    std::shared_ptr<const Node> getSharedNode(NodeId id) const { return id < m_nodeTable.size() ? m_nodeTable[id] : nullptr; }
+
+    // 获取节点数量
+    size_t getNodeCount() const { return m_nodeIds.size(); }
+
+    // 获取节点表的大小，包括热重载中删除的节点留下的空位
+    size_t getNodeTableSize() const { return m_nodeTable.size(); }
+
+    // 获取合并后不同识别对象的数量
+    size_t getRecognitionCount() const { return m_recognitionPool.size(); }
+
+    // 获取全局变量定义
+    const std::vector<std::string>& getGlobalVariables() const { return m_globalVariables; }
+
+    // 获取看门狗列表，按优先级从高到低排列，优先级相同时按节点名排列
+    const std::vector<Watchdog>& getWatchdogs() const { return m_watchdogs; }
+
+private:
+    PipelineDefinition() = default;
+
+    // 解析watchdog中的看门狗，引用了不存在的节点时返回false
+    bool parseWatchdogs(const nlohmann::json& json);
+
+    std::vector<std::shared_ptr<const Node>> m_nodeTable; // 按节点ID排列的节点表，删除的节点对应空指针
+    std::unordered_map<std::string, NodeId> m_nodeIds;  // 节点名到节点ID的映射
+    std::vector<std::string> m_nodeConfigs;             // 按节点ID排列的规范化节点配置，热重载时据此判断节点是否变化
+    RecognitionPool m_recognitionPool;                  // 合并参数相同的识别对象
+    std::vector<std::string> m_globalVariables;         // 全局变量定义
+    std::vector<Watchdog> m_watchdogs;                  // 看门狗列表
+};
+
+} // namespace Pipeline
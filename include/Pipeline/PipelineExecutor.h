@@ -2,6 +2,7 @@
 
 #include "Pipeline/Common.h"
 #include "Pipeline/Pipeline.h"
+#include "Pipeline/Runtime.h"
 #include "Pipeline/Task.h"
 
 namespace Pipeline {
@@ -9,7 +10,9 @@ namespace Pipeline {
 // PipelineExecutor类，管理流水线的执行
 class PIPELINE_API PipelineExecutor {
 public:
-    PipelineExecutor();
+    // 多个执行器可以共享同一个运行时，由运行时的工作线程调度全部流水线
+    // runtime为空时创建一个只有单个工作线程的私有运行时
+    explicit PipelineExecutor(std::shared_ptr<Runtime> runtime = nullptr);
     ~PipelineExecutor();
 
     // 从文件加载并执行流水线
@@ -18,7 +21,25 @@ public:
     // 从字符串加载并执行流水线
     bool executeFromString(const std::string& jsonString, const std::string& startNodeName);
 
-    // 停止当前执行
+    // 执行已加载的流水线定义，多个执行器可以共享同一个定义，不需要重复解析
+    bool execute(std::shared_ptr<const PipelineDefinition> definition, const std::string& startNodeName);
+
+    // 加载流水线并从序列化的检查点恢复执行
+    // 检查点无法解析或其中的节点在流水线中不存在时返回false
+    bool restoreFromFile(const std::string& filePath, const std::vector<uint8_t>& checkpoint);
+    bool restoreFromString(const std::string& jsonString, const std::vector<uint8_t>& checkpoint);
+    bool restore(std::shared_ptr<const PipelineDefinition> definition, const std::vector<uint8_t>& checkpoint);
+
+    // 生成当前执行位置的检查点并序列化，流水线停止时返回空数组
+    std::vector<uint8_t> checkpoint() const;
+
+    // 热重载流水线定义，不停止当前执行，当前节点和变量保持不变
+    // 新的定义在两个节点之间生效，没有加载过流水线或新的定义无效时返回false
+    bool reloadFromFile(const std::string& filePath);
+    bool reloadFromString(const std::string& jsonString);
+
+    // 停止当前执行，并等待协程退出
+    // 不能在流水线自身的动作或回调中调用
     void stop();
 
     // 暂停当前执行
@@ -41,7 +62,41 @@ public:
     using TaskStopCallback = std::function<void(const std::string& nodeName, const std::string& reason)>;
     void setTaskStopCallback(TaskStopCallback callback);
 
+    // 设置帧源
+    void setFrameSource(std::shared_ptr<FrameSource> frameSource);
+
+    // 设置等待新帧的最长时间
+    void setMaxFrameWait(std::chrono::milliseconds maxWait);
+
+    // 获取识别结果缓存的命中统计
+    RecognitionCacheStats getRecognitionCacheStats() const;
+
+    // 获取节点到各候选节点的统计信息
+    std::vector<EdgeStats> getEdgeStats(const std::string& nodeName) const;
+
+    // 保存和加载节点转移模型
+    bool saveTransitionModel(const std::string& filePath) const;
+    bool loadTransitionModel(const std::string& filePath);
+
+    // 获取节点学习到的后置延迟，保存和加载动作延迟模型
+    std::optional<uint32_t> getLearnedPostDelay(const std::string& nodeName) const;
+    bool saveLatencyModel(const std::string& filePath) const;
+    bool loadLatencyModel(const std::string& filePath);
+
+    // 通过节点ID获取节点名
+    std::string getNodeName(NodeId id) const;
+
+    // 获取运行时
+    std::shared_ptr<Runtime> getRuntime() const { return m_runtime; }
+
 private:
+    // 开始执行流水线
+    bool start(const std::string& startNodeName);
+
+    // 从检查点开始执行流水线
+    bool startFromCheckpoint(const std::vector<uint8_t>& checkpoint);
+
+    std::shared_ptr<Runtime> m_runtime;
     std::unique_ptr<Pipeline> m_pipeline;
     NodeCallback m_nodeCallback;
     TaskStopCallback m_taskStopCallback;
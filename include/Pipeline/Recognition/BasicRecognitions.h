@@ -1,14 +1,34 @@
 #pragma once
 
 #include "Pipeline/Recognition/Recognition.h"
+#include <vector>
 
 namespace Pipeline {
 
 // DirectHit识别类 - 直接命中
+// 可以设置roi，只用于画面稳定检测，等待该区域稳定后命中
 class PIPELINE_API DirectHitRecognition : public Recognition {
 public:
     DirectHitRecognition();
-    virtual RecognitionResult recognize() override;
+    using Recognition::recognize;
+    virtual RecognitionResult recognize(const Frame& frame, const CancellationToken& token) const override;
+    virtual bool parseConfig(const nlohmann::json& config) override;
+    virtual std::optional<Rect> getRoi() const override;
+
+protected:
+    virtual nlohmann::json configToJson() const override;
+
+private:
+    std::vector<int> m_roi = {0, 0, 0, 0};
+    std::vector<int> m_roiOffset = {0, 0, 0, 0};
+};
+
+// Always识别类 - 总是成功
+class PIPELINE_API AlwaysRecognition : public Recognition {
+public:
+    AlwaysRecognition();
+    using Recognition::recognize;
+    virtual RecognitionResult recognize(const Frame& frame, const CancellationToken& token) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
 };
 
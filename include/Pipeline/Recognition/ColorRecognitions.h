@@ -4,67 +4,108 @@
 #include <vector>
 #include <string>
 
+namespace vision {
+    struct FindColorParams;
+    struct FindMultiColorParams;
+}
+
 namespace Pipeline {
 
 // FindColor识别类 - 找色
 class PIPELINE_API FindColorRecognition : public Recognition {
 public:
     FindColorRecognition();
-    virtual RecognitionResult recognize() override;
+    using Recognition::recognize;
+    virtual RecognitionResult recognize(const Frame& frame, const CancellationToken& token) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
+    virtual std::optional<Rect> getRoi() const override;
+
+protected:
+    virtual nlohmann::json configToJson() const override;
 
 private:
+    // 创建找色参数
+    std::shared_ptr<const vision::FindColorParams> createParams() const;
+
     std::vector<int> m_roi = {0, 0, 0, 0};
     std::vector<int> m_roiOffset = {0, 0, 0, 0};
     std::string m_color;
     double m_similarity = 1.0;
     int m_direction = 0;
+    std::shared_ptr<const vision::FindColorParams> m_params; // 解析参数后预先创建的找色参数，识别时直接使用
 };
 
 // FindMultiColor识别类 - 多点找色
 class PIPELINE_API FindMultiColorRecognition : public Recognition {
 public:
     FindMultiColorRecognition();
-    virtual RecognitionResult recognize() override;
+    using Recognition::recognize;
+    virtual RecognitionResult recognize(const Frame& frame, const CancellationToken& token) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
+    virtual std::optional<Rect> getRoi() const override;
+
+protected:
+    virtual nlohmann::json configToJson() const override;
 
 private:
+    // 创建多点找色参数
+    std::shared_ptr<const vision::FindMultiColorParams> createParams() const;
+
     std::vector<int> m_roi = {0, 0, 0, 0};
     std::vector<int> m_roiOffset = {0, 0, 0, 0};
     std::string m_firstColor;
     std::string m_offsetColor;
     double m_similarity = 1.0;
     int m_direction = 0;
+    std::shared_ptr<const vision::FindMultiColorParams> m_params; // 解析参数后预先创建的多点找色参数，识别时直接使用
 };
 
 // FindColorList识别类 - 找色列表
 class PIPELINE_API FindColorListRecognition : public Recognition {
 public:
     FindColorListRecognition();
-    virtual RecognitionResult recognize() override;
+    using Recognition::recognize;
+    virtual RecognitionResult recognize(const Frame& frame, const CancellationToken& token) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
+    virtual std::optional<Rect> getRoi() const override;
+
+protected:
+    virtual nlohmann::json configToJson() const override;
 
 private:
+    // 创建每个颜色的找色参数
+    std::shared_ptr<const std::vector<vision::FindColorParams>> createParams() const;
+
     std::vector<int> m_roi = {0, 0, 0, 0};
     std::vector<int> m_roiOffset = {0, 0, 0, 0};
     std::vector<std::string> m_colorList;
     double m_similarity = 1.0;
     int m_direction = 0;
+    std::shared_ptr<const std::vector<vision::FindColorParams>> m_paramsList; // 解析参数后预先创建的每个颜色的找色参数，识别时直接使用
 };
 
 // FindMultiColorList识别类 - 多点找色列表
 class PIPELINE_API FindMultiColorListRecognition : public Recognition {
 public:
     FindMultiColorListRecognition();
-    virtual RecognitionResult recognize() override;
+    using Recognition::recognize;
+    virtual RecognitionResult recognize(const Frame& frame, const CancellationToken& token) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
+    virtual std::optional<Rect> getRoi() const override;
+
+protected:
+    virtual nlohmann::json configToJson() const override;
 
 private:
+    // 创建每一项的多点找色参数
+    std::shared_ptr<const std::vector<vision::FindMultiColorParams>> createParams() const;
+
     std::vector<int> m_roi = {0, 0, 0, 0};
     std::vector<int> m_roiOffset = {0, 0, 0, 0};
     std::vector<std::pair<std::string, std::string>> m_multiColorList;
     double m_similarity = 1.0;
     int m_direction = 0;
+    std::shared_ptr<const std::vector<vision::FindMultiColorParams>> m_paramsList; // 解析参数后预先创建的每一项的多点找色参数，识别时直接使用
 };
 
 } // namespace Pipeline
@@ -4,21 +4,32 @@
 #include <vector>
 #include <string>
 
+namespace vision {
+    struct OcrParams;
+}
+
 namespace Pipeline {
 
 // OCR识别类 - OCR识别
 class PIPELINE_API OCRRecognition : public Recognition {
 public:
     OCRRecognition();
-    virtual RecognitionResult recognize() override;
+    using Recognition::recognize;
+    virtual RecognitionResult recognize(const Frame& frame, const CancellationToken& token) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
+    virtual std::optional<Rect> getRoi() const override;
     
     // 批量OCR识别，返回所有结果
-    std::vector<RecognitionResult> recognizeBatch();
+    std::vector<RecognitionResult> recognizeBatch(const Frame& frame = Frame{}, const CancellationToken& token = CancellationToken::none()) const;
+
+protected:
+    virtual nlohmann::json configToJson() const override;
 
 private:
     // 创建OCR参数
     vision::OcrParams createParams() const;
+
+    std::shared_ptr<const vision::OcrParams> m_params;  // 解析参数后预先创建的OCR参数，识别时直接使用
     
     std::vector<int> m_roi = {0, 0, 0, 0};
     std::vector<int> m_roiOffset = {0, 0, 0, 0};
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Pipeline/Common.h"
+#include "Pipeline/Frame.h"
+#include "Pipeline/CancellationToken.h"
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -32,11 +35,18 @@ public:
     RecognitionType getType() const { return m_type; }
 
     // 设置是否反转结果
-    void setInverse(bool inverse) { m_inverse = inverse; }
+    void setInverse(bool inverse) { m_inverse = inverse; updateConfigKey(); }
     bool isInverse() const { return m_inverse; }
 
-    // 纯虚函数，由派生类实现
-    virtual RecognitionResult recognize() = 0;
+    // 纯虚函数，由派生类实现，在指定帧上执行识别
+    // 包含多次视觉调用的识别应在调用之间检查token，被取消时尽快返回失败
+    virtual RecognitionResult recognize(const Frame& frame, const CancellationToken& token) const = 0;
+
+    // 不需要取消时使用
+    RecognitionResult recognize(const Frame& frame) const { return recognize(frame, CancellationToken::none()); }
+
+    // 不指定帧时由VisionEngine自行截图
+    RecognitionResult recognize() const { return recognize(Frame{}); }
     
     // 解析参数，由派生类实现
     virtual bool parseConfig(const nlohmann::json& config) = 0;
@@ -44,9 +54,40 @@ public:
     // 工厂方法，根据类型创建识别对象
     static std::unique_ptr<Recognition> create(RecognitionType type, const nlohmann::json& config);
 
+    // 识别参数的规范化键，由类型、反转标志和解析后的参数组成
+    // 键相同的识别在同一帧上结果相同，用于识别结果缓存
+    const std::string& getConfigKey() const { return m_configKey; }
+    size_t getConfigHash() const { return m_configHash; }
+
+    // 重新生成规范化键，修改参数后调用
+    void updateConfigKey();
+
+    // 预热识别需要的资源（模板图像等），同一个识别对象只预热一次，可以在任意线程上调用
+    void prepare() const;
+
+    // 是否已经预热
+    bool isPrepared() const { return m_prepared.load(std::memory_order_acquire); }
+
+    // 识别区域（已应用roi_offset），为空时识别整帧，用于画面稳定检测
+    virtual std::optional<Rect> getRoi() const { return std::nullopt; }
+
 protected:
+    // 返回解析后的参数，由派生类实现，用于生成规范化键
+    virtual nlohmann::json configToJson() const { return nlohmann::json::object(); }
+
+    // 预热资源，由需要预热的派生类实现
+    virtual void onPrepare() const {}
+
+    // 由roi和roi_offset参数计算识别区域，未设置roi（全为0）时返回空值
+    static std::optional<Rect> resolveRoi(const std::vector<int>& roi, const std::vector<int>& roiOffset);
+
     RecognitionType m_type;
     bool m_inverse = false;
+
+private:
+    std::string m_configKey;
+    size_t m_configHash = 0;
+    mutable std::atomic<bool> m_prepared{false};
 };
 
 // 将字符串转换为识别类型
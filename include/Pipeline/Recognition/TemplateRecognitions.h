@@ -4,21 +4,37 @@
 #include <vector>
 #include <string>
 
+namespace vision {
+    struct TemplateMatchParams;
+}
+
 namespace Pipeline {
 
 // TemplateMatch识别类 - 模板匹配
 class PIPELINE_API TemplateMatchRecognition : public Recognition {
 public:
     TemplateMatchRecognition();
-    virtual RecognitionResult recognize() override;
+    using Recognition::recognize;
+    virtual RecognitionResult recognize(const Frame& frame, const CancellationToken& token) const override;
     virtual bool parseConfig(const nlohmann::json& config) override;
+    virtual std::optional<Rect> getRoi() const override;
+
+protected:
+    virtual nlohmann::json configToJson() const override;
+
+    // 预先读取模板文件，使首次匹配时从系统文件缓存中加载模板
+    virtual void onPrepare() const override;
 
 private:
+    // 创建模板匹配参数
+    vision::TemplateMatchParams createParams() const;
+
     std::vector<int> m_roi = {0, 0, 0, 0};
     std::vector<int> m_roiOffset = {0, 0, 0, 0};
     std::vector<std::string> m_templates;
     std::vector<double> m_thresholds;
     int m_method = 5; // 默认使用TM_CCOEFF_NORMED
+    std::shared_ptr<const vision::TemplateMatchParams> m_params; // 解析参数后预先创建的模板匹配参数，识别时直接使用
 };
 
 } // namespace Pipeline
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace Pipeline {
+
+// 识别结果缓存的统计信息
+struct PIPELINE_API RecognitionCacheStats {
+    uint64_t hits = 0;      // 命中次数
+    uint64_t misses = 0;    // 未命中次数
+};
+
+// 按帧缓存识别结果，同一帧上参数相同的识别只执行一次
+// 以帧序号和识别参数的规范化键为键，只有最新一帧的结果有效
+// 切换到新帧时不删除旧帧的条目，之后存入同一参数的结果时原地覆盖，稳定运行后不再分配内存
+class PIPELINE_API RecognitionCache {
+public:
+    RecognitionCache() = default;
+
+    // 不可复制
+    RecognitionCache(const RecognitionCache&) = delete;
+    RecognitionCache& operator=(const RecognitionCache&) = delete;
+
+    // 查找缓存的识别结果，configHash为configKey的哈希值
+    std::optional<RecognitionResult> lookup(uint64_t frameId, size_t configHash, const std::string& configKey);
+
+    // 保存识别结果，帧序号比当前缓存的帧更旧时忽略
+    void store(uint64_t frameId, size_t configHash, const std::string& configKey, const RecognitionResult& result);
+
+    // 清空缓存，统计信息保持不变
+    void clear();
+
+    // 获取统计信息
+    RecognitionCacheStats getStats() const;
+
+    // 重置统计信息
+    void resetStats();
+
+private:
+    struct Entry {
+        uint64_t frameId = 0;                           // 结果所属的帧序号，不是当前帧时条目无效
+        std::string configKey;
+        RecognitionResult result;
+    };
+
+    // 切换到新帧，旧帧的条目随之失效，调用时需持有m_mutex
+    void advanceFrame(uint64_t frameId);
+
+    mutable std::mutex m_mutex;
+    uint64_t m_frameId = 0;                             // 当前缓存的帧序号
+    std::unordered_map<size_t, Entry> m_entries;        // 以参数哈希为键的识别结果，包含已经失效的旧帧条目
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+};
+
+} // namespace Pipeline
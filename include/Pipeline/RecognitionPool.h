@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include "Pipeline/Recognition.h"
+#include <memory>
+#include <unordered_map>
+
+namespace Pipeline {
+
+// 识别对象池，加载时按规范化键合并参数相同的识别对象
+// 参数相同的节点共享同一个不可变的识别对象，减少内存占用，也为识别结果缓存提供稳定的标识
+class PIPELINE_API RecognitionPool {
+public:
+    RecognitionPool() = default;
+
+    // 不可复制，可以移动
+    RecognitionPool(const RecognitionPool&) = delete;
+    RecognitionPool& operator=(const RecognitionPool&) = delete;
+    RecognitionPool(RecognitionPool&&) = default;
+    RecognitionPool& operator=(RecognitionPool&&) = default;
+
+    // 返回与recognition参数相同的共享识别对象，池中没有时将recognition加入池中
+    // recognition必须已经解析完参数并生成了规范化键
+    std::shared_ptr<const Recognition> intern(std::unique_ptr<Recognition> recognition);
+
+    // 将已有的共享识别对象加入池中，池中已有参数相同的对象时不做任何操作
+    void insert(const std::shared_ptr<const Recognition>& recognition);
+
+    // 设置上一个识别对象池，本池中没有时先从上一个池中查找，热重载时用于复用没有变化的识别对象
+    void setPrevious(const RecognitionPool* previous) { m_previous = previous; }
+
+    // 池中不同识别对象的数量
+    size_t size() const { return m_recognitions.size(); }
+
+    // 清空识别对象池，已经分配给节点的识别对象不受影响
+    void clear() { m_recognitions.clear(); }
+
+private:
+    std::unordered_map<std::string, std::shared_ptr<const Recognition>> m_recognitions; // 以规范化键为键的识别对象
+    const RecognitionPool* m_previous = nullptr;    // 上一个识别对象池
+};
+
+} // namespace Pipeline
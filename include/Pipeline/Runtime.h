@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include "Pipeline/Clock.h"
+#include "Pipeline/WorkerPool.h"
+#include "Pipeline/TimerWheel.h"
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace Pipeline {
+
+// 协程运行时，在固定数量的工作线程上调度多个流水线的协程（M:N调度）
+// 协程在每个节点结束、暂停或等待时让出执行权，工作线程随即执行其他就绪的协程
+// 所有定时等待共用运行时的分层时间轮，由工作线程在调度间隙推进，空闲时由其中一个工作线程等待最近的到期时间
+// 使用虚拟时钟时不等待，所有工作线程都空闲时直接把时钟推进到最近的到期时间
+class PIPELINE_API Runtime {
+public:
+    // 定时器，deadline、handle和resumed由调用者设置
+    using Timer = TimerWheel::Entry;
+
+    // workerCount为0时使用硬件并发数，clock为空时使用steady_clock
+    explicit Runtime(size_t workerCount = 0, std::shared_ptr<Clock> clock = nullptr);
+    ~Runtime();
+
+    // 不可复制
+    Runtime(const Runtime&) = delete;
+    Runtime& operator=(const Runtime&) = delete;
+
+    // 将协程放入就绪队列，由工作线程恢复执行
+    void post(std::coroutine_handle<> handle);
+
+    // 在指定时间点将协程放入就绪队列
+    // resumed不为空时，多个唤醒源共享该标志，只有第一个将其置为true的唤醒源恢复协程
+    void postAt(std::coroutine_handle<> handle, std::chrono::steady_clock::time_point deadline,
+                std::shared_ptr<std::atomic<bool>> resumed = nullptr);
+
+    // 添加定时器，到期时按resumed的约定恢复协程
+    // 定时器由调用者持有，在到期或取消之前必须保持有效
+    void arm(Timer& timer);
+
+    // 取消定时器，定时器已经到期或不在运行时中时返回false
+    bool cancel(Timer& timer);
+
+    // 让出执行权的等待器，协程被重新放入就绪队列末尾
+    // runtime为空时不挂起，直接继续执行
+    struct YieldAwaiter {
+        Runtime* runtime;
+
+        bool await_ready() const noexcept { return runtime == nullptr; }
+        void await_suspend(std::coroutine_handle<> handle) const { runtime->post(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    // co_await runtime.yield() 让出执行权
+    YieldAwaiter yield() { return YieldAwaiter{this}; }
+
+    // 获取运行时的时钟，定时器的到期时间和协程中的计时都以它为准
+    const std::shared_ptr<Clock>& getClock() const { return m_clock; }
+    Clock::time_point now() const { return m_clock->now(); }
+
+    // 获取工作线程数
+    size_t getWorkerCount() const { return m_workers.size(); }
+
+    // 获取就绪队列中等待执行的协程数
+    size_t getReadyCount() const;
+
+    // 获取等待中的定时器数量
+    size_t getTimerCount() const;
+
+    // 获取并行识别共享的线程池，在首次使用时创建
+    std::shared_ptr<WorkerPool> getWorkerPool();
+
+private:
+    // 工作线程主循环
+    void workerLoop();
+
+    // 推进时间轮，将到期的协程放入就绪队列，调用时必须持有m_mutex
+    void collectExpired(std::chrono::steady_clock::time_point now);
+
+    // 将定时器放入时间轮，必要时唤醒工作线程重新计算等待时间，调用时必须持有m_mutex
+    void armLocked(Timer& timer);
+
+    // 就绪队列的入队和出队，调用时必须持有m_mutex
+    void pushReady(std::coroutine_handle<> handle);
+    std::coroutine_handle<> popReady();
+
+    std::shared_ptr<Clock> m_clock;                 // 时钟
+    VirtualClock* m_virtualClock = nullptr;         // 时钟为虚拟时钟时指向它
+    std::vector<std::thread> m_workers;
+    std::vector<std::coroutine_handle<>> m_ready;   // 就绪队列，环形缓冲区，只在队列满时扩容，稳定运行后不再分配内存
+    size_t m_readyHead = 0;                         // 队首在m_ready中的下标
+    size_t m_readyCount = 0;                        // 队列中的协程数
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+    size_t m_activeWorkers = 0;                     // 正在执行协程的工作线程数
+
+    TimerWheel m_wheel;                             // 定时器，由m_mutex保护
+    std::vector<Timer*> m_expired;                  // 推进时间轮时复用的到期定时器列表
+    bool m_hasTimerKeeper = false;                  // 是否有空闲的工作线程在等待最近的到期时间
+    std::chrono::steady_clock::time_point m_keeperDeadline; // 该工作线程的等待截止时间
+
+    std::mutex m_poolMutex;
+    std::shared_ptr<WorkerPool> m_workerPool;       // 并行识别线程池
+};
+
+} // namespace Pipeline
@@ -1,51 +1,84 @@
 #pragma once
 
 #include "Pipeline/Common.h"
+#include "Pipeline/CancellationToken.h"
+#include <atomic>
 
 namespace Pipeline {
 
-// 任务完成等待器，用于协程
-struct PIPELINE_API TaskAwaiter {
-    bool await_ready() const noexcept { return false; }
-    void await_suspend(std::coroutine_handle<> handle) const noexcept { m_handle = handle; }
-    void await_resume() const noexcept {}
-    
-    void resume() const {
-        if (m_handle) {
-            m_handle.resume();
-        }
-    }
-    
-    mutable std::coroutine_handle<> m_handle;
+// 前向声明
+class Runtime;
+
+// 定时等待器，挂起协程直到指定的时间点，期间工作线程可以执行其他协程
+// 指定了取消令牌时，令牌被取消后立即恢复；runtime为空时在当前线程上阻塞等待
+class PIPELINE_API DelayAwaiter {
+public:
+    DelayAwaiter(Runtime* runtime, std::chrono::steady_clock::time_point deadline, CancellationToken* token = nullptr)
+        : m_runtime(runtime), m_deadline(deadline), m_token(token) {}
+
+    bool await_ready() const;
+    void await_suspend(std::coroutine_handle<> handle);
+    void await_resume();
+
+    // 获取恢复标志，与其他唤醒源共享，只有第一个将其置为true的唤醒源恢复协程
+    // 必须在await_suspend之前调用
+    std::shared_ptr<std::atomic<bool>> getResumedFlag();
+
+private:
+    struct WakeState;
+
+    Runtime* m_runtime;
+    std::chrono::steady_clock::time_point m_deadline;
+    CancellationToken* m_token;
+    std::shared_ptr<WakeState> m_wakeState;
 };
 
+// co_await delay(runtime, duration, token) 等待指定时长，按运行时的时钟计时
+PIPELINE_API DelayAwaiter delay(Runtime* runtime, std::chrono::milliseconds duration, CancellationToken* token = nullptr);
+
 // 任务类，用于基于协程的执行
+// 任务创建后处于挂起状态，通过start()交给运行时调度
 class PIPELINE_API Task {
 public:
     struct promise_type {
+        // 协程结束时设置完成标志，并唤醒等待任务完成的线程
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> handle) const noexcept {
+                // 协程帧可能在标志设置后立即被销毁，因此先复制共享状态
+                auto done = handle.promise().m_done;
+                done->store(true, std::memory_order_release);
+                done->notify_all();
+            }
+            void await_resume() const noexcept {}
+        };
+
         Task get_return_object() { return Task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
-        std::suspend_never initial_suspend() { return {}; }
-        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always initial_suspend() { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
         void return_void() {}
         void unhandled_exception() { std::terminate(); }
+
+        std::shared_ptr<std::atomic<bool>> m_done = std::make_shared<std::atomic<bool>>(false);
     };
-    
+
+    Task() = default;
     explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
     ~Task() {
         if (m_handle) {
             m_handle.destroy();
         }
     }
-    
+
     // 不可复制
     Task(const Task&) = delete;
     Task& operator=(const Task&) = delete;
-    
+
     // 可移动
     Task(Task&& other) noexcept : m_handle(other.m_handle) {
         other.m_handle = nullptr;
     }
-    
+
     Task& operator=(Task&& other) noexcept {
         if (this != &other) {
             if (m_handle) {
@@ -56,7 +89,22 @@ public:
         }
         return *this;
     }
-    
+
+    // 将任务交给运行时调度执行
+    void start(Runtime& runtime);
+
+    // 任务是否已经结束
+    bool done() const {
+        return !m_handle || m_handle.promise().m_done->load(std::memory_order_acquire);
+    }
+
+    // 阻塞等待任务结束，不能在任务自身所在的协程中调用
+    void wait() const {
+        if (m_handle) {
+            m_handle.promise().m_done->wait(false, std::memory_order_acquire);
+        }
+    }
+
 private:
     std::coroutine_handle<promise_type> m_handle;
 };
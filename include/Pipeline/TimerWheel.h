@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include <array>
+#include <atomic>
+
+namespace Pipeline {
+
+// 分层时间轮，以固定的刻度管理大量定时器，添加和取消都是O(1)
+// 共4层，每层64个槽，第0层每槽1个刻度，上一层每槽为下一层一整圈，刻度为1毫秒时覆盖约4.6小时，更远的定时器放在最高层，到期前逐层下移
+// 本身不是线程安全的，由持有者加锁保护
+class PIPELINE_API TimerWheel {
+public:
+    // 定时器节点，以侵入式链表挂在时间轮的槽中，由调用者持有，在到期或取消之前必须保持有效
+    struct Entry {
+        std::chrono::steady_clock::time_point deadline;     // 到期时间
+        std::coroutine_handle<> handle;                     // 到期时恢复的协程
+        std::atomic<bool>* resumed = nullptr;               // 与其他唤醒源共享的恢复标志，为空时到期即恢复
+        std::shared_ptr<std::atomic<bool>> resumedHolder;   // 持有resumed，由时间轮自行分配的节点使用
+        bool owned = false;                                 // 是否由时间轮的持有者分配，到期或清空时由其释放
+
+        // 以下字段由时间轮维护
+        Entry* prev = nullptr;
+        Entry* next = nullptr;
+        uint64_t expiry = 0;                                // 到期的刻度
+        uint8_t level = 0;
+        uint8_t slot = 0;
+        bool linked = false;
+    };
+
+    explicit TimerWheel(std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now(),
+                        std::chrono::steady_clock::duration tick = std::chrono::milliseconds(1));
+
+    // 不可复制
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // 添加定时器，已经到期的定时器在下一次推进时取出
+    void arm(Entry& entry);
+
+    // 取消定时器，定时器不在时间轮中时返回false
+    bool cancel(Entry& entry);
+
+    // 推进到now，将到期的定时器从时间轮中取下并追加到expired
+    void advance(std::chrono::steady_clock::time_point now, std::vector<Entry*>& expired);
+
+    // 下一次需要推进的时间点，可能是定时器到期或上层定时器下移的时间，没有定时器时返回空值
+    std::optional<std::chrono::steady_clock::time_point> nextWakeup() const;
+
+    // 取下所有定时器并追加到entries
+    void clear(std::vector<Entry*>& entries);
+
+    // 定时器数量
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+private:
+    static constexpr int LevelBits = 6;
+    static constexpr int SlotCount = 1 << LevelBits;
+    static constexpr int LevelCount = 4;
+    static constexpr uint64_t SlotMask = SlotCount - 1;
+
+    // 按到期刻度与当前刻度的距离放入对应层的槽中
+    void insert(Entry& entry);
+
+    // 从所在的槽中摘下
+    void unlink(Entry& entry);
+
+    // 将上层槽中的定时器重新放入下层
+    void cascade(int level, uint8_t slot);
+
+    // 时间点转换为刻度，向上取整，保证不会提前到期
+    uint64_t toTick(std::chrono::steady_clock::time_point time) const;
+
+    // 下一个有事件的刻度，没有定时器时返回最大值
+    uint64_t nextEventTick() const;
+
+    std::chrono::steady_clock::time_point m_start;      // 第0个刻度对应的时间
+    std::chrono::steady_clock::duration m_tick;         // 刻度长度
+    uint64_t m_current = 0;                             // 下一个要处理的刻度，之前的刻度都已处理完毕
+    size_t m_size = 0;
+    std::array<std::array<Entry*, SlotCount>, LevelCount> m_slots{};   // 每个槽的链表头
+    std::array<uint64_t, LevelCount> m_occupied{};                      // 每层非空槽的位图
+};
+
+} // namespace Pipeline
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include "Pipeline/Node.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace Pipeline {
+
+// 一次节点转移的统计
+struct PIPELINE_API Transition {
+    NodeId from = InvalidNodeId;    // 转移前的节点
+    NodeId to = InvalidNodeId;      // 转移后的节点
+    uint64_t count = 0;             // 转移次数
+};
+
+// 节点转移模型，统计流水线在节点之间转移的次数
+// 按转移频率（一阶马尔可夫链）预测当前节点最可能的后继节点，用于提前预热它们的识别
+class PIPELINE_API TransitionModel {
+public:
+    TransitionModel() = default;
+
+    // 不可复制
+    TransitionModel(const TransitionModel&) = delete;
+    TransitionModel& operator=(const TransitionModel&) = delete;
+
+    // 记录一次转移，可以在多个线程上同时调用
+    void record(NodeId from, NodeId to, uint64_t count = 1);
+
+    // 按转移次数从多到少返回from最可能的后继节点，最多count个，次数相同时按节点ID排列
+    std::vector<NodeId> predict(NodeId from, size_t count) const;
+
+    // 同上，结果写入predicted，复用它的内存，不再另外分配
+    void predict(NodeId from, size_t count, std::vector<NodeId>& predicted) const;
+
+    // 获取from转移到to的次数
+    uint64_t getCount(NodeId from, NodeId to) const;
+
+    // 获取from转移到to的概率，from没有转移记录时返回0
+    double getProbability(NodeId from, NodeId to) const;
+
+    // 获取所有转移记录，用于持久化
+    std::vector<Transition> getTransitions() const;
+
+    // 清空转移记录
+    void clear();
+
+private:
+    // 一个节点出发的转移记录
+    struct Row {
+        std::unordered_map<NodeId, uint64_t> counts;    // 以后继节点为键的转移次数
+        uint64_t total = 0;                             // 转移总次数
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<NodeId, Row> m_rows;             // 以转移前的节点为键的转移记录
+};
+
+} // namespace Pipeline
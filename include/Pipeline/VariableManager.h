@@ -8,6 +8,7 @@
 #include <optional>
 #include <functional>
 #include <regex>
+#include <mutex>
 
 namespace Pipeline {
 
@@ -155,6 +156,12 @@ public:
     // 设置变量值
     bool setVariable(const std::string& name, const VariableValue& value);
 
+    // 获取所有变量的快照，按变量名排序
+    std::vector<std::pair<std::string, Variable>> getVariables() const;
+
+    // 用快照替换所有变量，用于从检查点恢复
+    void restoreVariables(const std::vector<std::pair<std::string, Variable>>& variables);
+
     // 解析变量定义字符串
     bool parseVariableDefinition(const std::string& definition);
 
@@ -170,7 +177,14 @@ public:
     // 执行变量操作表达式
     bool executeExpression(const std::string& expression);
 
+    // 锁定变量管理器，持有期间其他线程的调用被阻塞，用于将多次调用合并为一个原子操作
+    // 每个公开方法本身已经是原子的
+    std::unique_lock<std::recursive_mutex> lock() const { return std::unique_lock<std::recursive_mutex>(m_mutex); }
+
 private:
+    // 保护变量存储，分叉出的子流程共享同一个变量管理器
+    mutable std::recursive_mutex m_mutex;
+
     // 变量存储
     std::unordered_map<std::string, Variable> m_variables;
 
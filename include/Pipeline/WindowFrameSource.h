@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Pipeline/Clock.h"
+#include "Pipeline/Frame.h"
+
+namespace vision {
+    class WindowVision;
+}
+
+namespace Pipeline {
+
+// 基于vision::WindowVision的帧源，从窗口图像缓存中获取帧快照
+class PIPELINE_API WindowFrameSource : public FrameSource {
+public:
+    // hwnd为窗口句柄（HWND）
+    // clock为流水线运行时的时钟，帧的截取时间换算到该时钟上，为空时使用steady_clock
+    WindowFrameSource(vision::WindowVision* windowVision, void* hwnd, std::shared_ptr<Clock> clock = nullptr);
+
+    // 采集一帧，截取时间为当前时钟时间减去窗口图像的实际存在时长
+    Frame capture() override;
+
+    // 等待窗口图像更新
+    bool waitForNewFrame(uint64_t lastEpoch, std::chrono::milliseconds maxWait) override;
+
+    // 窗口图像更新时调用回调
+    bool notifyOnNewFrame(uint64_t lastEpoch, const void* key, std::function<void()> callback) override;
+
+    // 注销尚未调用的回调
+    void cancelNewFrameNotification(const void* key) override;
+
+    // 比较两帧窗口图像在roi内的平均像素差，按所有通道归一化到0到1
+    std::optional<double> compareRegion(const Frame& previous, const Frame& current,
+                                        const std::optional<Rect>& roi) override;
+
+private:
+    vision::WindowVision* m_windowVision;
+    void* m_hwnd;
+    std::shared_ptr<Clock> m_clock;
+};
+
+} // namespace Pipeline
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Pipeline/Common.h"
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+namespace Pipeline {
+
+// 工作线程池，用于并行执行识别等耗时操作
+class PIPELINE_API WorkerPool {
+public:
+    // threadCount为0时使用硬件并发数
+    explicit WorkerPool(size_t threadCount = 0);
+    ~WorkerPool();
+
+    // 不可复制
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // 提交任务，返回任务结果的future
+    template<typename F>
+    auto submit(F&& func) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using ResultType = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(func));
+        std::future<ResultType> future = task->get_future();
+        post([task]() { (*task)(); });
+        return future;
+    }
+
+    // 提交不需要结果的任务，不创建future；只捕获少量指针的任务不分配内存
+    void post(std::function<void()> job);
+
+    // 获取线程数
+    size_t size() const { return m_threads.size(); }
+
+private:
+
+    // 工作线程主循环
+    void workerLoop();
+
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+};
+
+} // namespace Pipeline
@@ -2,13 +2,23 @@
 
 // 包含所有必要的头文件
 #include "Pipeline/Common.h"
+#include "Pipeline/Frame.h"
+#include "Pipeline/WindowFrameSource.h"
 #include "Pipeline/Recognition.h"
 #include "Pipeline/Action.h"
 #include "Pipeline/Node.h"
 #include "Pipeline/Task.h"
+#include "Pipeline/Runtime.h"
+#include "Pipeline/PipelineDefinition.h"
 #include "Pipeline/Pipeline.h"
 #include "Pipeline/PipelineExecutor.h"
 
+// 运行时句柄，多个执行器共享同一个运行时时使用
+typedef struct PipelineRuntimeHandle PipelineRuntimeHandle;
+
+// 流水线定义句柄，多个执行器共享同一个只读的流水线定义时使用
+typedef struct PipelineDefinitionHandle PipelineDefinitionHandle;
+
 // 导出函数
 extern "C" {
     // 初始化库
@@ -20,6 +30,15 @@ extern "C" {
     // 创建流水线执行器
     PIPELINE_API Pipeline::PipelineExecutor* PipelineCreateExecutor();
 
+    // 创建运行时，workerCount为调度协程的工作线程数，0表示使用硬件并发数
+    PIPELINE_API PipelineRuntimeHandle* PipelineCreateRuntime(int workerCount);
+
+    // 销毁运行时句柄，已创建的执行器仍持有运行时，直到它们被销毁
+    PIPELINE_API void PipelineDestroyRuntime(PipelineRuntimeHandle* runtime);
+
+    // 创建使用指定运行时的流水线执行器，runtime为空时等同于PipelineCreateExecutor
+    PIPELINE_API Pipeline::PipelineExecutor* PipelineCreateExecutorWithRuntime(PipelineRuntimeHandle* runtime);
+
     // 销毁流水线执行器
     PIPELINE_API void PipelineDestroyExecutor(Pipeline::PipelineExecutor* executor);
 
@@ -29,6 +48,24 @@ extern "C" {
     // 从字符串执行流水线
     PIPELINE_API bool PipelineExecuteFromString(Pipeline::PipelineExecutor* executor, const char* jsonString, const char* startNodeName);
 
+    // 从文件加载流水线定义，失败时返回NULL
+    PIPELINE_API PipelineDefinitionHandle* PipelineLoadDefinitionFromFile(const char* filePath);
+
+    // 从字符串加载流水线定义，失败时返回NULL
+    PIPELINE_API PipelineDefinitionHandle* PipelineLoadDefinitionFromString(const char* jsonString);
+
+    // 销毁流水线定义句柄，正在使用该定义的执行器仍持有它，直到执行器加载其他流水线或被销毁
+    PIPELINE_API void PipelineDestroyDefinition(PipelineDefinitionHandle* definition);
+
+    // 执行已加载的流水线定义
+    PIPELINE_API bool PipelineExecuteDefinition(Pipeline::PipelineExecutor* executor, PipelineDefinitionHandle* definition, const char* startNodeName);
+
+    // 热重载流水线定义，不停止当前执行，新的定义在两个节点之间生效
+    PIPELINE_API bool PipelineReloadFromFile(Pipeline::PipelineExecutor* executor, const char* filePath);
+
+    // 从字符串热重载流水线定义
+    PIPELINE_API bool PipelineReloadFromString(Pipeline::PipelineExecutor* executor, const char* jsonString);
+
     // 停止流水线执行
     PIPELINE_API void PipelineStop(Pipeline::PipelineExecutor* executor);
 
@@ -44,6 +81,38 @@ extern "C" {
     // 获取当前节点名称
     PIPELINE_API const char* PipelineGetCurrentNodeName(Pipeline::PipelineExecutor* executor);
 
+    // 获取识别结果缓存的命中和未命中次数，参数可以为空
+    PIPELINE_API void PipelineGetRecognitionCacheStats(Pipeline::PipelineExecutor* executor, uint64_t* hits, uint64_t* misses);
+
+    // 获取节点到各候选节点的统计信息，返回JSON数组字符串，按下一轮的评估顺序排列
+    // 每项包含from、to、attempts、hits、average_cost（毫秒）和score，返回的字符串在同一线程下次调用前有效
+    PIPELINE_API const char* PipelineGetEdgeStats(Pipeline::PipelineExecutor* executor, const char* nodeName);
+
+    // 将节点转移模型按节点名保存为JSON文件，用于在多次运行之间保留预测
+    PIPELINE_API bool PipelineSaveTransitionModel(Pipeline::PipelineExecutor* executor, const char* filePath);
+
+    // 从JSON文件加载节点转移模型，记录累加到当前模型中，需要在加载流水线之后调用
+    PIPELINE_API bool PipelineLoadTransitionModel(Pipeline::PipelineExecutor* executor, const char* filePath);
+
+    // 获取节点学习到的后置延迟（毫秒），节点不是"post_delay": "auto"或还没有测量结果时返回-1
+    PIPELINE_API int PipelineGetLearnedPostDelay(Pipeline::PipelineExecutor* executor, const char* nodeName);
+
+    // 将动作延迟模型按节点名保存为JSON文件，用于在多次运行之间保留学习到的后置延迟
+    PIPELINE_API bool PipelineSaveLatencyModel(Pipeline::PipelineExecutor* executor, const char* filePath);
+
+    // 从JSON文件加载动作延迟模型，样本追加到当前模型中，需要在加载流水线之后调用
+    PIPELINE_API bool PipelineLoadLatencyModel(Pipeline::PipelineExecutor* executor, const char* filePath);
+
+    // 生成当前执行位置的检查点，返回检查点的字节数，流水线停止时返回0
+    // buffer为NULL或bufferSize小于返回值时不写入，调用者按返回值分配缓冲区后重新调用
+    PIPELINE_API size_t PipelineCheckpoint(Pipeline::PipelineExecutor* executor, uint8_t* buffer, size_t bufferSize);
+
+    // 加载流水线并从检查点恢复执行，检查点无效或其中的节点不存在时返回false
+    PIPELINE_API bool PipelineRestoreFromFile(Pipeline::PipelineExecutor* executor, const char* filePath,
+                                              const uint8_t* checkpoint, size_t checkpointSize);
+    PIPELINE_API bool PipelineRestoreFromString(Pipeline::PipelineExecutor* executor, const char* jsonString,
+                                                const uint8_t* checkpoint, size_t checkpointSize);
+
     // 设置任务停止回调
     typedef void (*PipelineTaskStopCallbackFunc)(const char* nodeName, const char* reason);
     PIPELINE_API void PipelineSetTaskStopCallback(Pipeline::PipelineExecutor* executor, PipelineTaskStopCallbackFunc callback);
@@ -5,12 +5,27 @@
 #include "../engine/Vision.h"
 #include <opencv2/opencv.hpp>
 #include <map>
+#include <memory>
 #include <chrono>
 #include <shared_mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
 #include <Windows.h>
 
 namespace vision {
 
+// 窗口帧快照，旧快照在被引用期间保持有效，不会被之后的更新修改
+// 不再被引用的快照（包括其中的Vision对象和图像缓冲区）在之后的更新中原地复用
+struct VISION_API WindowFrame {
+    uint64_t epoch = 0;                                 // 帧序号，单调递增
+    std::chrono::steady_clock::time_point captureTime;  // 采集时间
+    cv::Mat image;                                      // 窗口图像
+    VisionHandle vision = nullptr;                      // 该帧对应的Vision对象
+
+    ~WindowFrame();
+};
+
 // WindowVision类 - 窗口图像管理和视觉处理
 class VISION_API WindowVision {
 public:
@@ -25,6 +40,20 @@ public:
     
     // 获取窗口对应的Vision对象
     VisionHandle getVisionObject(HWND hwnd);
+
+    // 获取窗口当前的帧快照，缓存过期时返回nullptr
+    std::shared_ptr<const WindowFrame> acquireFrame(HWND hwnd);
+
+    // 等待窗口图像更新到帧序号大于lastEpoch的帧，超时返回false
+    bool waitForUpdate(HWND hwnd, uint64_t lastEpoch, std::chrono::milliseconds timeout);
+
+    // 注册一次性的更新回调，窗口图像更新到帧序号大于lastEpoch的帧时调用
+    // 已经有更新的帧时立即在当前线程调用；回调在updateWindowImage的调用线程上执行，不能阻塞
+    // key标识这次注册，等待超时或取消后通过cancelUpdateNotification注销，否则窗口静止时回调会一直保留
+    void notifyOnUpdate(HWND hwnd, uint64_t lastEpoch, const void* key, std::function<void()> callback);
+
+    // 注销key对应的尚未调用的更新回调
+    void cancelUpdateNotification(const void* key);
     
     // 执行找色操作
     bool findColor(HWND hwnd, int x1, int y1, int x2, int y2, const char* color, double sim, int dir, int* outX, int* outY);
@@ -45,15 +74,32 @@ public:
     cv::Mat getWindowROI(HWND hwnd, int x1, int y1, int x2, int y2);
 
 private:
-    // 窗口图像缓存
-    std::map<HWND, cv::Mat> m_windowImages;
-    std::map<HWND, std::chrono::steady_clock::time_point> m_lastUpdateTime;
-    
-    // 窗口对应的Vision对象
-    std::map<HWND, VisionHandle> m_visionObjects;
+    // 一个窗口的帧快照，当前快照和上一个快照交替使用
+    struct WindowState {
+        std::shared_ptr<WindowFrame> current;           // 当前快照，acquireFrame返回它
+        std::shared_ptr<WindowFrame> spare;             // 上一个快照，下次更新时没有其他引用则原地复用
+    };
+
+    // 窗口帧缓存
+    std::map<HWND, WindowState> m_windows;
+
+    // 帧序号计数器
+    uint64_t m_nextEpoch = 1;
     
     // 互斥锁
     std::shared_mutex m_mutex;
+
+    // 窗口图像更新通知
+    std::condition_variable_any m_updateCondition;
+
+    // 等待窗口图像更新的一次性回调
+    struct UpdateCallback {
+        HWND hwnd;
+        uint64_t lastEpoch;
+        const void* key;
+        std::function<void()> callback;
+    };
+    std::vector<UpdateCallback> m_updateCallbacks;
     
     // 缓存超时时间（毫秒）
     int m_cacheTimeoutMs;
@@ -17,7 +17,7 @@ bool StartAppAction::parseConfig(const nlohmann::json& config) {
     return true;
 }
 
-bool StartAppAction::execute(const RecognitionResult& result) {
+bool StartAppAction::execute(const RecognitionResult& result, const ActionContext& context) const {
     // 这里应该实现实际的启动应用操作
     // 由于实际的启动应用操作不在本库的范围内，这里只是一个示例实现
     
@@ -27,10 +27,10 @@ bool StartAppAction::execute(const RecognitionResult& result) {
     
     // 处理变量表达式
     std::string processedPackage = m_package;
-    if (m_variableManager && (m_package.find("%") != std::string::npos || 
+    if (context.variables && (m_package.find("%") != std::string::npos || 
                              m_package.find("[") != std::string::npos || 
                              m_package.find("{") != std::string::npos)) {
-        processedPackage = m_variableManager->processLogString(m_package);
+        processedPackage = context.variables->processLogString(m_package);
     }
     
     // 执行启动应用
@@ -53,7 +53,7 @@ bool StopAppAction::parseConfig(const nlohmann::json& config) {
     return true;
 }
 
-bool StopAppAction::execute(const RecognitionResult& result) {
+bool StopAppAction::execute(const RecognitionResult& result, const ActionContext& context) const {
     // 这里应该实现实际的停止应用操作
     // 由于实际的停止应用操作不在本库的范围内，这里只是一个示例实现
     
@@ -63,10 +63,10 @@ bool StopAppAction::execute(const RecognitionResult& result) {
     
     // 处理变量表达式
     std::string processedPackage = m_package;
-    if (m_variableManager && (m_package.find("%") != std::string::npos || 
+    if (context.variables && (m_package.find("%") != std::string::npos || 
                              m_package.find("[") != std::string::npos || 
                              m_package.find("{") != std::string::npos)) {
-        processedPackage = m_variableManager->processLogString(m_package);
+        processedPackage = context.variables->processLogString(m_package);
     }
     
     // 执行停止应用
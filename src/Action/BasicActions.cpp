@@ -1,6 +1,6 @@
 #include "Pipeline/Action/BasicActions.h"
 #include "Pipeline/RecognitionResult.h"
-#include "Pipeline/PipelineExecutor.h"
+#include "Pipeline/Pipeline.h"
 
 namespace Pipeline {
 
@@ -8,7 +8,7 @@ namespace Pipeline {
 DoNothingAction::DoNothingAction() : Action(ActionType::DoNothing) {
 }
 
-bool DoNothingAction::execute(const RecognitionResult& result) {
+bool DoNothingAction::execute(const RecognitionResult& result, const ActionContext& context) const {
     // 什么都不做，直接返回成功
     return true;
 }
@@ -27,11 +27,14 @@ bool StopTaskAction::parseConfig(const nlohmann::json& config) {
     return true;
 }
 
-bool StopTaskAction::execute(const RecognitionResult& result) {
-    // 停止当前任务
-    // 在实际实现中，这里应该调用PipelineExecutor的stop方法
-    // 由于我们无法直接访问PipelineExecutor实例，这里通过全局函数实现
-    PipelineStop(nullptr);
+bool StopTaskAction::execute(const RecognitionResult& result, const ActionContext& context) const {
+    // 停止动作所属的流水线
+    if (!context.pipeline) {
+        return false;
+    }
+
+    context.pipeline->triggerTaskStop(context.pipeline->getCurrentNodeName(), "StopTask");
+    context.pipeline->stop();
     return true;
 }
 
@@ -30,7 +30,7 @@ bool ClickAction::parseConfig(const nlohmann::json& config) {
     return true;
 }
 
-bool ClickAction::execute(const RecognitionResult& result) {
+bool ClickAction::execute(const RecognitionResult& result, const ActionContext& context) const {
     // 这里应该实现实际的点击操作
     // 由于实际的点击操作不在本库的范围内，这里只是一个示例实现
     
@@ -51,11 +51,11 @@ bool ClickAction::execute(const RecognitionResult& result) {
         std::string targetStr = std::get<std::string>(m_target);
         
         // 检查是否包含变量表达式
-        if (m_variableManager && (targetStr.find("%") != std::string::npos || 
+        if (context.variables && (targetStr.find("%") != std::string::npos || 
                                  targetStr.find("[") != std::string::npos || 
                                  targetStr.find("{") != std::string::npos)) {
             // 处理变量表达式
-            std::string processedStr = m_variableManager->processLogString(targetStr);
+            std::string processedStr = context.variables->processLogString(targetStr);
             
             // 尝试解析为坐标
             std::regex coordPattern(R"(\s*(\d+)\s*,\s*(\d+)\s*)");
@@ -73,7 +73,7 @@ bool ClickAction::execute(const RecognitionResult& result) {
                 std::smatch varMatches;
                 if (std::regex_search(targetStr, varMatches, varPattern)) {
                     std::string varName = varMatches[0];
-                    auto pointVar = m_variableManager->getVariable(varName);
+                    auto pointVar = context.variables->getVariable(varName);
                     if (pointVar && std::holds_alternative<vision::Point>(*pointVar)) {
                         const vision::Point& point = std::get<vision::Point>(*pointVar);
                         clickX = point.x;
@@ -192,7 +192,7 @@ bool SwipeAction::parseConfig(const nlohmann::json& config) {
     return true;
 }
 
-bool SwipeAction::execute(const RecognitionResult& result) {
+bool SwipeAction::execute(const RecognitionResult& result, const ActionContext& context) const {
     // 这里应该实现实际的滑动操作
     // 由于实际的滑动操作不在本库的范围内，这里只是一个示例实现
     
@@ -213,11 +213,11 @@ bool SwipeAction::execute(const RecognitionResult& result) {
         std::string beginStr = std::get<std::string>(m_begin);
         
         // 检查是否包含变量表达式
-        if (m_variableManager && (beginStr.find("%") != std::string::npos || 
+        if (context.variables && (beginStr.find("%") != std::string::npos || 
                                  beginStr.find("[") != std::string::npos || 
                                  beginStr.find("{") != std::string::npos)) {
             // 处理变量表达式
-            std::string processedStr = m_variableManager->processLogString(beginStr);
+            std::string processedStr = context.variables->processLogString(beginStr);
             
             // 尝试解析为坐标
             std::regex coordPattern(R"(\s*(\d+)\s*,\s*(\d+)\s*)");
@@ -235,7 +235,7 @@ bool SwipeAction::execute(const RecognitionResult& result) {
                 std::smatch varMatches;
                 if (std::regex_search(beginStr, varMatches, varPattern)) {
                     std::string varName = varMatches[0];
-                    auto pointVar = m_variableManager->getVariable(varName);
+                    auto pointVar = context.variables->getVariable(varName);
                     if (pointVar && std::holds_alternative<vision::Point>(*pointVar)) {
                         const vision::Point& point = std::get<vision::Point>(*pointVar);
                         beginX = point.x;
@@ -293,11 +293,11 @@ bool SwipeAction::execute(const RecognitionResult& result) {
         std::string endStr = std::get<std::string>(m_end);
         
         // 检查是否包含变量表达式
-        if (m_variableManager && (endStr.find("%") != std::string::npos || 
+        if (context.variables && (endStr.find("%") != std::string::npos || 
                                 endStr.find("[") != std::string::npos || 
                                 endStr.find("{") != std::string::npos)) {
             // 处理变量表达式
-            std::string processedStr = m_variableManager->processLogString(endStr);
+            std::string processedStr = context.variables->processLogString(endStr);
             
             // 尝试解析为坐标
             std::regex coordPattern(R"(\s*(\d+)\s*,\s*(\d+)\s*)");
@@ -315,7 +315,7 @@ bool SwipeAction::execute(const RecognitionResult& result) {
                 std::smatch varMatches;
                 if (std::regex_search(endStr, varMatches, varPattern)) {
                     std::string varName = varMatches[0];
-                    auto pointVar = m_variableManager->getVariable(varName);
+                    auto pointVar = context.variables->getVariable(varName);
                     if (pointVar && std::holds_alternative<vision::Point>(*pointVar)) {
                         const vision::Point& point = std::get<vision::Point>(*pointVar);
                         endX = point.x;
@@ -332,7 +332,7 @@ bool SwipeAction::execute(const RecognitionResult& result) {
                 std::smatch varMatches;
                 if (std::regex_search(endStr, varMatches, varPattern)) {
                     std::string varName = varMatches[0];
-                    auto rectVar = m_variableManager->getVariable(varName);
+                    auto rectVar = context.variables->getVariable(varName);
                     if (rectVar && std::holds_alternative<vision::Rect>(*rectVar)) {
                         const vision::Rect& rect = std::get<vision::Rect>(*rectVar);
                         // 使用矩形的右下角作为终点
@@ -423,9 +423,14 @@ bool SwipeAction::execute(const RecognitionResult& result) {
         // 执行滑动
         // 在实际实现中，这里应该调用实际的滑动函数，并传入m_duration
         std::cout << "Swiping from: (" << beginX << ", " << beginY << ") to (" << endX << ", " << endY << ") with duration: " << m_duration << "ms" << std::endl;
+
+        // 等待滑动完成，流水线停止或暂停时立即中断
+        if (!context.waitFor(std::chrono::milliseconds(m_duration))) {
+            return false;
+        }
         
         // 如果有变量管理器，可以将起点和终点保存到变量中
-        if (m_variableManager) {
+        if (context.variables) {
             // 创建点坐标变量
             vision::Point beginPoint(beginX, beginY);
             vision::Point endPoint(endX, endY);
@@ -439,9 +444,9 @@ bool SwipeAction::execute(const RecognitionResult& result) {
             
             // 将点坐标和矩形区域保存到变量中
             // 注意：这里仅作为示例，实际应用中可能需要根据需求决定是否保存这些变量
-            m_variableManager->setVariable("%pLastSwipeBegin", beginPoint);
-            m_variableManager->setVariable("%pLastSwipeEnd", endPoint);
-            m_variableManager->setVariable("%rLastSwipeArea", swipeRect);
+            context.variables->setVariable("%pLastSwipeBegin", beginPoint);
+            context.variables->setVariable("%pLastSwipeEnd", endPoint);
+            context.variables->setVariable("%rLastSwipeArea", swipeRect);
         }
         
         return true; // 假设滑动成功
@@ -467,7 +472,7 @@ bool KeyAction::parseConfig(const nlohmann::json& config) {
     return true;
 }
 
-bool KeyAction::execute(const RecognitionResult& result) {
+bool KeyAction::execute(const RecognitionResult& result, const ActionContext& context) const {
     // 这里应该实现实际的按键操作
     // 由于实际的按键操作不在本库的范围内，这里只是一个示例实现
     
@@ -497,7 +502,7 @@ bool TextAction::parseConfig(const nlohmann::json& config) {
     return true;
 }
 
-bool TextAction::execute(const RecognitionResult& result) {
+bool TextAction::execute(const RecognitionResult& result, const ActionContext& context) const {
     // 这里应该实现实际的文本输入操作
     // 由于实际的文本输入操作不在本库的范围内，这里只是一个示例实现
     
@@ -507,10 +512,10 @@ bool TextAction::execute(const RecognitionResult& result) {
     
     // 处理变量表达式
     std::string processedText = m_inputText;
-    if (m_variableManager && (m_inputText.find("%") != std::string::npos || 
+    if (context.variables && (m_inputText.find("%") != std::string::npos || 
                              m_inputText.find("[") != std::string::npos || 
                              m_inputText.find("{") != std::string::npos)) {
-        processedText = m_variableManager->processLogString(m_inputText);
+        processedText = context.variables->processLogString(m_inputText);
     }
     
     // 执行文本输入
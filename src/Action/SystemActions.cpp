@@ -27,7 +27,7 @@ bool CommandAction::parseConfig(const nlohmann::json& config) {
     return true;
 }
 
-bool CommandAction::execute(const RecognitionResult& result) {
+bool CommandAction::execute(const RecognitionResult& result, const ActionContext& context) const {
     // 这里应该实现实际的命令执行操作
     // 由于实际的命令执行操作不在本库的范围内，这里只是一个示例实现
     
@@ -37,19 +37,19 @@ bool CommandAction::execute(const RecognitionResult& result) {
     
     // 处理变量表达式
     std::string processedExec = m_exec;
-    if (m_variableManager && (m_exec.find("%") != std::string::npos || 
+    if (context.variables && (m_exec.find("%") != std::string::npos || 
                              m_exec.find("[") != std::string::npos || 
                              m_exec.find("{") != std::string::npos)) {
-        processedExec = m_variableManager->processLogString(m_exec);
+        processedExec = context.variables->processLogString(m_exec);
     }
     
     std::vector<std::string> processedArgs;
     for (const auto& arg : m_args) {
         std::string processedArg = arg;
-        if (m_variableManager && (arg.find("%") != std::string::npos || 
+        if (context.variables && (arg.find("%") != std::string::npos || 
                                  arg.find("[") != std::string::npos || 
                                  arg.find("{") != std::string::npos)) {
-            processedArg = m_variableManager->processLogString(arg);
+            processedArg = context.variables->processLogString(arg);
         }
         processedArgs.push_back(processedArg);
     }
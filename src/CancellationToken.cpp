@@ -0,0 +1,78 @@
+#include "Pipeline/CancellationToken.h"
+#include <algorithm>
+
+namespace Pipeline {
+
+void CancellationToken::cancel() {
+    std::vector<std::pair<CallbackId, std::function<void()>>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_cancelled.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+
+        // 回调只调用一次，取出后在锁外执行
+        callbacks.swap(m_callbacks);
+        ++m_invoking;
+    }
+    m_condition.notify_all();
+
+    for (auto& [id, callback] : callbacks) {
+        callback();
+    }
+
+    // 通知等待回调结束的注销者
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_invoking;
+    }
+    m_condition.notify_all();
+}
+
+void CancellationToken::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cancelled.store(false, std::memory_order_release);
+}
+
+bool CancellationToken::waitFor(std::chrono::milliseconds duration) const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return !m_condition.wait_for(lock, duration, [this]() { return isCancelled(); });
+}
+
+CancellationToken::CallbackId CancellationToken::registerCallback(std::function<void()> callback) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!isCancelled()) {
+            CallbackId id = m_nextCallbackId++;
+            m_callbacks.emplace_back(id, std::move(callback));
+            return id;
+        }
+    }
+
+    // 已经取消
+    callback();
+    return 0;
+}
+
+void CancellationToken::unregisterCallback(CallbackId id) {
+    if (id == 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_callbacks.begin(), m_callbacks.end(), [id](const auto& entry) { return entry.first == id; });
+    if (it != m_callbacks.end()) {
+        m_callbacks.erase(it);
+        return;
+    }
+
+    // 回调已经被cancel()取出，可能正在其他线程上执行，等待执行结束后调用者才能释放回调访问的状态
+    m_condition.wait(lock, [this]() { return m_invoking == 0; });
+}
+
+const CancellationToken& CancellationToken::none() {
+    static const CancellationToken token;
+    return token;
+}
+
+} // namespace Pipeline
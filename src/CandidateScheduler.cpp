@@ -0,0 +1,102 @@
+#include "Pipeline/CandidateScheduler.h"
+#include <algorithm>
+
+namespace Pipeline {
+
+void CandidateScheduler::record(NodeId from, NodeId to, bool hit, std::chrono::steady_clock::duration cost) {
+    double costMs = std::chrono::duration<double, std::milli>(cost).count();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = m_entries[makeKey(from, to)];
+    ++entry.attempts;
+    if (hit) {
+        ++entry.hits;
+    }
+    entry.totalCost += costMs;
+}
+
+void CandidateScheduler::order(NodeId from, std::vector<NodeId>& candidates) const {
+    if (candidates.size() < 2) {
+        return;
+    }
+
+    auto scoreOf = [this, from](NodeId to) {
+        auto it = m_entries.find(makeKey(from, to));
+        return it != m_entries.end() ? score(it->second) : 0.0;
+    };
+
+    // 候选节点通常只有几个，插入排序保持得分相同的节点的原有顺序，每次比较时重新查找得分
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 1; i < candidates.size(); ++i) {
+        NodeId to = candidates[i];
+        double toScore = scoreOf(to);
+        size_t j = i;
+        for (; j > 0 && toScore < scoreOf(candidates[j - 1]); --j) {
+            candidates[j] = candidates[j - 1];
+        }
+        candidates[j] = to;
+    }
+}
+
+std::vector<EdgeStats> CandidateScheduler::getStats(NodeId from, const std::vector<NodeId>& candidates) const {
+    std::vector<EdgeStats> stats;
+    stats.reserve(candidates.size());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (NodeId to : candidates) {
+        EdgeStats edge;
+        edge.from = from;
+        edge.to = to;
+
+        auto it = m_entries.find(makeKey(from, to));
+        if (it != m_entries.end()) {
+            edge.attempts = it->second.attempts;
+            edge.hits = it->second.hits;
+            edge.averageCost = it->second.totalCost / static_cast<double>(it->second.attempts);
+            edge.score = score(it->second);
+        }
+        stats.push_back(edge);
+    }
+    return stats;
+}
+
+std::optional<RecognitionResult> CandidateScheduler::lookupSample(NodeId node, std::chrono::steady_clock::time_point now,
+                                                                  std::chrono::milliseconds minInterval) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_samples.find(node);
+    if (it == m_samples.end() || now - it->second.time >= minInterval) {
+        return std::nullopt;
+    }
+    return it->second.result;
+}
+
+void CandidateScheduler::storeSample(NodeId node, std::chrono::steady_clock::time_point time, const RecognitionResult& result) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Sample& sample = m_samples[node];
+    sample.time = time;
+    sample.result = result;
+}
+
+void CandidateScheduler::clearSamples() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_samples.clear();
+}
+
+void CandidateScheduler::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_samples.clear();
+}
+
+double CandidateScheduler::score(const Entry& entry) {
+    if (entry.attempts == 0) {
+        return 0.0;
+    }
+
+    // 命中率使用拉普拉斯平滑，从未命中的候选节点仍有机会被评估
+    double averageCost = entry.totalCost / static_cast<double>(entry.attempts);
+    double hitRate = (static_cast<double>(entry.hits) + 1.0) / (static_cast<double>(entry.attempts) + 2.0);
+    return averageCost / hitRate;
+}
+
+} // namespace Pipeline
@@ -0,0 +1,307 @@
+#include "Pipeline/Checkpoint.h"
+#include <cstring>
+
+namespace Pipeline {
+
+namespace {
+
+// 二进制格式的标识和版本，格式变化时增加版本号
+constexpr uint8_t CheckpointMagic[4] = {'P', 'L', 'C', 'P'};
+constexpr uint16_t CheckpointVersion = 1;
+
+// 按小端序写入
+class Writer {
+public:
+    explicit Writer(std::vector<uint8_t>& buffer) : m_buffer(buffer) {}
+
+    void u8(uint8_t value) { m_buffer.push_back(value); }
+
+    void u16(uint16_t value) {
+        for (int i = 0; i < 2; ++i) {
+            m_buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void u32(uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            m_buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void u64(uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            m_buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void i32(int32_t value) { u32(static_cast<uint32_t>(value)); }
+
+    void f64(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        u64(bits);
+    }
+
+    void str(const std::string& value) {
+        u32(static_cast<uint32_t>(value.size()));
+        m_buffer.insert(m_buffer.end(), value.begin(), value.end());
+    }
+
+private:
+    std::vector<uint8_t>& m_buffer;
+};
+
+// 按小端序读取，越界后所有读取都失败
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    bool u8(uint8_t& value) {
+        if (!require(1)) {
+            return false;
+        }
+        value = m_data[m_offset++];
+        return true;
+    }
+
+    bool u16(uint16_t& value) {
+        uint64_t raw;
+        if (!read(2, raw)) {
+            return false;
+        }
+        value = static_cast<uint16_t>(raw);
+        return true;
+    }
+
+    bool u32(uint32_t& value) {
+        uint64_t raw;
+        if (!read(4, raw)) {
+            return false;
+        }
+        value = static_cast<uint32_t>(raw);
+        return true;
+    }
+
+    bool i32(int32_t& value) {
+        uint32_t raw;
+        if (!u32(raw)) {
+            return false;
+        }
+        value = static_cast<int32_t>(raw);
+        return true;
+    }
+
+    bool f64(double& value) {
+        uint64_t bits;
+        if (!read(8, bits)) {
+            return false;
+        }
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    bool str(std::string& value) {
+        uint32_t length;
+        if (!u32(length) || !require(length)) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+        m_offset += length;
+        return true;
+    }
+
+    bool atEnd() const { return m_offset == m_size; }
+
+private:
+    bool require(size_t count) const { return m_size - m_offset >= count; }
+
+    bool read(int bytes, uint64_t& value) {
+        if (!require(static_cast<size_t>(bytes))) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(m_data[m_offset++]) << (8 * i);
+        }
+        return true;
+    }
+
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+};
+
+// 写入变量值，格式由变量类型决定
+void writeVariable(Writer& writer, const Variable& variable) {
+    writer.u8(static_cast<uint8_t>(variable.getType()));
+    switch (variable.getType()) {
+        case VariableType::Integer:
+            writer.i32(variable.getValue<int>());
+            break;
+        case VariableType::String:
+            writer.str(variable.getValue<std::string>());
+            break;
+        case VariableType::Float:
+            writer.f64(variable.getValue<double>());
+            break;
+        case VariableType::Boolean:
+            writer.u8(variable.getValue<bool>() ? 1 : 0);
+            break;
+        case VariableType::Point: {
+            auto point = variable.getValue<Point>();
+            writer.i32(point.x);
+            writer.i32(point.y);
+            break;
+        }
+        case VariableType::Rect: {
+            auto rect = variable.getValue<Rect>();
+            writer.i32(rect.x1);
+            writer.i32(rect.y1);
+            writer.i32(rect.x2);
+            writer.i32(rect.y2);
+            break;
+        }
+    }
+}
+
+// 读取变量值，类型未知或数据不完整时返回false
+bool readVariable(Reader& reader, Variable& variable) {
+    uint8_t type;
+    if (!reader.u8(type) || type > static_cast<uint8_t>(VariableType::Rect)) {
+        return false;
+    }
+
+    switch (static_cast<VariableType>(type)) {
+        case VariableType::Integer: {
+            int32_t value;
+            if (!reader.i32(value)) {
+                return false;
+            }
+            variable = Variable(VariableType::Integer, static_cast<int>(value));
+            return true;
+        }
+        case VariableType::String: {
+            std::string value;
+            if (!reader.str(value)) {
+                return false;
+            }
+            variable = Variable(VariableType::String, std::move(value));
+            return true;
+        }
+        case VariableType::Float: {
+            double value;
+            if (!reader.f64(value)) {
+                return false;
+            }
+            variable = Variable(VariableType::Float, value);
+            return true;
+        }
+        case VariableType::Boolean: {
+            uint8_t value;
+            if (!reader.u8(value)) {
+                return false;
+            }
+            variable = Variable(VariableType::Boolean, value != 0);
+            return true;
+        }
+        case VariableType::Point: {
+            int32_t x, y;
+            if (!reader.i32(x) || !reader.i32(y)) {
+                return false;
+            }
+            variable = Variable(VariableType::Point, Point(x, y));
+            return true;
+        }
+        case VariableType::Rect: {
+            int32_t x1, y1, x2, y2;
+            if (!reader.i32(x1) || !reader.i32(y1) || !reader.i32(x2) || !reader.i32(y2)) {
+                return false;
+            }
+            variable = Variable(VariableType::Rect, Rect(x1, y1, x2, y2));
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::vector<uint8_t> Checkpoint::serialize() const {
+    std::vector<uint8_t> buffer;
+    Writer writer(buffer);
+
+    buffer.insert(buffer.end(), std::begin(CheckpointMagic), std::end(CheckpointMagic));
+    writer.u16(CheckpointVersion);
+
+    writer.str(nodeName);
+    writer.u8(static_cast<uint8_t>(phase));
+    writer.u32(remaining);
+    writer.u8(actionSuccess ? 1 : 0);
+
+    writer.u32(static_cast<uint32_t>(branches.size()));
+    for (const auto& [name, branch] : branches) {
+        writer.str(name);
+        writer.u8(static_cast<uint8_t>(branch));
+    }
+
+    writer.u32(static_cast<uint32_t>(variables.size()));
+    for (const auto& [name, variable] : variables) {
+        writer.str(name);
+        writeVariable(writer, variable);
+    }
+    return buffer;
+}
+
+std::optional<Checkpoint> Checkpoint::deserialize(const uint8_t* data, size_t size) {
+    if (!data || size < sizeof(CheckpointMagic) || std::memcmp(data, CheckpointMagic, sizeof(CheckpointMagic)) != 0) {
+        return std::nullopt;
+    }
+
+    Reader reader(data + sizeof(CheckpointMagic), size - sizeof(CheckpointMagic));
+    uint16_t version;
+    if (!reader.u16(version) || version != CheckpointVersion) {
+        return std::nullopt;
+    }
+
+    Checkpoint checkpoint;
+    uint8_t phase, actionSuccess;
+    if (!reader.str(checkpoint.nodeName) || !reader.u8(phase) || !reader.u32(checkpoint.remaining) ||
+        !reader.u8(actionSuccess) || phase > static_cast<uint8_t>(CheckpointPhase::Waiting)) {
+        return std::nullopt;
+    }
+    checkpoint.phase = static_cast<CheckpointPhase>(phase);
+    checkpoint.actionSuccess = actionSuccess != 0;
+
+    // 数量来自外部数据，只在读取成功后逐个追加，不按数量预留空间
+    uint32_t count;
+    if (!reader.u32(count)) {
+        return std::nullopt;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name;
+        uint8_t branch;
+        if (!reader.str(name) || !reader.u8(branch) || branch > 1) {
+            return std::nullopt;
+        }
+        checkpoint.branches.emplace_back(std::move(name), static_cast<BranchIndex>(branch));
+    }
+
+    if (!reader.u32(count)) {
+        return std::nullopt;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name;
+        Variable variable;
+        if (!reader.str(name) || !readVariable(reader, variable)) {
+            return std::nullopt;
+        }
+        checkpoint.variables.emplace_back(std::move(name), std::move(variable));
+    }
+
+    if (!reader.atEnd()) {
+        return std::nullopt;
+    }
+    return checkpoint;
+}
+
+} // namespace Pipeline
@@ -0,0 +1,34 @@
+#include "Pipeline/Clock.h"
+
+namespace Pipeline {
+
+std::shared_ptr<Clock> Clock::steady() {
+    static std::shared_ptr<Clock> clock = std::make_shared<SteadyClock>();
+    return clock;
+}
+
+bool SteadyClock::sleepFor(std::chrono::milliseconds duration, const CancellationToken* token) {
+    if (token) {
+        return token->waitFor(duration);
+    }
+    std::this_thread::sleep_for(duration);
+    return true;
+}
+
+bool VirtualClock::sleepFor(std::chrono::milliseconds duration, const CancellationToken* token) {
+    if (token && token->isCancelled()) {
+        return false;
+    }
+    advance(duration);
+    return true;
+}
+
+void VirtualClock::advanceTo(time_point deadline) {
+    // 多个线程同时推进时取最大值，时间不会倒退
+    auto target = deadline.time_since_epoch().count();
+    auto current = m_now.load(std::memory_order_acquire);
+    while (current < target && !m_now.compare_exchange_weak(current, target, std::memory_order_acq_rel)) {
+    }
+}
+
+} // namespace Pipeline
@@ -0,0 +1,90 @@
+#include "Pipeline/LatencyModel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Pipeline {
+
+LatencyModel::LatencyModel(size_t windowSize, size_t minSamples, size_t remeasureInterval)
+    : m_windowSize(std::max<size_t>(windowSize, 1)),
+      m_minSamples(std::min(std::max<size_t>(minSamples, 1), std::max<size_t>(windowSize, 1))),
+      m_remeasureInterval(std::max<size_t>(remeasureInterval, 1)) {
+}
+
+void LatencyModel::record(NodeId node, const LatencySample& sample) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Window& window = m_windows[node];
+    if (window.samples.size() < m_windowSize) {
+        window.samples.push_back(sample);
+    } else {
+        window.samples[window.next] = sample;
+    }
+    window.next = (window.next + 1) % m_windowSize;
+}
+
+bool LatencyModel::shouldMeasure(NodeId node) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Window& window = m_windows[node];
+    if (window.samples.size() < m_minSamples) {
+        return true;
+    }
+    return ++window.executions % m_remeasureInterval == 0;
+}
+
+std::optional<LatencySample> LatencyModel::getPercentile(NodeId node, double percentile) const {
+    std::vector<uint32_t> starts;
+    std::vector<uint32_t> settles;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_windows.find(node);
+        if (it == m_windows.end() || it->second.samples.empty()) {
+            return std::nullopt;
+        }
+        starts.reserve(it->second.samples.size());
+        settles.reserve(it->second.samples.size());
+        for (const auto& sample : it->second.samples) {
+            starts.push_back(sample.start);
+            settles.push_back(sample.settle);
+        }
+    }
+
+    // 最近秩法，取不小于percentile%样本的最小值
+    double rank = std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(starts.size()));
+    size_t index = rank > 0.0 ? static_cast<size_t>(rank) - 1 : 0;
+    std::nth_element(starts.begin(), starts.begin() + index, starts.end());
+    std::nth_element(settles.begin(), settles.begin() + index, settles.end());
+    return LatencySample{starts[index], settles[index]};
+}
+
+size_t LatencyModel::getSampleCount(NodeId node) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_windows.find(node);
+    return it != m_windows.end() ? it->second.samples.size() : 0;
+}
+
+std::vector<std::pair<NodeId, std::vector<LatencySample>>> LatencyModel::getSamples() const {
+    std::vector<std::pair<NodeId, std::vector<LatencySample>>> samples;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [node, window] : m_windows) {
+        if (window.samples.empty()) {
+            continue;
+        }
+
+        // 窗口未满时next之前都是有效样本，窗口已满时从next开始是最旧的样本
+        std::vector<LatencySample> ordered;
+        ordered.reserve(window.samples.size());
+        size_t first = window.samples.size() < m_windowSize ? 0 : window.next;
+        for (size_t i = 0; i < window.samples.size(); ++i) {
+            ordered.push_back(window.samples[(first + i) % window.samples.size()]);
+        }
+        samples.emplace_back(node, std::move(ordered));
+    }
+    return samples;
+}
+
+void LatencyModel::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_windows.clear();
+}
+
+} // namespace Pipeline
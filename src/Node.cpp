@@ -3,13 +3,16 @@
 #include <nlohmann/json.hpp>
 #include <thread>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 
 namespace Pipeline {
 
-Node::Node(const std::string& name) : m_name(name) {
+Node::Node(const std::string& name, NodeId id) : m_name(name), m_id(id) {
 }
 
-bool Node::initialize(const nlohmann::json& config, std::map<std::string, std::shared_ptr<Node>>& allNodes) {
+bool Node::initialize(const nlohmann::json& config, const std::unordered_map<std::string, NodeId>& nodeIds,
+                      RecognitionPool* pool) {
     // 解析识别算法
     RecognitionType recognitionType = RecognitionType::DirectHit;
     nlohmann::json recognitionConfig;
@@ -30,13 +33,22 @@ bool Node::initialize(const nlohmann::json& config, std::map<std::string, std::s
     }
 
     // 创建识别算法对象
-    m_recognition = Recognition::create(recognitionType, {});
+    std::unique_ptr<Recognition> recognition = Recognition::create(recognitionType, {});
 
     // 将识别算法的参数传递给Recognition类进行解析
-    if (m_recognition) {
-        m_recognition->parseConfig(recognitionConfig);
+    if (recognition) {
+        recognition->parseConfig(recognitionConfig);
+
+        // 解析是否反转
+        if (config.contains("inverse")) {
+            m_inverse = config["inverse"].get<bool>();
+        }
+        recognition->setInverse(m_inverse);
     }
 
+    // 参数相同的识别对象在节点之间共享
+    m_recognition = pool ? pool->intern(std::move(recognition)) : std::shared_ptr<const Recognition>(std::move(recognition));
+
     // 解析动作
     ActionType actionType = ActionType::DoNothing;
     nlohmann::json actionConfig;
@@ -61,7 +73,6 @@ bool Node::initialize(const nlohmann::json& config, std::map<std::string, std::s
 
     // 将动作的参数传递给Action类进行解析
     if (m_action) {
-        m_action->setVariableManager(&m_variableManager);
         m_action->parseConfig(actionConfig);
     }
 
@@ -92,6 +103,33 @@ bool Node::initialize(const nlohmann::json& config, std::map<std::string, std::s
         }
     }
 
+    // 解析分叉节点，每个节点作为一个子流程的起点
+    if (config.contains("fork")) {
+        if (config["fork"].is_string()) {
+            m_forkNodes.push_back(config["fork"].get<std::string>());
+        } else if (config["fork"].is_array()) {
+            m_forkNodes = config["fork"].get<std::vector<std::string>>();
+        }
+    }
+
+    // 解析汇合方式，"all"等待全部子流程结束，"race"等待第一个结束的子流程
+    if (config.contains("join")) {
+        const std::string join = config["join"].get<std::string>();
+        if (join == "race") {
+            m_joinMode = JoinMode::Race;
+        } else if (join != "all") {
+            return false;
+        }
+    }
+
+    // 将后继、中断、错误处理和分叉节点名解析为节点ID
+    if (!resolveNodeIds(m_nextNodes, m_nextNodeIds, nodeIds) ||
+        !resolveNodeIds(m_interruptNodes, m_interruptNodeIds, nodeIds) ||
+        !resolveNodeIds(m_onErrorNodes, m_onErrorNodeIds, nodeIds) ||
+        !resolveNodeIds(m_forkNodes, m_forkNodeIds, nodeIds)) {
+        return false;
+    }
+
     // 解析变量定义
     if (config.contains("var")) {
         if (config["var"].is_string()) {
@@ -106,73 +144,22 @@ bool Node::initialize(const nlohmann::json& config, std::map<std::string, std::s
         m_condition = config["condition"].get<std::string>();
     }
 
-    // 解析条件处理
+    // 解析条件处理，两个分支的重写节点都在加载时解析为节点ID
     if (config.contains("condition_process") && config["condition_process"].is_object()) {
-        m_conditionProcess = config["condition_process"];
-
-        // 解析true分支
-        if (m_conditionProcess.contains("true") && m_conditionProcess["true"].is_object()) {
-            const auto& trueObj = m_conditionProcess["true"];
-
-            // 解析override_next
-            if (trueObj.contains("override_next")) {
-                if (trueObj["override_next"].is_string()) {
-                    m_overrideNextNodes.push_back(trueObj["override_next"].get<std::string>());
-                } else if (trueObj["override_next"].is_array()) {
-                    m_overrideNextNodes = trueObj["override_next"].get<std::vector<std::string>>();
-                }
-            }
-
-            // 解析override_interrupt
-            if (trueObj.contains("override_interrupt")) {
-                if (trueObj["override_interrupt"].is_string()) {
-                    m_overrideInterruptNodes.push_back(trueObj["override_interrupt"].get<std::string>());
-                } else if (trueObj["override_interrupt"].is_array()) {
-                    m_overrideInterruptNodes = trueObj["override_interrupt"].get<std::vector<std::string>>();
-                }
-            }
-
-            // 解析var_operation
-            if (trueObj.contains("var_operation")) {
-                m_varOperations["true"] = trueObj["var_operation"].get<std::string>();
-            }
-
-            // 解析condition_log
-            if (trueObj.contains("condition_log")) {
-                m_conditionLogs["true"] = trueObj["condition_log"].get<std::string>();
-            }
-        }
+        const auto& conditionProcess = config["condition_process"];
+        m_hasConditionProcess = true;
 
         // 解析false分支
-        if (m_conditionProcess.contains("false") && m_conditionProcess["false"].is_object()) {
-            const auto& falseObj = m_conditionProcess["false"];
-
-            // 解析override_next
-            if (falseObj.contains("override_next")) {
-                if (falseObj["override_next"].is_string()) {
-                    // 不直接设置，因为只有在条件为false时才会使用
-                } else if (falseObj["override_next"].is_array()) {
-                    // 不直接设置，因为只有在条件为false时才会使用
-                }
-            }
-
-            // 解析override_interrupt
-            if (falseObj.contains("override_interrupt")) {
-                if (falseObj["override_interrupt"].is_string()) {
-                    // 不直接设置，因为只有在条件为false时才会使用
-                } else if (falseObj["override_interrupt"].is_array()) {
-                    // 不直接设置，因为只有在条件为false时才会使用
-                }
-            }
-
-            // 解析var_operation
-            if (falseObj.contains("var_operation")) {
-                m_varOperations["false"] = falseObj["var_operation"].get<std::string>();
+        if (conditionProcess.contains("false") && conditionProcess["false"].is_object()) {
+            if (!parseConditionBranch(conditionProcess["false"], m_conditionBranches[0], nodeIds)) {
+                return false;
             }
+        }
 
-            // 解析condition_log
-            if (falseObj.contains("condition_log")) {
-                m_conditionLogs["false"] = falseObj["condition_log"].get<std::string>();
+        // 解析true分支
+        if (conditionProcess.contains("true") && conditionProcess["true"].is_object()) {
+            if (!parseConditionBranch(conditionProcess["true"], m_conditionBranches[1], nodeIds)) {
+                return false;
             }
         }
     }
@@ -189,27 +176,71 @@ bool Node::initialize(const nlohmann::json& config, std::map<std::string, std::s
         m_enabled = config["enabled"].get<bool>();
     }
 
-    // 解析是否反转
-    if (config.contains("inverse")) {
-        m_inverse = config["inverse"].get<bool>();
-        if (m_recognition) {
-            m_recognition->setInverse(m_inverse);
-        }
-    }
-
     // 解析超时
     if (config.contains("timeout")) {
         m_timeout = config["timeout"].get<uint32_t>();
     }
 
-    // 解析前置延迟
+    // 解析前置延迟，"stable"表示等待画面稳定后立即识别
     if (config.contains("pre_delay")) {
-        m_preDelay = config["pre_delay"].get<uint32_t>();
+        const auto& preDelay = config["pre_delay"];
+        if (preDelay.is_string()) {
+            if (preDelay.get<std::string>() != "stable") {
+                return false;
+            }
+            m_stablePreDelay = true;
+        } else {
+            m_preDelay = preDelay.get<uint32_t>();
+        }
     }
 
-    // 解析后置延迟
+    // 解析后置延迟，"auto"表示按测量的动作延迟自动调整
     if (config.contains("post_delay")) {
-        m_postDelay = config["post_delay"].get<uint32_t>();
+        const auto& postDelay = config["post_delay"];
+        if (postDelay.is_string()) {
+            if (postDelay.get<std::string>() != "auto") {
+                return false;
+            }
+            m_autoPostDelay = true;
+        } else {
+            m_postDelay = postDelay.get<uint32_t>();
+        }
+    }
+    if (m_autoPostDelay) {
+        if (config.contains("post_delay_max")) {
+            m_autoPostDelayConfig.maxDelay = config["post_delay_max"].get<uint32_t>();
+        }
+        if (config.contains("post_delay_percentile")) {
+            m_autoPostDelayConfig.percentile = std::clamp(config["post_delay_percentile"].get<double>(), 0.0, 100.0);
+        }
+        m_postDelay = std::min(m_postDelay, m_autoPostDelayConfig.maxDelay);
+    }
+
+    // 解析画面稳定检测参数，自动后置延迟按同样的方式采样
+    if (m_stablePreDelay || m_autoPostDelay) {
+        if (config.contains("stable_min")) {
+            m_stableWait.minDelay = config["stable_min"].get<uint32_t>();
+        }
+        if (config.contains("stable_max")) {
+            m_stableWait.maxDelay = config["stable_max"].get<uint32_t>();
+        }
+        if (config.contains("stable_frames")) {
+            m_stableWait.frames = config["stable_frames"].get<uint32_t>();
+        }
+        if (config.contains("stable_interval")) {
+            m_stableWait.interval = config["stable_interval"].get<uint32_t>();
+        }
+        if (config.contains("stable_tolerance")) {
+            m_stableWait.tolerance = config["stable_tolerance"].get<double>();
+        }
+        m_stableWait.maxDelay = std::max(m_stableWait.maxDelay, m_stableWait.minDelay);
+        m_stableWait.frames = std::max(m_stableWait.frames, 1u);
+        m_stableWait.interval = std::max(m_stableWait.interval, 1u);
+    }
+
+    // 不能观察画面的调用方（executeRecognition等）按上限等待
+    if (m_stablePreDelay) {
+        m_preDelay = m_stableWait.maxDelay;
     }
 
     // 解析是否关注
@@ -217,10 +248,46 @@ bool Node::initialize(const nlohmann::json& config, std::map<std::string, std::s
         m_focus = config["focus"].get<bool>();
     }
 
+    // 解析是否并行评估后继候选节点
+    if (config.contains("parallel")) {
+        m_parallel = config["parallel"].get<bool>();
+    }
+
+    // 解析推测模式
+    if (config.contains("speculative")) {
+        m_speculative = config["speculative"].get<bool>();
+    }
+
+    // 解析画面稳定时间
+    if (config.contains("settle_time")) {
+        m_settleTime = config["settle_time"].get<uint32_t>();
+    }
+
+    // 解析候选节点的评估顺序，"list"按列表顺序，"adaptive"按命中率和识别耗时调整
+    if (config.contains("order")) {
+        const std::string order = config["order"].get<std::string>();
+        if (order == "adaptive") {
+            m_adaptiveOrder = true;
+        } else if (order != "list") {
+            return false;
+        }
+    }
+
+    // 解析最小评估间隔，max_rate为每秒最多识别的次数，两者同时存在时取较长的间隔
+    if (config.contains("min_interval")) {
+        m_minInterval = config["min_interval"].get<uint32_t>();
+    }
+    if (config.contains("max_rate")) {
+        double maxRate = config["max_rate"].get<double>();
+        if (maxRate > 0.0) {
+            m_minInterval = std::max(m_minInterval, static_cast<uint32_t>(std::ceil(1000.0 / maxRate)));
+        }
+    }
+
     return true;
 }
 
-RecognitionResult Node::executeRecognition() {
+RecognitionResult Node::executeRecognition() const {
     if (!m_enabled || !m_recognition) {
         RecognitionResult result;
         result.success = false;
@@ -236,7 +303,33 @@ RecognitionResult Node::executeRecognition() {
     return m_recognition->recognize();
 }
 
-std::vector<RecognitionResult> Node::executeRecognitionBatch() {
+RecognitionResult Node::recognize(const Frame& frame, const CancellationToken& token, RecognitionCache* cache) const {
+    if (!m_enabled || !m_recognition) {
+        RecognitionResult result;
+        result.success = false;
+        return result;
+    }
+
+    // 无效帧和逻辑帧没有帧源的画面，每次识别由VisionEngine自行截图，可能看到不同的画面，不能缓存
+    if (!cache || !frame.isValid() || frame.epoch == 0) {
+        return m_recognition->recognize(frame, token);
+    }
+
+    const std::string& configKey = m_recognition->getConfigKey();
+    size_t configHash = m_recognition->getConfigHash();
+    if (auto cached = cache->lookup(frame.id, configHash, configKey)) {
+        return *cached;
+    }
+
+    // 在指定帧上执行识别，被取消的识别结果不完整，不缓存
+    RecognitionResult result = m_recognition->recognize(frame, token);
+    if (!token.isCancelled()) {
+        cache->store(frame.id, configHash, configKey, result);
+    }
+    return result;
+}
+
+std::vector<RecognitionResult> Node::executeRecognitionBatch() const {
     std::vector<RecognitionResult> results;
 
     if (!m_enabled || !m_recognition) {
@@ -249,7 +342,7 @@ std::vector<RecognitionResult> Node::executeRecognitionBatch() {
     }
 
     // 检查是否是OCR识别
-    auto ocrRecognition = dynamic_cast<OCRRecognition*>(m_recognition.get());
+    auto ocrRecognition = dynamic_cast<const OCRRecognition*>(m_recognition.get());
     if (ocrRecognition) {
         // 执行批量OCR识别
         return ocrRecognition->recognizeBatch();
@@ -264,13 +357,21 @@ std::vector<RecognitionResult> Node::executeRecognitionBatch() {
     return results;
 }
 
-bool Node::executeAction(const RecognitionResult& result) {
+bool Node::performAction(const RecognitionResult& result, const ActionContext& context) const {
+    if (!m_enabled || !m_action || context.isCancelled()) {
+        return false;
+    }
+
+    return m_action->execute(result, context);
+}
+
+bool Node::executeAction(const RecognitionResult& result) const {
     if (!m_enabled || !m_action) {
         return false;
     }
 
-    // 执行动作
-    bool success = m_action->execute(result);
+    // 执行动作，不属于任何流水线时使用空的上下文
+    bool success = performAction(result, ActionContext{});
 
     // 执行后置延迟
     if (m_postDelay > 0) {
@@ -292,40 +393,10 @@ bool Node::checkCondition(VariableManager& variableManager) const {
 }
 
 // 处理条件过程
-void Node::processCondition(VariableManager& variableManager, bool conditionResult) {
+BranchIndex Node::processCondition(VariableManager& variableManager, bool conditionResult) const {
     // 如果没有条件处理配置，直接返回
-    if (m_conditionProcess.empty()) {
-        return;
-    }
-
-    // 清除之前的重写节点
-    m_overrideNextNodes.clear();
-    m_overrideInterruptNodes.clear();
-
-    // 根据条件结果选择分支
-    std::string branch = conditionResult ? "true" : "false";
-
-    // 如果对应分支存在
-    if (m_conditionProcess.contains(branch) && m_conditionProcess[branch].is_object()) {
-        const auto& branchObj = m_conditionProcess[branch];
-
-        // 处理override_next
-        if (branchObj.contains("override_next")) {
-            if (branchObj["override_next"].is_string()) {
-                m_overrideNextNodes.push_back(branchObj["override_next"].get<std::string>());
-            } else if (branchObj["override_next"].is_array()) {
-                m_overrideNextNodes = branchObj["override_next"].get<std::vector<std::string>>();
-            }
-        }
-
-        // 处理override_interrupt
-        if (branchObj.contains("override_interrupt")) {
-            if (branchObj["override_interrupt"].is_string()) {
-                m_overrideInterruptNodes.push_back(branchObj["override_interrupt"].get<std::string>());
-            } else if (branchObj["override_interrupt"].is_array()) {
-                m_overrideInterruptNodes = branchObj["override_interrupt"].get<std::vector<std::string>>();
-            }
-        }
+    if (!m_hasConditionProcess) {
+        return NoBranch;
     }
 
     // 执行变量操作
@@ -333,43 +404,120 @@ void Node::processCondition(VariableManager& variableManager, bool conditionResu
 
     // 处理条件日志
     processConditionLog(variableManager, conditionResult);
+
+    // 根据条件结果切换分支，分支不存在时清除重写节点
+    BranchIndex branch = conditionResult ? 1 : 0;
+    return m_conditionBranches[branch].present ? branch : NoBranch;
 }
 
 // 处理条件日志
 void Node::processConditionLog(VariableManager& variableManager, bool conditionResult) const {
+    // 根据条件结果选择日志
+    const ConditionBranch& branch = m_conditionBranches[conditionResult ? 1 : 0];
+
     // 如果没有条件日志配置，直接返回
-    if (m_conditionLogs.empty()) {
+    if (branch.conditionLog.empty()) {
         return;
     }
 
-    // 根据条件结果选择日志
-    std::string logKey = conditionResult ? "true" : "false";
-    auto it = m_conditionLogs.find(logKey);
-
-    if (it != m_conditionLogs.end()) {
-        // 处理日志字符串，替换变量并执行操作
-        std::string processedLog = variableManager.processLogString(it->second);
+    // 处理日志字符串，替换变量并执行操作
+    std::string processedLog = variableManager.processLogString(branch.conditionLog);
 
-        // 输出日志
-        std::cout << "[" << m_name << "] Condition " << logKey << ": " << processedLog << std::endl;
-    }
+    // 输出日志
+    std::cout << "[" << m_name << "] Condition " << (conditionResult ? "true" : "false") << ": " << processedLog << std::endl;
 }
 
 // 执行变量操作
 void Node::executeVarOperation(VariableManager& variableManager, bool conditionResult) const {
+    // 根据条件结果选择变量操作
+    const ConditionBranch& branch = m_conditionBranches[conditionResult ? 1 : 0];
+
     // 如果没有变量操作配置，直接返回
-    if (m_varOperations.empty()) {
+    if (branch.varOperation.empty()) {
         return;
     }
 
-    // 根据条件结果选择变量操作
-    std::string opKey = conditionResult ? "true" : "false";
-    auto it = m_varOperations.find(opKey);
+    // 执行变量操作
+    variableManager.processLogString(branch.varOperation);
+}
+
+// 解析分支配置
+bool Node::parseConditionBranch(const nlohmann::json& branchObj, ConditionBranch& branch,
+                                const std::unordered_map<std::string, NodeId>& nodeIds) const {
+    branch.present = true;
+
+    // 解析override_next
+    if (branchObj.contains("override_next")) {
+        if (branchObj["override_next"].is_string()) {
+            branch.overrideNext.push_back(branchObj["override_next"].get<std::string>());
+        } else if (branchObj["override_next"].is_array()) {
+            branch.overrideNext = branchObj["override_next"].get<std::vector<std::string>>();
+        }
+    }
+
+    // 解析override_interrupt
+    if (branchObj.contains("override_interrupt")) {
+        if (branchObj["override_interrupt"].is_string()) {
+            branch.overrideInterrupt.push_back(branchObj["override_interrupt"].get<std::string>());
+        } else if (branchObj["override_interrupt"].is_array()) {
+            branch.overrideInterrupt = branchObj["override_interrupt"].get<std::vector<std::string>>();
+        }
+    }
+
+    // 解析var_operation
+    if (branchObj.contains("var_operation")) {
+        branch.varOperation = branchObj["var_operation"].get<std::string>();
+    }
+
+    // 解析condition_log
+    if (branchObj.contains("condition_log")) {
+        branch.conditionLog = branchObj["condition_log"].get<std::string>();
+    }
+
+    // 将重写节点名解析为节点ID
+    return resolveNodeIds(branch.overrideNext, branch.overrideNextIds, nodeIds) &&
+           resolveNodeIds(branch.overrideInterrupt, branch.overrideInterruptIds, nodeIds);
+}
+
+// 检查引用的节点是否都存在且节点ID没有变化
+bool Node::hasValidReferences(const std::unordered_map<std::string, NodeId>& nodeIds) const {
+    auto matches = [&nodeIds](const std::vector<std::string>& names, const std::vector<NodeId>& ids) {
+        for (size_t i = 0; i < names.size(); ++i) {
+            auto it = nodeIds.find(names[i]);
+            if (it == nodeIds.end() || it->second != ids[i]) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (!matches(m_nextNodes, m_nextNodeIds) || !matches(m_interruptNodes, m_interruptNodeIds) ||
+        !matches(m_onErrorNodes, m_onErrorNodeIds) || !matches(m_forkNodes, m_forkNodeIds)) {
+        return false;
+    }
+    for (const auto& branch : m_conditionBranches) {
+        if (!matches(branch.overrideNext, branch.overrideNextIds) ||
+            !matches(branch.overrideInterrupt, branch.overrideInterruptIds)) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    if (it != m_varOperations.end()) {
-        // 执行变量操作
-        variableManager.processLogString(it->second);
+// 将节点名列表解析为节点ID列表
+bool Node::resolveNodeIds(const std::vector<std::string>& names, std::vector<NodeId>& ids,
+                          const std::unordered_map<std::string, NodeId>& nodeIds) const {
+    ids.clear();
+    ids.reserve(names.size());
+    for (const auto& name : names) {
+        auto it = nodeIds.find(name);
+        if (it == nodeIds.end()) {
+            std::cout << "[" << m_name << "] Unknown node: " << name << std::endl;
+            return false;
+        }
+        ids.push_back(it->second);
     }
+    return true;
 }
 
 // 处理日志
@@ -0,0 +1,128 @@
+#include "Pipeline/ParallelMatch.h"
+#include "Pipeline/Runtime.h"
+#include "Pipeline/WorkerPool.h"
+
+namespace Pipeline {
+
+// 本轮已经结束的标记，不会与协程句柄的地址相同
+static char finishedMarker;
+static void* const Finished = &finishedMarker;
+
+ParallelMatch::ParallelMatch() : m_waiter(Finished) {
+}
+
+ParallelMatch::~ParallelMatch() {
+    // 等待中的协程随流程一起被销毁时取回句柄，最后结束的任务不再恢复它
+    std::unique_lock<std::mutex> lock(m_mutex);
+    void* waiter = m_waiter.load(std::memory_order_acquire);
+    if (waiter != Finished && waiter != nullptr) {
+        m_waiter.compare_exchange_strong(waiter, nullptr, std::memory_order_acq_rel);
+    }
+    m_condition.wait(lock, [this]() { return m_waiter.load(std::memory_order_acquire) == Finished; });
+}
+
+void ParallelMatch::start(WorkerPool& workerPool, Runtime* runtime, CancellationToken& parent, size_t count,
+                          Evaluator evaluator) {
+    m_runtime = runtime;
+    m_parent = &parent;
+    m_evaluator = std::move(evaluator);
+    m_count = count;
+    m_best.store(count, std::memory_order_relaxed);
+    m_skipped.store(0, std::memory_order_relaxed);
+
+    // 令牌只增不减，每轮重置本轮用到的部分
+    while (m_tokens.size() < count) {
+        m_tokens.emplace_back();
+    }
+    for (size_t i = 0; i < count; ++i) {
+        m_tokens[i].reset();
+    }
+
+    if (count == 0) {
+        m_parentCallback = 0;
+        m_waiter.store(Finished, std::memory_order_release);
+        return;
+    }
+    m_remaining.store(count, std::memory_order_relaxed);
+    m_waiter.store(nullptr, std::memory_order_release);
+
+    // 上级令牌被取消（停止、暂停）时取消所有项，已经取消时立即取消，所有项都会跳过
+    m_parentCallback = parent.registerCallback([this]() { cancelFrom(0); });
+
+    // 任务只捕获两个值，不分配内存
+    for (size_t i = 0; i < count; ++i) {
+        workerPool.post([this, i]() { run(i); });
+    }
+}
+
+void ParallelMatch::run(size_t index) {
+    const CancellationToken& token = m_tokens[index];
+
+    // 优先级更高的项已经命中或上级已经取消，尚未开始的项直接跳过
+    if (token.isCancelled()) {
+        m_skipped.fetch_add(1, std::memory_order_acq_rel);
+        finishOne();
+        return;
+    }
+
+    // 评估期间被取消的结果不完整，不采用
+    if (m_evaluator(index, token) && !token.isCancelled()) {
+        // 记录命中的最高优先级下标，并取消优先级更低的项
+        size_t current = m_best.load(std::memory_order_acquire);
+        while (index < current && !m_best.compare_exchange_weak(current, index, std::memory_order_acq_rel)) {
+        }
+        if (index < current) {
+            cancelFrom(index + 1);
+        }
+    }
+    finishOne();
+}
+
+void ParallelMatch::finishOne() {
+    if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    // 标记本轮结束后协程可能随时恢复并销毁本对象，之后只使用局部变量
+    Runtime* runtime = m_runtime;
+    void* waiter;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        waiter = m_waiter.exchange(Finished, std::memory_order_acq_rel);
+        m_condition.notify_all();
+    }
+    if (waiter && runtime) {
+        runtime->post(std::coroutine_handle<>::from_address(waiter));
+    }
+}
+
+void ParallelMatch::cancelFrom(size_t first) {
+    for (size_t i = first; i < m_count; ++i) {
+        m_tokens[i].cancel();
+    }
+}
+
+bool ParallelMatch::Awaiter::await_ready() const {
+    // 没有运行时时只能阻塞等待
+    if (!match->m_runtime) {
+        std::unique_lock<std::mutex> lock(match->m_mutex);
+        match->m_condition.wait(lock, [this]() { return match->m_waiter.load(std::memory_order_acquire) == Finished; });
+        return true;
+    }
+    return match->m_waiter.load(std::memory_order_acquire) == Finished;
+}
+
+bool ParallelMatch::Awaiter::await_suspend(std::coroutine_handle<> handle) const {
+    // 保存句柄失败说明最后一个任务已经结束，直接继续执行
+    void* expected = nullptr;
+    return match->m_waiter.compare_exchange_strong(expected, handle.address(), std::memory_order_acq_rel);
+}
+
+size_t ParallelMatch::Awaiter::await_resume() const {
+    // 回调正在执行时等待它结束，之后上级令牌不再访问本对象
+    match->m_parent->unregisterCallback(match->m_parentCallback);
+    match->m_parentCallback = 0;
+    return match->m_best.load(std::memory_order_acquire);
+}
+
+} // namespace Pipeline
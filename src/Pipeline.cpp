@@ -1,30 +1,88 @@
 #include "Pipeline/Pipeline.h"
+#include "Pipeline/ParallelMatch.h"
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <sstream>
 #include <chrono>
 #include <thread>
+#include <algorithm>
+#include <atomic>
+#include <utility>
 
 namespace Pipeline {
 
-// 初始化静态实例
-Pipeline* Pipeline::s_instance = nullptr;
+Pipeline::Pipeline()
+    : m_cancellationToken(std::make_shared<CancellationToken>()),
+      m_mainToken(std::make_shared<CancellationToken>()),
+      m_recognitionCache(std::make_shared<RecognitionCache>()),
+      m_candidateScheduler(std::make_shared<CandidateScheduler>()) {
+    // 停止和暂停时同时取消主流程，回调被调用后在重置主流程令牌时重新注册
+    linkToken(*m_cancellationToken, m_mainToken, m_mainCallbackId);
+}
 
-Pipeline::Pipeline() : m_state(PipelineState::Stopped) {
-    // 设置当前实例
-    s_instance = this;
+Pipeline::Pipeline(std::shared_ptr<const PipelineDefinition> definition) : Pipeline() {
+    setDefinition(std::move(definition));
 }
 
 Pipeline::~Pipeline() {
     stop();
+    joinWatchdog();
+}
+
+bool Pipeline::loadFromFile(const std::string& filePath) {
+    return setDefinition(PipelineDefinition::loadFromFile(filePath));
+}
+
+bool Pipeline::loadFromString(const std::string& jsonString) {
+    return setDefinition(PipelineDefinition::loadFromString(jsonString));
+}
+
+bool Pipeline::setDefinition(std::shared_ptr<const PipelineDefinition> definition) {
+    std::lock_guard<std::mutex> lock(m_reloadMutex);
+    m_pendingDefinition.reset();
+    m_candidateScheduler->clear();
+
+    // 新定义的节点ID可能不同，转移模型和动作延迟模型按节点名迁移
+    nlohmann::json transitions = transitionsToJson();
+    nlohmann::json latencies = latenciesToJson();
+    m_transitionModel.clear();
+    m_latencyModel.clear();
+
+    // 加载失败时清空现有节点
+    swapDefinition(definition);
+    addTransitions(transitions);
+    addLatencies(latencies);
+    {
+        std::lock_guard<std::mutex> graphLock(m_graphMutex);
+        m_activeBranches.clear();
+    }
+    if (!definition) {
+        return false;
+    }
+
+    // 初始化全局变量
+    const auto& globalVariables = definition->getGlobalVariables();
+    if (!globalVariables.empty() && !m_variableManager.parseVariableList(globalVariables)) {
+        swapDefinition(nullptr);
+        return false;
+    }
 
-    // 清除当前实例
-    if (s_instance == this) {
-        s_instance = nullptr;
+    // 初始化节点变量
+    for (NodeId id = 0; id < definition->getNodeTableSize(); ++id) {
+        if (const Node* node = definition->getNodeById(id)) {
+            initializeNodeVariables(*node);
+        }
     }
+
+    return true;
 }
 
-bool Pipeline::loadFromFile(const std::string& filePath) {
+std::shared_ptr<const PipelineDefinition> Pipeline::getDefinition() const {
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    return m_definition;
+}
+
+bool Pipeline::reloadFromFile(const std::string& filePath) {
     try {
         // 打开文件
         std::ifstream file(filePath);
@@ -39,382 +97,1798 @@ bool Pipeline::loadFromFile(const std::string& filePath) {
 
         // 解析JSON
         nlohmann::json json = nlohmann::json::parse(buffer.str());
-        return parseJson(json);
+        return reload(json);
     } catch (const std::exception& e) {
         // 处理异常
         return false;
     }
 }
 
-bool Pipeline::loadFromString(const std::string& jsonString) {
+bool Pipeline::reloadFromString(const std::string& jsonString) {
     try {
         // 解析JSON
         nlohmann::json json = nlohmann::json::parse(jsonString);
-        return parseJson(json);
+        return reload(json);
     } catch (const std::exception& e) {
         // 处理异常
         return false;
     }
 }
 
-std::shared_ptr<Node> Pipeline::getNode(const std::string& name) const {
-    auto it = m_nodes.find(name);
-    if (it != m_nodes.end()) {
-        return it->second;
+bool Pipeline::hasPendingReload() const {
+    std::lock_guard<std::mutex> lock(m_reloadMutex);
+    return m_pendingDefinition != nullptr;
+}
+
+std::shared_ptr<const Node> Pipeline::getNode(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    return m_definition ? m_definition->getNode(name) : nullptr;
+}
+
+NodeId Pipeline::getNodeId(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    return m_definition ? m_definition->getNodeId(name) : InvalidNodeId;
+}
+
+size_t Pipeline::getNodeCount() const {
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    return m_definition ? m_definition->getNodeCount() : 0;
+}
+
+size_t Pipeline::getRecognitionCount() const {
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    return m_definition ? m_definition->getRecognitionCount() : 0;
+}
+
+std::string Pipeline::getNodeName(NodeId id) const {
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    const Node* node = getNodeById(id);
+    return node ? node->getName() : "";
+}
+
+std::string Pipeline::getCurrentNodeName() const {
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    const Node* node = getNodeById(m_currentNodeId.load());
+    return node ? node->getName() : "";
+}
+
+std::vector<EdgeStats> Pipeline::getEdgeStats(const std::string& nodeName) const {
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    const Node* node = m_definition ? getNodeById(m_definition->getNodeId(nodeName)) : nullptr;
+    if (!node) {
+        return {};
+    }
+
+    // 按下一轮的评估顺序返回
+    BranchIndex branch = getBranchLocked(node->getId());
+    std::vector<NodeId> nextNodes = node->getNextNodeIds(branch);
+    std::vector<NodeId> interruptNodes = node->getInterruptNodeIds(branch);
+    if (node->isAdaptiveOrder()) {
+        m_candidateScheduler->order(node->getId(), nextNodes);
+        m_candidateScheduler->order(node->getId(), interruptNodes);
     }
-    return nullptr;
+
+    auto stats = m_candidateScheduler->getStats(node->getId(), nextNodes);
+    auto interruptStats = m_candidateScheduler->getStats(node->getId(), interruptNodes);
+    stats.insert(stats.end(), interruptStats.begin(), interruptStats.end());
+    return stats;
+}
+
+BranchIndex Pipeline::getActiveBranch(NodeId id) const {
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    return getBranchLocked(id);
+}
+
+BranchIndex Pipeline::getBranchLocked(NodeId id) const {
+    auto it = m_activeBranches.find(id);
+    return it != m_activeBranches.end() ? it->second : NoBranch;
 }
 
 Task Pipeline::execute(const std::string& startNodeName) {
-    // 使用协程实现流水线执行
-    auto executeTask = [this](const std::string& nodeName) -> Task {
-        // 设置状态为运行中
-        m_state = PipelineState::Running;
+    Progress progress;
+    progress.nodeId = getNodeId(startNodeName);
+    prepareRun(progress);
+    return run(progress.nodeId);
+}
 
-        // 设置当前节点
-        setCurrentNode(nodeName);
+std::optional<Checkpoint> Pipeline::checkpoint() const {
+    if (getState() == PipelineState::Stopped) {
+        return std::nullopt;
+    }
 
-        // 检查节点是否存在
-        if (!m_currentNode) {
-            m_state = PipelineState::Stopped;
-            co_return;
+    // 主流程在持有变量锁时更新执行阶段，按同样的顺序加锁，变量与执行位置保持一致
+    auto variableLock = m_variableManager.lock();
+    Progress progress;
+    {
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+        progress = m_progress;
+    }
+
+    Checkpoint checkpoint;
+    {
+        std::lock_guard<std::mutex> lock(m_graphMutex);
+        const Node* node = getNodeById(progress.nodeId);
+        if (!node) {
+            return std::nullopt;
+        }
+        checkpoint.nodeName = node->getName();
+        for (const auto& [id, branch] : m_activeBranches) {
+            if (const Node* branchNode = getNodeById(id)) {
+                checkpoint.branches.emplace_back(branchNode->getName(), branch);
+            }
         }
+    }
+    std::sort(checkpoint.branches.begin(), checkpoint.branches.end());
 
-        // 初始化节点变量
-        initializeNodeVariables(m_currentNode);
+    checkpoint.phase = progress.phase;
+    checkpoint.actionSuccess = progress.actionSuccess;
+    if (progress.phase == CheckpointPhase::PostAction || progress.phase == CheckpointPhase::Waiting) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(progress.deadline - currentTime());
+        checkpoint.remaining = static_cast<uint32_t>(std::max<int64_t>(remaining.count(), 0));
+    }
+    checkpoint.variables = m_variableManager.getVariables();
+    return checkpoint;
+}
 
-        // 执行流水线
-        while (m_state == PipelineState::Running && m_currentNode) {
-            // 检查节点是否启用
-            if (!m_currentNode->isEnabled()) {
-                m_state = PipelineState::Stopped;
-                co_return;
+Task Pipeline::restore(const Checkpoint& checkpoint) {
+    NodeId nodeId = InvalidNodeId;
+    {
+        std::lock_guard<std::mutex> lock(m_graphMutex);
+        if (m_definition) {
+            nodeId = m_definition->getNodeId(checkpoint.nodeName);
+
+            // 当前定义中不存在的节点的分支被忽略
+            m_activeBranches.clear();
+            for (const auto& [name, branch] : checkpoint.branches) {
+                NodeId id = m_definition->getNodeId(name);
+                if (id != InvalidNodeId) {
+                    m_activeBranches[id] = branch;
+                }
+            }
+        }
+    }
+    m_variableManager.restoreVariables(checkpoint.variables);
+
+    ResumePoint resume;
+    resume.phase = checkpoint.phase;
+    resume.remaining = std::chrono::milliseconds(checkpoint.remaining);
+    resume.actionSuccess = checkpoint.actionSuccess;
+
+    // 协程开始执行之前生成的检查点与恢复的检查点相同
+    Progress progress;
+    progress.nodeId = nodeId;
+    progress.phase = checkpoint.phase;
+    progress.deadline = currentTime() + resume.remaining;
+    progress.actionSuccess = checkpoint.actionSuccess;
+    prepareRun(progress);
+    return run(nodeId, nullptr, resume);
+}
+
+void Pipeline::prepareRun(const Progress& progress) {
+    // 上次执行的看门狗在主流程结束后退出，等待它释放后再开始新的执行
+    joinWatchdog();
+    {
+        std::lock_guard<std::mutex> lock(m_preemptionMutex);
+        m_preemption.reset();
+        m_preempted = false;
+    }
+
+    // 先记录起始的执行位置，状态切换为运行中之后即可生成检查点
+    {
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+        m_progress = progress;
+    }
+
+    // 设置状态为运行中，在协程开始执行前调用stop()同样有效
+    // 先重置令牌再切换状态，保证运行状态下令牌一定未被取消
+    m_cancellationToken->reset();
+    {
+        std::lock_guard<std::mutex> lock(m_linkMutex);
+        m_mainToken->reset();
+        linkToken(*m_cancellationToken, m_mainToken, m_mainCallbackId);
+    }
+    m_state = PipelineState::Running;
+
+    // 丢弃上次执行缓存的识别结果
+    m_recognitionCache->clear();
+    m_candidateScheduler->clearSamples();
+}
+
+// 一个流程的并行评估状态，在多轮评估之间复用
+// 所有识别任务结束后协程才恢复，任务可以直接使用节点、帧和缓存的裸指针
+struct Pipeline::ParallelEvaluation {
+    ParallelMatch match;
+    std::vector<const Node*> nodes;                 // 按优先级排列的启用的候选节点
+    std::vector<RecognitionResult> results;         // 各候选节点的识别结果，只增不减
+    const Frame* frame = nullptr;                   // 本轮评估的帧，位于等待中的协程帧中
+    RecognitionCache* cache = nullptr;
+    CandidateScheduler* scheduler = nullptr;
+    std::shared_ptr<Clock> clock;
+    NodeId source = InvalidNodeId;
+};
+
+// 分叉节点启动的一组子流程
+// 子流程共享一个取消令牌，上级流程的令牌被取消（停止或暂停）或分叉组有了结果时被取消
+struct Pipeline::ForkGroup {
+    JoinMode joinMode = JoinMode::All;
+    std::shared_ptr<CancellationToken> token = std::make_shared<CancellationToken>(); // 子流程共享的取消令牌
+    std::shared_ptr<CancellationToken> parentToken;     // 上级流程的取消令牌
+    std::shared_ptr<ForkGroup> parent;                  // 上级流程所属的分叉组，上级为主流程时为空
+    CancellationToken::CallbackId callbackId = 0;       // 注册在上级令牌上的回调
+    std::vector<Task> tasks;                            // 子流程的协程
+    std::atomic<size_t> remaining{0};                   // 尚未结束的子流程数量
+    std::atomic<bool> decided{false};                   // 结果是否已经确定，确定后其余子流程退出
+    std::atomic<bool> succeeded{false};                 // 确定的结果
+    std::atomic<void*> waiter{nullptr};                 // 等待汇合的上级协程
+    Runtime* runtime = nullptr;
+    bool watchdog = false;                              // 是否为看门狗协程，主流程被抢占时不退出
+
+    // 确定分叉组的结果并取消其余子流程，已有结果时返回false
+    bool decide(bool success) {
+        if (decided.exchange(true)) {
+            return false;
+        }
+        succeeded = success;
+        token->cancel();
+        return true;
+    }
+
+    // 分叉组或任一上级分叉组已经有了结果
+    bool isDecided() const {
+        for (const ForkGroup* group = this; group; group = group->parent.get()) {
+            if (group->decided) {
+                return true;
             }
+        }
+        return false;
+    }
+};
+
+// 使用协程实现流水线执行
+// 协程创建后处于挂起状态，成员协程在帧中保存this，可以安全地在其他线程上恢复
+// 主流程和子流程执行同一段逻辑，区别只在于流程结束时的处理
+Task Pipeline::run(NodeId startNodeId, std::shared_ptr<ForkGroup> group, std::optional<ResumePoint> resume) {
+    // 流程的运行状态保存在协程帧中
+    Flow flow;
+    flow.group = std::move(group);
+    flow.resume = resume;
+    flow.token = flow.group ? flow.group->token : m_mainToken;
+    flow.actionContext.variables = &m_variableManager;
+    flow.actionContext.pipeline = this;
+    flow.actionContext.token = flow.token.get();
+    flow.actionContext.clock = m_runtime ? m_runtime->getClock().get() : nullptr;
+
+    // 子流程在分叉节点的动作之后启动，同样只接受此后采集的帧
+    // 从检查点恢复时之前的帧同样已经过时
+    if (flow.group || flow.resume) {
+        flow.actionEndTime = currentTime();
+    }
+
+    // 协程以任何方式结束时，局部对象在协程结束前析构，由它通知流程结束
+    struct FlowExit {
+        Pipeline* pipeline;
+        Flow* flow;
+        ~FlowExit() { pipeline->finishFlow(*flow); }
+    } flowExit{this, &flow};
+
+    // 丢弃上次执行遗留的继续标记
+    finishResume();
+
+    // 设置当前节点
+    setCurrentNode(flow, startNodeId);
+
+    // 检查节点是否存在
+    if (!flow.currentNode) {
+        co_return;
+    }
+
+    // 初始化节点变量，从检查点恢复时变量已经是保存时的值
+    if (!flow.resume) {
+        initializeNodeVariables(*flow.currentNode);
+    }
+
+    // 主流程启动看门狗，子流程与主流程共享
+    if (!flow.group) {
+        startWatchdog();
+    }
+
+    // 执行流水线，暂停时在暂停点挂起，不会退出循环
+    while (isFlowActive(flow) && flow.currentNode) {
+        const Node* currentNode = flow.currentNode;
+
+        // 检查节点是否启用
+        if (!currentNode->isEnabled()) {
+            co_return;
+        }
+
+        // 从检查点恢复时，第一个节点跳过保存时已经完成的部分
+        std::optional<ResumePoint> resumePoint = std::exchange(flow.resume, std::nullopt);
+        CheckpointPhase resumePhase = resumePoint ? resumePoint->phase : CheckpointPhase::Enter;
+        bool resumeAfterAction = resumePhase == CheckpointPhase::PostAction || resumePhase == CheckpointPhase::Waiting;
+        bool resumeWaiting = resumePhase == CheckpointPhase::Waiting;
+
+        BranchIndex branch = NoBranch;
+        if (resumePhase != CheckpointPhase::Enter) {
+            // 条件处理已经执行过，使用检查点中保存的分支
+            std::lock_guard<std::mutex> lock(m_graphMutex);
+            branch = getBranchLocked(currentNode->getId());
+        } else {
+            // 条件判断和条件处理中的变量操作作为一个整体执行，其他子流程不会在两者之间修改变量
+            // 生效的分支和执行阶段在同一个锁内更新，检查点不会看到只完成一半的条件处理
+            auto variableLock = m_variableManager.lock();
 
             // 检查条件是否满足
-            bool conditionResult = m_currentNode->checkCondition(m_variableManager);
+            bool conditionResult = currentNode->checkCondition(m_variableManager);
 
-            // 处理条件过程
-            m_currentNode->processCondition(m_variableManager, conditionResult);
+            // 处理条件过程，生效的分支保存在本实例中
+            // 分叉出的子流程可能同时读写生效的分支
+            branch = currentNode->processCondition(m_variableManager, conditionResult);
+            {
+                std::lock_guard<std::mutex> lock(m_graphMutex);
+                if (branch == NoBranch) {
+                    m_activeBranches.erase(currentNode->getId());
+                } else {
+                    m_activeBranches[currentNode->getId()] = branch;
+                }
+            }
 
             if (!conditionResult) {
                 // 如果条件不满足，尝试执行中断节点
-                const auto& interruptNodes = m_currentNode->getInterruptNodes(); // 这里已经是可能被重写后的节点列表
+                const auto& interruptNodes = currentNode->getInterruptNodeIds(branch); // 这里已经是可能被重写后的节点列表
                 if (!interruptNodes.empty()) {
-                    setCurrentNode(interruptNodes[0]);
+                    setCurrentNode(flow, interruptNodes[0]);
                     continue;
                 } else {
                     // 如果没有中断节点，跳过当前节点
-                    const auto& nextNodes = m_currentNode->getNextNodes(); // 这里已经是可能被重写后的节点列表
+                    const auto& nextNodes = currentNode->getNextNodeIds(branch); // 这里已经是可能被重写后的节点列表
                     if (!nextNodes.empty()) {
-                        setCurrentNode(nextNodes[0]);
+                        setCurrentNode(flow, nextNodes[0]);
                         continue;
                     } else {
-                        m_state = PipelineState::Stopped;
+                        flow.succeeded = true;
                         co_return;
                     }
                 }
             }
+            setProgress(flow, CheckpointPhase::Recognize);
+        }
 
-            // 执行节点的识别
-            auto result = m_currentNode->executeRecognition();
-
-            // 如果识别成功，执行动作
-            if (result) {
-                bool actionSuccess = m_currentNode->executeAction(result);
-
-                // 处理日志
-                m_currentNode->processLog(m_variableManager, actionSuccess);
+        // 执行节点的识别，如果该节点已在候选评估中命中，直接使用命中时的结果
+        // 从检查点恢复到动作之后时不再识别
+        RecognitionResult result;
+        if (flow.pendingResult) {
+            result = std::move(*flow.pendingResult);
+            flow.pendingResult.reset();
+        } else if (!resumeAfterAction) {
+            while (true) {
+                // 等待前置延迟，期间工作线程可以执行其他协程，停止或暂停时立即结束等待
+                // 暂停打断的等待在恢复后补足剩余的时间
+                auto preDelayEnd = currentTime() + std::chrono::milliseconds(currentNode->getPreDelay());
+                while (true) {
+                    co_await DelayAwaiter(m_runtime, preDelayEnd, flow.token.get());
+                    auto remaining = preDelayEnd - currentTime();
+                    if (!co_await suspendPoint(flow)) {
+                        co_return;
+                    }
+                    if (flow.currentNode != currentNode || remaining <= std::chrono::steady_clock::duration::zero()) {
+                        break;
+                    }
+                    preDelayEnd = currentTime() + remaining;
+                }
+                if (flow.currentNode != currentNode) {
+                    break;
+                }
 
-                if (!actionSuccess) {
-                    // 如果动作执行失败，尝试执行错误处理节点
-                    const auto& onErrorNodes = m_currentNode->getOnErrorNodes();
-                    if (!onErrorNodes.empty()) {
-                        setCurrentNode(onErrorNodes[0]);
-                        continue;
-                    } else {
-                        m_state = PipelineState::Stopped;
+                // 动作结束之前采集的帧已经过时，等待帧源产生新帧，超过节点的超时时间仍没有新帧时识别失败
+                Frame frame = captureFrame();
+                auto freshDeadline = currentTime() + std::chrono::milliseconds(currentNode->getTimeout());
+                while (frame.captureTime < flow.actionEndTime && currentTime() < freshDeadline) {
+                    co_await waitForNextFrame(frame, flow.token.get(), freshDeadline);
+                    if (!co_await suspendPoint(flow)) {
                         co_return;
                     }
+                    if (flow.currentNode != currentNode) {
+                        break;
+                    }
+                    frame = captureFrame();
+                }
+                if (flow.currentNode != currentNode) {
+                    break;
                 }
 
-                // 获取后继节点
-                const auto& nextNodes = m_currentNode->getNextNodes();
-                if (nextNodes.empty()) {
-                    // 如果没有后继节点，任务完成
-                    m_state = PipelineState::Stopped;
+                result = frame.captureTime < flow.actionEndTime
+                             ? RecognitionResult{}
+                             : currentNode->recognize(frame, *flow.token, m_recognitionCache.get());
+
+                // 识别被暂停打断时，恢复后重新识别
+                if (!flow.token->isCancelled()) {
+                    break;
+                }
+                if (!co_await suspendPoint(flow)) {
                     co_return;
                 }
 
-                // 尝试识别后继节点
-                bool foundNext = false;
-                for (const auto& nextNodeName : nextNodes) {
-                    auto nextNode = getNode(nextNodeName);
-                    if (nextNode && nextNode->isEnabled()) {
-                        auto nextResult = nextNode->executeRecognition();
-                        if (nextResult) {
-                            // 找到匹配的后继节点，切换到该节点
-                            setCurrentNode(nextNode);
-                            foundNext = true;
-                            break;
-                        }
-                    }
+                // 被看门狗抢占时不再识别当前节点
+                if (flow.currentNode != currentNode) {
+                    break;
                 }
+            }
 
-                // 如果没有找到匹配的后继节点，尝试中断节点
-                if (!foundNext) {
-                    const auto& interruptNodes = m_currentNode->getInterruptNodes();
-                    if (!interruptNodes.empty()) {
-                        for (const auto& interruptNodeName : interruptNodes) {
-                            auto interruptNode = getNode(interruptNodeName);
-                            if (interruptNode && interruptNode->isEnabled()) {
-                                auto interruptResult = interruptNode->executeRecognition();
-                                if (interruptResult) {
-                                    // 找到匹配的中断节点，切换到该节点
-                                    setCurrentNode(interruptNode);
-                                    foundNext = true;
-                                    break;
-                                }
-                            }
-                        }
+            // 转到命中的看门狗节点
+            if (flow.currentNode != currentNode) {
+                continue;
+            }
+        }
+
+        // 如果识别成功，执行动作
+        if (result || resumeAfterAction) {
+            // 推测模式下不等待完整的后置延迟，画面稳定后立即开始评估后继候选节点
+            // 之后只接受稳定时间点之后采集的帧，命中即提交
+            bool speculative = currentNode->isSpeculative();
+            uint32_t postDelay = getEffectivePostDelay(*currentNode);
+            if (speculative) {
+                postDelay = std::min(currentNode->getSettleTime(), postDelay);
+            }
+
+            bool actionSuccess = true;
+            bool actionInterrupted = false;
+            if (resumeAfterAction) {
+                // 从检查点恢复时动作已经执行，只等待剩余的后置延迟
+                actionSuccess = resumePoint->actionSuccess;
+                postDelay = resumeWaiting ? 0 : static_cast<uint32_t>(resumePoint->remaining.count());
+            } else {
+                // 动作执行期间预热最可能的后继节点
+                prefetchSuccessors(currentNode->getId(), flow.predicted);
+
+                actionSuccess = currentNode->performAction(result, flow.actionContext);
+                flow.actionEndTime = currentTime();
+
+                // 动作被打断时，停止则直接退出；暂停则在恢复后继续后续流程，不重新执行动作
+                actionInterrupted = flow.token->isCancelled();
+                setProgress(flow, CheckpointPhase::PostAction, flow.actionEndTime + std::chrono::milliseconds(postDelay),
+                            actionSuccess || actionInterrupted);
+                if (actionInterrupted) {
+                    if (!co_await suspendPoint(flow)) {
+                        co_return;
                     }
+                    actionSuccess = true;
                 }
+            }
+            auto settleTime = flow.actionEndTime + std::chrono::milliseconds(currentNode->getSettleTime());
 
-                // 如果仍然没有找到匹配的节点，等待一段时间后重试
-                if (!foundNext) {
-                    // 检查是否超时
-                    auto startTime = std::chrono::steady_clock::now();
-                    while (!foundNext && m_state == PipelineState::Running) {
-                        // 等待一段时间
-                        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-                        // 如果状态变为暂停，则暂停执行
-                        if (m_state == PipelineState::Suspended) {
-                            // 保存当前等待器，以便稍后恢复
-                            m_awaiter = co_await TaskAwaiter{};
-
-                            // 检查是否已经停止
-                            if (m_state == PipelineState::Stopped) {
-                                co_return;
-                            }
-                        }
+            // 自动后置延迟在样本不足或需要重新测量时观察画面，画面稳定后结束等待并记录动作延迟
+            bool measureLatency = !speculative && !actionInterrupted && !resumeAfterAction && currentNode->isAutoPostDelay() &&
+                                  m_frameSource && m_latencyModel.shouldMeasure(currentNode->getId());
+            if (measureLatency) {
+                const StableWait& sampling = currentNode->getStableWait();
+                uint32_t maxDelay = currentNode->getAutoPostDelay().maxDelay;
+                auto measureDeadline = flow.actionEndTime + std::chrono::milliseconds(maxDelay);
+                Frame previous = captureFrame();
+                std::optional<std::chrono::steady_clock::time_point> firstChange;
+                auto lastChange = flow.actionEndTime;
+                uint32_t unchanged = 0;
+                bool measured = true;
+                while (unchanged < sampling.frames && currentTime() < measureDeadline) {
+                    auto sampleDeadline = std::min(currentTime() + std::chrono::milliseconds(sampling.interval),
+                                                   measureDeadline);
+                    co_await waitForNextFrame(previous, flow.token.get(), sampleDeadline);
 
-                        // 重新尝试识别后继节点
-                        for (const auto& nextNodeName : nextNodes) {
-                            auto nextNode = getNode(nextNodeName);
-                            if (nextNode && nextNode->isEnabled()) {
-                                auto nextResult = nextNode->executeRecognition();
-                                if (nextResult) {
-                                    // 找到匹配的后继节点，切换到该节点
-                                    setCurrentNode(nextNode);
-                                    foundNext = true;
-                                    break;
-                                }
-                            }
-                        }
+                    // 暂停或被看门狗抢占时测量结果不可信，不记录
+                    if (flow.token->isCancelled()) {
+                        measured = false;
+                    }
+                    if (!co_await suspendPoint(flow)) {
+                        co_return;
+                    }
+                    if (flow.currentNode != currentNode) {
+                        measured = false;
+                        break;
+                    }
 
-                        // 如果仍然没有找到匹配的后继节点，尝试中断节点
-                        if (!foundNext) {
-                            const auto& interruptNodes = m_currentNode->getInterruptNodes();
-                            if (!interruptNodes.empty()) {
-                                for (const auto& interruptNodeName : interruptNodes) {
-                                    auto interruptNode = getNode(interruptNodeName);
-                                    if (interruptNode && interruptNode->isEnabled()) {
-                                        auto interruptResult = interruptNode->executeRecognition();
-                                        if (interruptResult) {
-                                            // 找到匹配的中断节点，切换到该节点
-                                            setCurrentNode(interruptNode);
-                                            foundNext = true;
-                                            break;
-                                        }
-                                    }
-                                }
-                            }
+                    Frame current = captureFrame();
+                    if (isFrameStable(previous, current, std::nullopt, sampling.tolerance)) {
+                        ++unchanged;
+                    } else {
+                        unchanged = 0;
+                        if (!firstChange) {
+                            firstChange = current.captureTime;
                         }
+                        lastChange = current.captureTime;
+                    }
+                    previous = std::move(current);
+                }
 
-                        // 检查是否超时
-                        auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-                            std::chrono::steady_clock::now() - startTime).count();
-                        if (elapsedTime > m_currentNode->getTimeout()) {
-                            // 超时，尝试执行错误处理节点
-                            const auto& onErrorNodes = m_currentNode->getOnErrorNodes();
-                            if (!onErrorNodes.empty()) {
-                                setCurrentNode(onErrorNodes[0]);
-                                foundNext = true;
-                                break;
-                            } else {
-                                // 如果没有错误处理节点，任务失败
-                                m_state = PipelineState::Stopped;
-                                co_return;
-                            }
-                        }
+                // 到达上限时画面仍在变化，按上限记录
+                if (measured) {
+                    auto sinceAction = [&flow](std::chrono::steady_clock::time_point time) {
+                        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(time - flow.actionEndTime).count();
+                        return static_cast<uint32_t>(std::max<int64_t>(elapsed, 0));
+                    };
+                    LatencySample sample;
+                    sample.start = firstChange ? sinceAction(*firstChange) : 0;
+                    sample.settle = unchanged >= sampling.frames ? sinceAction(lastChange) : maxDelay;
+                    m_latencyModel.record(currentNode->getId(), sample);
+                }
+            } else if (!resumeWaiting) {
+                // 等待后置延迟，推测模式下只等待画面稳定时间
+                // 暂停打断的等待在恢复后补足剩余的时间，检查点按新的结束时间计算剩余的后置延迟
+                auto postDelayEnd = currentTime() + std::chrono::milliseconds(postDelay);
+                while (true) {
+                    co_await DelayAwaiter(m_runtime, postDelayEnd, flow.token.get());
+                    auto remaining = postDelayEnd - currentTime();
+                    if (!co_await suspendPoint(flow)) {
+                        co_return;
                     }
+                    if (flow.currentNode != currentNode || remaining <= std::chrono::steady_clock::duration::zero()) {
+                        break;
+                    }
+                    postDelayEnd = currentTime() + remaining;
+                    setProgress(flow, CheckpointPhase::PostAction, postDelayEnd, actionSuccess);
                 }
+            }
+
+            // 处理日志，从检查点恢复到等待后继节点时已经处理过
+            if (!resumeWaiting) {
+                currentNode->processLog(m_variableManager, actionSuccess);
+            }
 
-                // 如果没有找到下一个节点，任务完成
-                if (!foundNext) {
-                    m_state = PipelineState::Stopped;
+            // 动作或后置延迟期间被看门狗抢占时，转到看门狗节点
+            if (flow.currentNode != currentNode) {
+                continue;
+            }
+
+            // 分叉节点启动子流程，按汇合方式等待子流程结束，分叉失败与动作失败同样处理
+            // 从检查点恢复到等待后继节点时分叉已经成功结束
+            if (actionSuccess && !resumeWaiting && !currentNode->getForkNodeIds().empty()) {
+                auto forkGroup = startFork(flow);
+                if (forkGroup) {
+                    co_await JoinAwaiter{forkGroup.get()};
+                }
+                actionSuccess = forkGroup && finishFork(*forkGroup);
+                if (!co_await suspendPoint(flow)) {
                     co_return;
                 }
-            } else {
-                // 如果识别失败，尝试执行错误处理节点
-                const auto& onErrorNodes = m_currentNode->getOnErrorNodes();
+
+                // 被看门狗抢占时子流程已经退出，不再处理分叉的结果
+                if (flow.currentNode != currentNode) {
+                    continue;
+                }
+            }
+
+            if (!actionSuccess) {
+                // 如果动作执行失败，尝试执行错误处理节点
+                const auto& onErrorNodes = currentNode->getOnErrorNodeIds();
                 if (!onErrorNodes.empty()) {
-                    setCurrentNode(onErrorNodes[0]);
+                    setCurrentNode(flow, onErrorNodes[0]);
+                    continue;
                 } else {
-                    // 如果没有错误处理节点，任务失败
-                    m_state = PipelineState::Stopped;
                     co_return;
                 }
             }
 
-            // 让出执行权，允许其他协程执行
-            // 如果状态为暂停，则暂停执行
-            if (m_state == PipelineState::Suspended) {
-                // 保存当前等待器，以便稍后恢复
-                m_awaiter = co_await TaskAwaiter{};
+            // 获取后继节点
+            const auto& nextNodes = currentNode->getNextNodeIds(branch);
+            if (nextNodes.empty()) {
+                // 如果没有后继节点，任务完成
+                flow.succeeded = true;
+                co_return;
+            }
+
+            // 每轮只采集一帧，所有next和interrupt候选节点都在同一帧上评估
+            const auto& interruptNodes = currentNode->getInterruptNodeIds(branch);
+            bool foundNext = false;
+            // 从检查点恢复时只剩下保存时未用完的超时时间
+            auto timeoutDeadline = currentTime() +
+                                   (resumeWaiting ? resumePoint->remaining : std::chrono::milliseconds(currentNode->getTimeout()));
+            setProgress(flow, CheckpointPhase::Waiting, timeoutDeadline);
+            // 推测模式下由画面稳定时间代替候选节点的前置延迟
+            TickPreDelay preDelay = speculative ? TickPreDelay{} : getTickPreDelay(nextNodes, interruptNodes);
+            // 动作结束之前采集的帧不能提交，推测模式下画面稳定之前的帧同样不能提交
+            auto freshAfter = speculative ? settleTime : flow.actionEndTime;
+            while (isFlowActive(flow)) {
+                // 在暂停点被看门狗抢占时转到看门狗节点，不再评估候选节点
+                if (flow.currentNode != currentNode) {
+                    foundNext = true;
+                    break;
+                }
+
+                // 所有候选节点共享一次前置延迟，暂停打断的等待在恢复后补足剩余的时间
+                auto preDelayEnd = currentTime() + std::chrono::milliseconds(preDelay.fixed);
+                while (true) {
+                    co_await DelayAwaiter(m_runtime, preDelayEnd, flow.token.get());
+                    auto remaining = preDelayEnd - currentTime();
+                    if (!co_await suspendPoint(flow)) {
+                        co_return;
+                    }
+                    if (flow.currentNode != currentNode || remaining <= std::chrono::steady_clock::duration::zero()) {
+                        break;
+                    }
+                    preDelayEnd = currentTime() + remaining;
+                }
+                // 暂停期间经过的时间同样不计入画面稳定的等待上限
+                auto preDelayStart = preDelayEnd - std::chrono::milliseconds(preDelay.fixed);
+                if (flow.currentNode != currentNode) {
+                    foundNext = true;
+                    break;
+                }
+
+                // 画面稳定检测：连续多次采样识别区域都没有变化后立即识别，到达等待上限后不再等待
+                if (preDelay.stable) {
+                    const StableWait& stable = *preDelay.stable;
+                    auto stableDeadline = preDelayStart + std::chrono::milliseconds(stable.maxDelay);
+                    Frame previous = captureFrame();
+                    uint32_t unchanged = 0;
+                    while (unchanged < stable.frames && currentTime() < stableDeadline) {
+                        auto sampleDeadline = std::min(currentTime() + std::chrono::milliseconds(stable.interval),
+                                                       stableDeadline);
+                        co_await waitForNextFrame(previous, flow.token.get(), sampleDeadline);
+                        if (!co_await suspendPoint(flow)) {
+                            co_return;
+                        }
+                        if (flow.currentNode != currentNode) {
+                            break;
+                        }
+                        Frame current = captureFrame();
+                        unchanged = isFrameStable(previous, current, preDelay.roi, stable.tolerance) ? unchanged + 1 : 0;
+                        previous = std::move(current);
+                    }
+                    if (flow.currentNode != currentNode) {
+                        foundNext = true;
+                        break;
+                    }
+                }
+                Frame frame = captureFrame();
+
+                // 过时的帧跳过评估，等待新帧
+                if (frame.captureTime >= freshAfter) {
+                    // 先尝试后继节点，再尝试中断节点
+                    RecognitionResult candidateResult;
+                    NodeId candidate = co_await matchCandidates(flow, nextNodes, interruptNodes, frame, candidateResult,
+                                                                currentNode->isParallel(),
+                                                                currentNode->isAdaptiveOrder() ? currentNode->getId()
+                                                                                               : InvalidNodeId);
+
+                    // 本轮评估被打断时结果不可信，恢复后重新评估
+                    if (flow.token->isCancelled()) {
+                        if (!co_await suspendPoint(flow)) {
+                            co_return;
+                        }
+                        continue;
+                    }
+
+                    if (candidate != InvalidNodeId) {
+                        setCurrentNode(flow, candidate);
+                        flow.pendingResult = std::move(candidateResult);
+                        foundNext = true;
+                        break;
+                    }
+                }
+
+                // 检查是否超时
+                if (currentTime() >= timeoutDeadline) {
+                    // 超时，尝试执行错误处理节点
+                    const auto& onErrorNodes = currentNode->getOnErrorNodeIds();
+                    if (!onErrorNodes.empty()) {
+                        setCurrentNode(flow, onErrorNodes[0]);
+                        foundNext = true;
+                        break;
+                    } else {
+                        // 如果没有错误处理节点，任务失败
+                        co_return;
+                    }
+                }
+
+                // 等待画面更新后重试，画面静止时最多等待m_maxFrameWait，且不超过超时时间
+                co_await waitForNextFrame(frame, flow.token.get(), timeoutDeadline);
 
-                // 检查是否已经停止
-                if (m_state == PipelineState::Stopped) {
+                // 如果状态变为暂停，则暂停执行
+                if (!co_await suspendPoint(flow)) {
                     co_return;
                 }
+            }
+
+            // 如果没有找到下一个节点，任务完成
+            if (!foundNext) {
+                co_return;
+            }
+        } else {
+            // 如果识别失败，尝试执行错误处理节点
+            const auto& onErrorNodes = currentNode->getOnErrorNodeIds();
+            if (!onErrorNodes.empty()) {
+                setCurrentNode(flow, onErrorNodes[0]);
             } else {
-                co_await std::suspend_always{};
+                // 如果没有错误处理节点，任务失败
+                co_return;
             }
         }
 
-        m_state = PipelineState::Stopped;
-    };
+        // 在主流程的两个节点之间应用热重载，正在构建新节点图时跳过，留到下一个节点之后
+        // 子流程只在分叉节点等待期间存在，此时主流程不会经过安全点，节点表不会被替换
+        if (!flow.group) {
+            std::unique_lock<std::mutex> lock(m_reloadMutex, std::try_to_lock);
+            if (lock.owns_lock() && m_pendingDefinition) {
+                applyPendingDefinition(&flow);
+            }
+        }
 
-    return executeTask(startNodeName);
-}
+        // 下一个节点在新的定义中被删除时结束执行
+        if (!flow.currentNode) {
+            co_return;
+        }
 
-// 设置当前节点
-void Pipeline::setCurrentNode(const std::string& nodeName) {
-    m_currentNodeName = nodeName;
-    m_currentNode = getNode(nodeName);
-}
+        // 处理节点执行期间的继续和看门狗的抢占
+        finishResume();
+        applyPreemption(flow);
 
-void Pipeline::setCurrentNode(const std::shared_ptr<Node>& node) {
-    if (node) {
-        m_currentNode = node;
-        m_currentNodeName = node->getName();
-    } else {
-        m_currentNode = nullptr;
-        m_currentNodeName = "";
+        // 让出执行权，允许其他协程执行
+        // 如果状态为暂停，则暂停执行
+        if (m_state == PipelineState::Suspended) {
+            if (!co_await suspendPoint(flow)) {
+                co_return;
+            }
+        } else {
+            co_await Runtime::YieldAwaiter{m_runtime};
+        }
     }
 }
 
-// 停止流水线执行
-void Pipeline::stop() {
-    m_state = PipelineState::Stopped;
-    m_currentNodeName = "";
-    m_currentNode = nullptr;
+// 看门狗协程
+// 看门狗作为只有一个子流程的分组运行，随流水线暂停和恢复，主流程结束时分组被确定，看门狗随之退出
+Task Pipeline::watch(std::shared_ptr<ForkGroup> group) {
+    Flow flow;
+    flow.group = std::move(group);
+    flow.token = flow.group->token;
+
+    struct FlowExit {
+        Pipeline* pipeline;
+        Flow* flow;
+        ~FlowExit() { pipeline->finishFlow(*flow); }
+    } flowExit{this, &flow};
+
+    // 每个看门狗下一次评估的时间，流水线定义被热重载替换时重新安排
+    std::shared_ptr<const PipelineDefinition> definition;
+    std::vector<std::chrono::steady_clock::time_point> dueTimes;
+
+    while (isFlowActive(flow)) {
+        auto current = getDefinition();
+        if (current != definition) {
+            definition = std::move(current);
+            dueTimes.assign(definition ? definition->getWatchdogs().size() : 0, currentTime());
+        }
+
+        // 等待最早到期的看门狗，热重载删除了全部看门狗时按默认间隔检查新的定义
+        auto deadline = currentTime() + Watchdog{}.interval;
+        if (!dueTimes.empty()) {
+            deadline = *std::min_element(dueTimes.begin(), dueTimes.end());
+        }
+        co_await DelayAwaiter(m_runtime, deadline, flow.token.get());
+        if (!co_await suspendPoint(flow)) {
+            co_return;
+        }
+        if (!definition || dueTimes.empty()) {
+            continue;
+        }
+
+        // 主流程正在处理的看门狗节点不会被同级或更低优先级的看门狗再次抢占
+        const auto& watchdogs = definition->getWatchdogs();
+        NodeId currentNodeId = m_currentNodeId;
+        auto handling = std::find_if(watchdogs.begin(), watchdogs.end(),
+                                     [currentNodeId](const Watchdog& watchdog) { return watchdog.nodeId == currentNodeId; });
 
-    // 恢复协程，如果它处于暂停状态
-    if (m_awaiter.m_handle) {
-        m_awaiter.resume();
+        // 所有到期的看门狗在同一帧上按优先级评估，命中第一个即抢占
+        Frame frame;
+        auto now = currentTime();
+        for (size_t i = 0; i < watchdogs.size() && !flow.token->isCancelled(); ++i) {
+            if (dueTimes[i] > now) {
+                continue;
+            }
+            const Node* node = definition->getNodeById(watchdogs[i].nodeId);
+            if (!node || !node->isEnabled() || (handling != watchdogs.end() && watchdogs[i].priority <= handling->priority)) {
+                dueTimes[i] = now + watchdogs[i].interval;
+                continue;
+            }
+
+            if (!frame.isValid()) {
+                frame = captureFrame();
+            }
+            RecognitionResult result = node->recognize(frame, *flow.token, m_recognitionCache.get());
+
+            // 被暂停打断的识别结果不可信，恢复后重新评估
+            if (flow.token->isCancelled()) {
+                break;
+            }
+            dueTimes[i] = now + watchdogs[i].interval;
+            if (result) {
+                preempt(watchdogs[i], std::move(result));
+                break;
+            }
+        }
     }
 }
 
-// 暂停流水线执行
-void Pipeline::suspend() {
-    if (m_state == PipelineState::Running) {
-        m_state = PipelineState::Suspended;
+// 启动看门狗协程
+void Pipeline::startWatchdog() {
+    if (!m_runtime || !m_definition || m_definition->getWatchdogs().empty()) {
+        return;
     }
+
+    auto group = std::make_shared<ForkGroup>();
+    group->watchdog = true;
+    group->parentToken = m_cancellationToken;
+    group->runtime = m_runtime;
+    group->remaining = 1;
+
+    // 看门狗随流水线停止和暂停，不受主流程被抢占的影响
+    group->callbackId = m_cancellationToken->registerCallback([token = group->token]() { token->cancel(); });
+
+    group->tasks.push_back(watch(group));
+    group->tasks.front().start(*m_runtime);
+    m_watchdogGroup = std::move(group);
 }
 
-// 继续流水线执行
-void Pipeline::resume() {
-    if (m_state == PipelineState::Suspended && m_awaiter.m_handle) {
-        m_state = PipelineState::Running;
-        m_awaiter.resume();
+// 等待看门狗协程结束
+void Pipeline::joinWatchdog() {
+    if (m_watchdogGroup) {
+        m_watchdogGroup->decide(true);
+        finishFork(*m_watchdogGroup);
+        m_watchdogGroup.reset();
     }
 }
 
-// 触发任务停止事件
-void Pipeline::triggerTaskStop(const std::string& nodeName, const std::string& reason) {
-    // 如果设置了回调，则触发回调
-    if (m_taskStopCallback) {
-        m_taskStopCallback(nodeName, reason);
+// 看门狗命中时抢占主流程
+void Pipeline::preempt(const Watchdog& watchdog, RecognitionResult result) {
+    {
+        std::lock_guard<std::mutex> lock(m_preemptionMutex);
+        if (m_preemption && m_preemption->priority >= watchdog.priority) {
+            return;
+        }
+        m_preemption = Preemption{watchdog.nodeId, watchdog.priority, std::move(result)};
+        m_preempted = true;
     }
+
+    // 打断主流程正在进行的等待、识别和动作，主流程在下一个暂停点转到看门狗节点
+    m_mainToken->cancel();
 }
 
-// 初始化节点变量
-void Pipeline::initializeNodeVariables(const std::shared_ptr<Node>& node) {
-    // 获取节点的变量定义
-    const auto& varDefs = node->getVariableDefinitions();
+// 应用抢占
+void Pipeline::applyPreemption(Flow& flow) {
+    if (flow.group || !m_preempted) {
+        return;
+    }
 
-    // 解析并初始化变量
-    if (!varDefs.empty()) {
-        m_variableManager.parseVariableList(varDefs);
+    std::optional<Preemption> preemption;
+    {
+        std::lock_guard<std::mutex> lock(m_preemptionMutex);
+        preemption = std::move(m_preemption);
+        m_preemption.reset();
+        m_preempted = false;
     }
+
+    // 主流程已经位于该节点时不必切换
+    if (!preemption || (flow.currentNode && flow.currentNode->getId() == preemption->nodeId)) {
+        return;
+    }
+    setCurrentNode(flow, preemption->nodeId);
+    flow.pendingResult = std::move(preemption->result);
 }
 
-// 初始化全局变量
-bool Pipeline::initializeGlobalVariables(const nlohmann::json& json) {
-    // 清空全局变量定义
-    m_globalVariables.clear();
+// 流程结束
+void Pipeline::finishFlow(Flow& flow) {
+    // 主流程结束即流水线停止，看门狗随之退出
+    if (!flow.group) {
+        m_state = PipelineState::Stopped;
+        if (m_watchdogGroup) {
+            m_watchdogGroup->decide(true);
+        }
+        return;
+    }
 
-    // 检查是否有全局变量定义
-    if (json.contains("var_global")) {
-        const auto& varGlobal = json["var_global"];
+    ForkGroup& group = *flow.group;
 
-        // 解析全局变量定义
-        if (varGlobal.is_string()) {
-            m_globalVariables.push_back(varGlobal.get<std::string>());
-        } else if (varGlobal.is_array()) {
-            m_globalVariables = varGlobal.get<std::vector<std::string>>();
-        }
+    // race模式以第一个结束的子流程为准，all模式下任一子流程失败即失败
+    if (group.joinMode == JoinMode::Race || !flow.succeeded) {
+        group.decide(flow.succeeded);
+    }
 
-        // 初始化全局变量
-        if (!m_globalVariables.empty()) {
-            return m_variableManager.parseVariableList(m_globalVariables);
+    // 最后一个结束的子流程恢复等待汇合的上级流程
+    if (group.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        void* waiter = group.waiter.exchange(nullptr);
+        if (waiter) {
+            group.runtime->post(std::coroutine_handle<>::from_address(waiter));
         }
     }
+}
 
-    return true;
+// 启动子流程
+std::shared_ptr<Pipeline::ForkGroup> Pipeline::startFork(Flow& flow) {
+    // 子流程作为独立的协程交给运行时并发执行，没有运行时时无法分叉
+    if (!m_runtime) {
+        return nullptr;
+    }
+
+    const auto& forkNodes = flow.currentNode->getForkNodeIds();
+    auto group = std::make_shared<ForkGroup>();
+    group->joinMode = flow.currentNode->getJoinMode();
+    group->parentToken = flow.token;
+    group->parent = flow.group;
+    group->runtime = m_runtime;
+    group->remaining = forkNodes.size();
+
+    // 上级流程被停止或暂停时同时取消子流程
+    {
+        std::lock_guard<std::mutex> lock(m_linkMutex);
+        linkToken(*flow.token, group->token, group->callbackId);
+    }
+
+    group->tasks.reserve(forkNodes.size());
+    for (NodeId nodeId : forkNodes) {
+        group->tasks.push_back(run(nodeId, group));
+    }
+    for (auto& task : group->tasks) {
+        task.start(*m_runtime);
+    }
+    return group;
 }
 
-bool Pipeline::parseJson(const nlohmann::json& json) {
-    try {
-        // 清空现有节点
-        m_nodes.clear();
+// 结束分叉
+bool Pipeline::finishFork(ForkGroup& group) {
+    // 子流程在结束前通知汇合，此时协程可能尚未到达最终挂起点，等待其完全结束后再释放
+    for (auto& task : group.tasks) {
+        task.wait();
+    }
+    group.tasks.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_linkMutex);
+        group.parentToken->unregisterCallback(group.callbackId);
+        group.callbackId = 0;
+    }
 
-        // 初始化全局变量
-        if (!initializeGlobalVariables(json)) {
-            return false;
+    // 没有子流程确定结果时说明全部成功
+    return !group.decided || group.succeeded;
+}
+
+// 流程是否应当继续执行
+bool Pipeline::isFlowActive(const Flow& flow) const {
+    if (m_state == PipelineState::Stopped) {
+        return false;
+    }
+    if (!flow.group) {
+        return true;
+    }
+
+    // 主流程即将转到看门狗节点时，分叉出的子流程全部退出
+    if (m_preempted && !flow.group->watchdog) {
+        return false;
+    }
+    return !flow.group->isDecided();
+}
+
+// 同步流程的取消令牌
+void Pipeline::syncFlowToken(const Flow& flow) {
+    // 主流程的令牌由主流程或在主流程等待汇合期间由子流程重置，看门狗与主流程并发执行，不能重置它
+    if ((!flow.group || !flow.group->watchdog) && m_mainToken->isCancelled() &&
+        !m_cancellationToken->isCancelled() && !m_preempted) {
+        std::lock_guard<std::mutex> lock(m_linkMutex);
+        if (m_mainToken->isCancelled()) {
+            // 暂停或停止时回调已经被调用，重置后重新注册
+            m_mainToken->reset();
+            linkToken(*m_cancellationToken, m_mainToken, m_mainCallbackId);
+
+            // 重置期间被抢占时重新取消，再次被暂停或停止时注册回调会立即取消
+            if (m_preempted) {
+                m_mainToken->cancel();
+            }
         }
+    }
+
+    // 从最外层的分叉组开始，上级令牌恢复后才能重置下级令牌
+    syncGroupToken(flow.group.get());
+}
+
+// 同步分叉组及其上级分叉组的取消令牌，沿上级链递归，不需要额外的内存
+void Pipeline::syncGroupToken(ForkGroup* group) {
+    if (!group) {
+        return;
+    }
+    syncGroupToken(group->parent.get());
+
+    if (!group->token->isCancelled() || group->parentToken->isCancelled() || group->decided) {
+        return;
+    }
+
+    // 同一分组的多个子流程可能同时重置，加锁后重新检查
+    std::lock_guard<std::mutex> lock(m_linkMutex);
+    if (!group->token->isCancelled() || group->parentToken->isCancelled() || group->decided) {
+        return;
+    }
+
+    // 上级取消时回调已经被调用，重置后重新注册，之后的停止和暂停才能继续传到子流程
+    group->token->reset();
+    linkToken(*group->parentToken, group->token, group->callbackId);
+
+    // 重置期间分叉组有了结果时重新取消，上级再次被取消时注册回调会立即取消
+    if (group->decided) {
+        group->token->cancel();
+    }
+}
+
+// 将子令牌挂到上级令牌上
+void Pipeline::linkToken(CancellationToken& parent, const std::shared_ptr<CancellationToken>& child,
+                         CancellationToken::CallbackId& callbackId) {
+    // 回调可能仍在上级令牌中（子令牌是被其他原因取消的），先注销，保证只注册一个
+    parent.unregisterCallback(callbackId);
+    callbackId = parent.registerCallback([token = child]() { token->cancel(); });
+}
+
+// 汇合等待器
+bool Pipeline::JoinAwaiter::await_ready() const {
+    return group->remaining == 0;
+}
 
-        // 创建所有节点
-        for (auto it = json.begin(); it != json.end(); ++it) {
-            const std::string& nodeName = it.key();
-            // 跳过var_global字段
-            if (nodeName == "var_global") {
+bool Pipeline::JoinAwaiter::await_suspend(std::coroutine_handle<> handle) const {
+    group->waiter.store(handle.address());
+
+    // 保存句柄后再次检查，避免错过最后一个子流程的通知
+    if (group->remaining == 0) {
+        // 句柄仍在时自行取回并继续执行，否则最后结束的子流程已经将协程交给运行时
+        return group->waiter.exchange(nullptr) == nullptr;
+    }
+    return true;
+}
+
+// 计算一轮评估的前置延迟
+Pipeline::TickPreDelay Pipeline::getTickPreDelay(const std::vector<NodeId>& nextNodes,
+                                                 const std::vector<NodeId>& interruptNodes) const {
+    // 所有候选节点共享一次前置延迟，取其中最大值
+    TickPreDelay preDelay;
+    bool wholeFrame = false;
+    for (const auto* candidates : {&nextNodes, &interruptNodes}) {
+        for (NodeId nodeId : *candidates) {
+            const Node* node = getNodeById(nodeId);
+            if (!node || !node->isEnabled()) {
                 continue;
             }
-            m_nodes[nodeName] = std::make_shared<Node>(nodeName);
+            if (!node->isStablePreDelay()) {
+                preDelay.fixed = std::max(preDelay.fixed, node->getPreDelay());
+                continue;
+            }
+
+            // 画面稳定检测：等待时间取最长，采样间隔和容差取最小，检测区域取所有候选节点识别区域的并集
+            const StableWait& wait = node->getStableWait();
+            preDelay.fixed = std::max(preDelay.fixed, wait.minDelay);
+            if (!preDelay.stable) {
+                preDelay.stable = wait;
+            } else {
+                preDelay.stable->maxDelay = std::max(preDelay.stable->maxDelay, wait.maxDelay);
+                preDelay.stable->frames = std::max(preDelay.stable->frames, wait.frames);
+                preDelay.stable->interval = std::min(preDelay.stable->interval, wait.interval);
+                preDelay.stable->tolerance = std::min(preDelay.stable->tolerance, wait.tolerance);
+            }
+
+            auto roi = node->getRecognition() ? node->getRecognition()->getRoi() : std::nullopt;
+            if (!roi) {
+                wholeFrame = true;
+            } else if (!preDelay.roi) {
+                preDelay.roi = roi;
+            } else {
+                preDelay.roi = Rect(std::min(preDelay.roi->x1, roi->x1), std::min(preDelay.roi->y1, roi->y1),
+                                    std::max(preDelay.roi->x2, roi->x2), std::max(preDelay.roi->y2, roi->y2));
+            }
         }
+    }
+    if (wholeFrame) {
+        preDelay.roi.reset();
+    }
+    return preDelay;
+}
+
+bool Pipeline::isFrameStable(const Frame& previous, const Frame& current, const std::optional<Rect>& roi,
+                             double tolerance) const {
+    if (!previous.isValid() || !current.isValid()) {
+        return false;
+    }
+
+    // 帧源没有产生新帧
+    if (previous.id == current.id) {
+        return true;
+    }
+
+    if (!m_frameSource) {
+        return false;
+    }
+    auto difference = m_frameSource->compareRegion(previous, current, roi);
+    return difference && *difference <= tolerance;
+}
+
+// 采集一帧
+Frame Pipeline::captureFrame() {
+    // 从帧源采集一帧
+    Frame frame;
+    if (m_frameSource) {
+        frame = m_frameSource->capture();
+    }
+
+    // 帧序号只由m_frameCounter分配，帧源的纪元单独保存，逻辑帧与帧源的帧不会共用同一个帧序号
+    // 同一纪元的帧沿用上次分配的帧序号，多次采集到同一画面时仍然共享识别缓存
+    if (frame.epoch != 0) {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        if (frame.epoch != m_lastEpoch) {
+            m_lastEpoch = frame.epoch;
+            m_lastEpochFrameId = m_frameCounter.fetch_add(1) + 1;
+        }
+        frame.id = m_lastEpochFrameId;
+        return frame;
+    }
 
-        // 初始化所有节点
-        for (auto it = json.begin(); it != json.end(); ++it) {
-            const std::string& nodeName = it.key();
-            const nlohmann::json& nodeConfig = it.value();
+    // 没有帧源或采集失败时，生成一个逻辑帧，识别时由VisionEngine自行截图，识别结果不缓存
+    frame = Frame{};
+    frame.id = m_frameCounter.fetch_add(1) + 1;
+    frame.captureTime = currentTime();
+    return frame;
+}
+
+// 等待帧源产生新帧
+Pipeline::FrameWaitAwaiter Pipeline::waitForNextFrame(const Frame& lastFrame, CancellationToken* token,
+                                                       std::chrono::steady_clock::time_point deadline) {
+    auto frameDeadline = std::min(currentTime() + m_maxFrameWait, deadline);
+
+    // 逻辑帧没有纪元，等待比最近一次采集到的帧更新的帧
+    uint64_t lastEpoch = lastFrame.epoch;
+    if (lastEpoch == 0) {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        lastEpoch = m_lastEpoch;
+    }
+    return FrameWaitAwaiter{this, lastEpoch, DelayAwaiter(m_runtime, frameDeadline, token)};
+}
+
+bool Pipeline::FrameWaitAwaiter::await_ready() {
+    // 没有运行时时只能阻塞等待
+    if (!pipeline->m_runtime && pipeline->m_frameSource) {
+        pipeline->m_frameSource->waitForNewFrame(lastEpoch, pipeline->m_maxFrameWait);
+        return true;
+    }
+    return delay.await_ready();
+}
+
+void Pipeline::FrameWaitAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    // 协程可能在本函数返回前就在其他线程上恢复，之后只使用局部变量
+    Runtime* runtime = pipeline->m_runtime;
+    FrameSource* frameSource = pipeline->m_frameSource.get();
+    uint64_t lastId = lastEpoch;
+
+    // 新帧、超时和取消共享一个标志，只有先到者恢复协程
+    // 恢复标志的地址在等待期间不变，作为新帧回调的注册键，恢复后按它注销回调
+    auto resumed = delay.getResumedFlag();
+    const void* key = resumed.get();
+    notifiedSource = frameSource;
+    notificationKey = key;
+    delay.await_suspend(handle);
 
-            auto node = m_nodes[nodeName];
-            if (!node->initialize(nodeConfig, m_nodes)) {
-                return false;
+    if (frameSource) {
+        frameSource->notifyOnNewFrame(lastId, key, [runtime, handle, resumed]() {
+            if (!resumed->exchange(true)) {
+                runtime->post(handle);
             }
+        });
 
-            // 初始化节点变量
-            initializeNodeVariables(node);
+        // 注册完成之前已经超时或被取消时，await_resume可能先于注册执行，由这里注销
+        if (resumed->load()) {
+            frameSource->cancelNewFrameNotification(key);
         }
+    }
+}
+
+void Pipeline::FrameWaitAwaiter::await_resume() {
+    delay.await_resume();
+
+    // 超时或被取消时回调仍在帧源中，画面静止时不注销会一直累积
+    if (notifiedSource) {
+        notifiedSource->cancelNewFrameNotification(notificationKey);
+    }
+}
+
+// 暂停点，流水线处于暂停状态时挂起协程直到恢复或停止
+bool Pipeline::SuspendPoint::await_ready() const {
+    pipeline->finishResume();
+    pipeline->syncFlowToken(*flow);
+
+    // 已经结束的子流程不必等待恢复，直接退出
+    if (pipeline->m_state != PipelineState::Suspended || !pipeline->isFlowActive(*flow)) {
+        return true;
+    }
 
+    // 没有运行时时在当前线程上等待resume()或stop()修改状态
+    if (!pipeline->m_runtime) {
+        pipeline->m_state.wait(PipelineState::Suspended);
         return true;
+    }
+    return false;
+}
+
+bool Pipeline::SuspendPoint::await_suspend(std::coroutine_handle<> handle) {
+    // 入栈之后协程可能随时在其他线程上恢复，暂停点随之销毁，之后只使用局部变量
+    Pipeline* owner = pipeline;
+    parked.handle = handle;
+    parked.next = owner->m_parkedHandles.load();
+    while (!owner->m_parkedHandles.compare_exchange_weak(parked.next, &parked)) {
+    }
+
+    // 入栈后再次检查，避免在检查状态之后错过resume()或stop()，此时自行唤醒所有挂起的协程
+    if (owner->m_state != PipelineState::Suspended) {
+        owner->wakeParked();
+    }
+    return true;
+}
+
+bool Pipeline::SuspendPoint::await_resume() const {
+    pipeline->finishResume();
+    pipeline->applyPreemption(*flow);
+    pipeline->syncFlowToken(*flow);
+    return pipeline->isFlowActive(*flow);
+}
+
+// 识别一个候选节点，source不为InvalidNodeId时记录命中情况和识别耗时
+// 设置了最小评估间隔的节点在间隔内复用上次的识别结果，不再重新识别
+// 时间按运行时的时钟计算，虚拟时钟下识别不消耗时间，评估顺序只取决于命中率
+static RecognitionResult recognizeCandidate(const Node& node, const Frame& frame, const CancellationToken& token,
+                                            RecognitionCache* cache, CandidateScheduler& scheduler, NodeId source,
+                                            const Clock& clock) {
+    auto start = clock.now();
+    std::chrono::milliseconds minInterval(node.getMinInterval());
+    if (minInterval.count() > 0) {
+        if (auto sample = scheduler.lookupSample(node.getId(), start, minInterval)) {
+            return std::move(*sample);
+        }
+    }
+
+    RecognitionResult result = node.recognize(frame, token, cache);
+
+    // 被取消的识别结果和耗时不可信，不记录
+    if (token.isCancelled()) {
+        return result;
+    }
+    if (minInterval.count() > 0) {
+        scheduler.storeSample(node.getId(), start, result);
+    }
+    if (source != InvalidNodeId) {
+        scheduler.record(source, node.getId(), result.success, clock.now() - start);
+    }
+    return result;
+}
+
+// 在同一帧上按优先级评估候选节点
+Pipeline::CandidateMatchAwaiter Pipeline::matchCandidates(Flow& flow, const std::vector<NodeId>& nextNodes,
+                                                          const std::vector<NodeId>& interruptNodes, const Frame& frame,
+                                                          RecognitionResult& result, bool parallel, NodeId source) {
+    // 自适应顺序时按预期耗时分别重新排列next和interrupt候选节点，next仍然优先于interrupt
+    // 排列结果放在流程的缓冲区中，每轮评估不再复制候选列表
+    const std::vector<NodeId>* next = &nextNodes;
+    const std::vector<NodeId>* interrupt = &interruptNodes;
+    if (source != InvalidNodeId) {
+        flow.orderedNext.assign(nextNodes.begin(), nextNodes.end());
+        flow.orderedInterrupt.assign(interruptNodes.begin(), interruptNodes.end());
+        m_candidateScheduler->order(source, flow.orderedNext);
+        m_candidateScheduler->order(source, flow.orderedInterrupt);
+        next = &flow.orderedNext;
+        interrupt = &flow.orderedInterrupt;
+    }
+
+    // 并行模式
+    if (parallel && next->size() + interrupt->size() > 1) {
+        return matchCandidatesParallel(flow, *next, *interrupt, frame, result, source);
+    }
+
+    return CandidateMatchAwaiter{nullptr, evaluateCandidates(*next, *interrupt, frame, result, source, *flow.token), &result};
+}
+
+// 按给定顺序评估候选节点
+NodeId Pipeline::evaluateCandidates(const std::vector<NodeId>& nextNodes, const std::vector<NodeId>& interruptNodes,
+                                    const Frame& frame, RecognitionResult& result, NodeId source,
+                                    const CancellationToken& token) {
+    // 顺序模式，命中第一个即返回
+    std::shared_ptr<Clock> clock = getClock();
+    for (const auto* candidates : {&nextNodes, &interruptNodes}) {
+        for (NodeId nodeId : *candidates) {
+            const Node* node = getNodeById(nodeId);
+            if (node && node->isEnabled()) {
+                result = recognizeCandidate(*node, frame, token, m_recognitionCache.get(), *m_candidateScheduler, source,
+                                            *clock);
+                if (result) {
+                    return nodeId;
+                }
+            }
+        }
+    }
+    return InvalidNodeId;
+}
+
+// 并行评估候选节点
+Pipeline::CandidateMatchAwaiter Pipeline::matchCandidatesParallel(Flow& flow, const std::vector<NodeId>& nextNodes,
+                                                                  const std::vector<NodeId>& interruptNodes,
+                                                                  const Frame& frame, RecognitionResult& result,
+                                                                  NodeId source) {
+    if (!flow.parallelEvaluation) {
+        flow.parallelEvaluation = std::make_unique<ParallelEvaluation>();
+    }
+    ParallelEvaluation& evaluation = *flow.parallelEvaluation;
+
+    // 按优先级收集启用的候选节点，缓冲区在多轮评估之间复用
+    evaluation.nodes.clear();
+    for (const auto* nodeIds : {&nextNodes, &interruptNodes}) {
+        for (NodeId nodeId : *nodeIds) {
+            const Node* node = getNodeById(nodeId);
+            if (node && node->isEnabled()) {
+                evaluation.nodes.push_back(node);
+            }
+        }
+    }
+    if (evaluation.results.size() < evaluation.nodes.size()) {
+        evaluation.results.resize(evaluation.nodes.size());
+    }
+    evaluation.frame = &frame;
+    evaluation.cache = m_recognitionCache.get();
+    evaluation.scheduler = m_candidateScheduler.get();
+    evaluation.clock = getClock();
+    evaluation.source = source;
+
+    // 命中的候选节点取消优先级更低的识别，停止和暂停通过流程的令牌取消所有识别
+    evaluation.match.start(*acquireWorkerPool(), m_runtime, *flow.token, evaluation.nodes.size(),
+                           [&evaluation](size_t index, const CancellationToken& token) {
+                               RecognitionResult& candidateResult = evaluation.results[index];
+                               candidateResult = recognizeCandidate(*evaluation.nodes[index], *evaluation.frame, token,
+                                                                    evaluation.cache, *evaluation.scheduler,
+                                                                    evaluation.source, *evaluation.clock);
+                               return static_cast<bool>(candidateResult);
+                           });
+    return CandidateMatchAwaiter{&evaluation, InvalidNodeId, &result};
+}
+
+// 候选节点评估等待器
+bool Pipeline::CandidateMatchAwaiter::await_ready() const {
+    return !evaluation || evaluation->match.wait().await_ready();
+}
+
+bool Pipeline::CandidateMatchAwaiter::await_suspend(std::coroutine_handle<> handle) const {
+    return evaluation->match.wait().await_suspend(handle);
+}
+
+NodeId Pipeline::CandidateMatchAwaiter::await_resume() const {
+    if (!evaluation) {
+        return candidate;
+    }
+
+    // 按列表顺序第一个命中的即为胜者
+    size_t index = evaluation->match.wait().await_resume();
+    if (index >= evaluation->nodes.size()) {
+        return InvalidNodeId;
+    }
+    *result = std::move(evaluation->results[index]);
+    return evaluation->nodes[index]->getId();
+}
+
+// 获取线程池
+std::shared_ptr<WorkerPool> Pipeline::acquireWorkerPool() {
+    // 多个子流程可能同时首次使用线程池
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    if (!m_workerPool) {
+        m_workerPool = m_runtime ? m_runtime->getWorkerPool() : std::make_shared<WorkerPool>();
+    }
+    return m_workerPool;
+}
+
+// 预热最可能的后继节点
+void Pipeline::prefetchSuccessors(NodeId from, std::vector<NodeId>& predicted) {
+    // 单独使用且没有设置线程池时不为预热创建线程池
+    if (m_prefetchCount == 0 || (!m_runtime && !m_workerPool)) {
+        return;
+    }
+
+    // 已经预热过的识别直接跳过，稳定运行后不再提交任务
+    std::shared_ptr<WorkerPool> workerPool;
+    m_transitionModel.predict(from, m_prefetchCount, predicted);
+    for (NodeId nodeId : predicted) {
+        const Node* node = getNodeById(nodeId);
+        if (!node || !node->getRecognition() || node->getRecognition()->isPrepared()) {
+            continue;
+        }
+        if (!workerPool) {
+            workerPool = acquireWorkerPool();
+        }
+
+        // 预热在后台执行，不等待结果
+        workerPool->submit([recognition = node->getRecognition()]() { recognition->prepare(); });
+    }
+}
+
+// 设置当前节点
+void Pipeline::setCurrentNode(Flow& flow, NodeId nodeId) {
+    if (flow.currentNode && nodeId != InvalidNodeId) {
+        m_transitionModel.record(flow.currentNode->getId(), nodeId);
+    }
+    flow.pendingResult.reset();
+    flow.currentNode = getNodeById(nodeId);
+    if (!flow.group) {
+        m_currentNodeId = flow.currentNode ? nodeId : InvalidNodeId;
+
+        // 从检查点恢复时执行位置已经在启动前记录，第一个节点不从头开始
+        if (!flow.resume) {
+            std::lock_guard<std::mutex> lock(m_progressMutex);
+            m_progress = Progress{};
+            m_progress.nodeId = m_currentNodeId.load();
+        }
+    }
+}
+
+// 更新执行阶段
+void Pipeline::setProgress(const Flow& flow, CheckpointPhase phase,
+                           std::chrono::steady_clock::time_point deadline, bool actionSuccess) {
+    if (flow.group) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_progressMutex);
+    m_progress.phase = phase;
+    m_progress.deadline = deadline;
+    m_progress.actionSuccess = actionSuccess;
+}
+
+// 在协程中完成resume()
+// 停止和暂停只需要切换状态并取消令牌，由控制接口直接完成；只有重置令牌必须留给协程
+// 控制接口重置令牌会与正在进行的识别和等待竞争，刚被打断的等待可能因此继续等待
+void Pipeline::finishResume() {
+    // 多个流程可能同时到达暂停点，只有取到标记的流程重置令牌
+    if (!m_resumePending.exchange(false)) {
+        return;
+    }
+
+    // resume()设置了标记但尚未切换状态，放回标记，留给恢复之后的暂停点处理
+    if (m_state == PipelineState::Suspended) {
+        m_resumePending = true;
+        return;
+    }
+
+    if (m_state == PipelineState::Running) {
+        m_cancellationToken->reset();
+
+        // 重置期间再次被暂停或停止时重新取消
+        if (m_state != PipelineState::Running) {
+            m_cancellationToken->cancel();
+        }
+    }
+}
+
+// 将在暂停点挂起的协程交给运行时，在工作线程上恢复
+void Pipeline::wakeParked() {
+    // 整体取出链表，交给运行时之后节点可能随时被销毁，因此先读取下一个节点
+    ParkedHandle* parked = m_parkedHandles.exchange(nullptr);
+    while (parked) {
+        ParkedHandle* next = parked->next;
+        std::coroutine_handle<> handle = parked->handle;
+        if (m_runtime) {
+            m_runtime->post(handle);
+        }
+        parked = next;
+    }
+}
+
+// 停止流水线执行
+// 协程可能正在其他工作线程上执行，因此这里只修改状态，当前节点由协程自行清理
+void Pipeline::stop() {
+    m_state = PipelineState::Stopped;
+    m_currentNodeId = InvalidNodeId;
+
+    // 打断正在进行的等待、识别和动作
+    m_cancellationToken->cancel();
+
+    // 唤醒处于暂停状态的协程，使其检查到停止状态后退出
+    m_state.notify_all();
+    wakeParked();
+}
+
+// 暂停流水线执行
+void Pipeline::suspend() {
+    PipelineState expected = PipelineState::Running;
+    if (m_state.compare_exchange_strong(expected, PipelineState::Suspended)) {
+        // 打断正在进行的等待、识别和动作，协程在下一个暂停点挂起
+        m_cancellationToken->cancel();
+    }
+}
+
+// 继续流水线执行
+void Pipeline::resume() {
+    if (m_state != PipelineState::Suspended) {
+        return;
+    }
+
+    // 先设置标记再切换状态，协程离开暂停点时一定能看到该标记
+    // 切换失败时（例如同时被停止）标记在协程中被忽略
+    m_resumePending = true;
+    PipelineState expected = PipelineState::Suspended;
+    if (!m_state.compare_exchange_strong(expected, PipelineState::Running)) {
+        return;
+    }
+
+    m_state.notify_all();
+    wakeParked();
+}
+
+// 触发任务停止事件
+void Pipeline::triggerTaskStop(const std::string& nodeName, const std::string& reason) {
+    // 如果设置了回调，则触发回调
+    if (m_taskStopCallback) {
+        m_taskStopCallback(nodeName, reason);
+    }
+}
+
+// 初始化节点变量
+void Pipeline::initializeNodeVariables(const Node& node) {
+    // 获取节点的变量定义
+    const auto& varDefs = node.getVariableDefinitions();
+
+    // 解析并初始化变量
+    if (!varDefs.empty()) {
+        m_variableManager.parseVariableList(varDefs);
+    }
+}
+
+// 初始化全局变量
+bool Pipeline::initializeGlobalVariables(const nlohmann::json& json) {
+    // 解析并初始化全局变量
+    std::vector<std::string> globalVariables = PipelineDefinition::parseGlobalVariables(json);
+    if (!globalVariables.empty()) {
+        return m_variableManager.parseVariableList(globalVariables);
+    }
+
+    return true;
+}
+
+// 将JSON写入文件
+static bool writeJsonFile(const std::string& filePath, const nlohmann::json& json) {
+    try {
+        std::ofstream file(filePath);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << json.dump(4);
+        return file.good();
     } catch (const std::exception& e) {
         // 处理异常
         return false;
     }
 }
 
+// 从文件读取JSON对象，文件不存在、解析失败或不是对象时返回空值
+static std::optional<nlohmann::json> readJsonFile(const std::string& filePath) {
+    try {
+        // 打开文件
+        std::ifstream file(filePath);
+        if (!file.is_open()) {
+            return std::nullopt;
+        }
+
+        // 读取文件内容
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        file.close();
+
+        // 解析JSON
+        nlohmann::json json = nlohmann::json::parse(buffer.str());
+        if (!json.is_object()) {
+            return std::nullopt;
+        }
+        return json;
+    } catch (const std::exception& e) {
+        // 处理异常
+        return std::nullopt;
+    }
+}
+
+// 保存转移模型
+bool Pipeline::saveTransitionModel(const std::string& filePath) const {
+    return writeJsonFile(filePath, transitionsToJson());
+}
+
+// 加载转移模型
+bool Pipeline::loadTransitionModel(const std::string& filePath) {
+    auto json = readJsonFile(filePath);
+    if (!json) {
+        return false;
+    }
+    addTransitions(*json);
+    return true;
+}
+
+// 保存动作延迟模型
+bool Pipeline::saveLatencyModel(const std::string& filePath) const {
+    return writeJsonFile(filePath, latenciesToJson());
+}
+
+// 加载动作延迟模型
+bool Pipeline::loadLatencyModel(const std::string& filePath) {
+    auto json = readJsonFile(filePath);
+    if (!json) {
+        return false;
+    }
+    addLatencies(*json);
+    return true;
+}
+
+// 获取学习到的后置延迟
+std::optional<uint32_t> Pipeline::getLearnedPostDelay(const std::string& nodeName) const {
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    const Node* node = m_definition ? m_definition->getNodeById(m_definition->getNodeId(nodeName)) : nullptr;
+    if (!node || !node->isAutoPostDelay()) {
+        return std::nullopt;
+    }
+    auto learned = m_latencyModel.getPercentile(node->getId(), node->getAutoPostDelay().percentile);
+    if (!learned) {
+        return std::nullopt;
+    }
+    return std::min(learned->settle, node->getAutoPostDelay().maxDelay);
+}
+
+// 获取节点生效的后置延迟
+uint32_t Pipeline::getEffectivePostDelay(const Node& node) const {
+    if (node.isAutoPostDelay()) {
+        if (auto learned = m_latencyModel.getPercentile(node.getId(), node.getAutoPostDelay().percentile)) {
+            return std::min(learned->settle, node.getAutoPostDelay().maxDelay);
+        }
+    }
+    return node.getPostDelay();
+}
+
+// 转移模型转换为JSON，格式为{"转移前的节点": {"转移后的节点": 次数}}
+nlohmann::json Pipeline::transitionsToJson() const {
+    nlohmann::json json = nlohmann::json::object();
+
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    for (const auto& transition : m_transitionModel.getTransitions()) {
+        const Node* from = getNodeById(transition.from);
+        const Node* to = getNodeById(transition.to);
+        if (from && to) {
+            json[from->getName()][to->getName()] = transition.count;
+        }
+    }
+    return json;
+}
+
+// 累加转移记录
+void Pipeline::addTransitions(const nlohmann::json& json) {
+    for (auto from = json.begin(); from != json.end(); ++from) {
+        NodeId fromId = getNodeId(from.key());
+        if (fromId == InvalidNodeId || !from.value().is_object()) {
+            continue;
+        }
+        for (auto to = from.value().begin(); to != from.value().end(); ++to) {
+            NodeId toId = getNodeId(to.key());
+            if (toId != InvalidNodeId && to.value().is_number_unsigned()) {
+                m_transitionModel.record(fromId, toId, to.value().get<uint64_t>());
+            }
+        }
+    }
+}
+
+// 动作延迟模型转换为JSON，格式为{"节点": [{"start": 毫秒, "settle": 毫秒}]}，样本从旧到新排列
+nlohmann::json Pipeline::latenciesToJson() const {
+    nlohmann::json json = nlohmann::json::object();
+
+    std::lock_guard<std::mutex> lock(m_graphMutex);
+    for (const auto& [nodeId, samples] : m_latencyModel.getSamples()) {
+        const Node* node = getNodeById(nodeId);
+        if (!node) {
+            continue;
+        }
+        nlohmann::json& list = json[node->getName()];
+        for (const auto& sample : samples) {
+            list.push_back({{"start", sample.start}, {"settle", sample.settle}});
+        }
+    }
+    return json;
+}
+
+// 追加动作延迟样本
+void Pipeline::addLatencies(const nlohmann::json& json) {
+    for (auto entry = json.begin(); entry != json.end(); ++entry) {
+        NodeId nodeId = getNodeId(entry.key());
+        if (nodeId == InvalidNodeId || !entry.value().is_array()) {
+            continue;
+        }
+        for (const auto& item : entry.value()) {
+            if (item.is_object() && item.contains("settle") && item["settle"].is_number_unsigned()) {
+                LatencySample sample;
+                sample.start = item.value("start", 0u);
+                sample.settle = item["settle"].get<uint32_t>();
+                m_latencyModel.record(nodeId, sample);
+            }
+        }
+    }
+}
+
+bool Pipeline::parseJson(const nlohmann::json& json) {
+    return setDefinition(PipelineDefinition::build(json));
+}
+
+// 替换当前的流水线定义
+void Pipeline::swapDefinition(std::shared_ptr<const PipelineDefinition> definition) {
+    // 旧定义在锁外释放
+    std::shared_ptr<const PipelineDefinition> previous;
+    {
+        std::lock_guard<std::mutex> lock(m_graphMutex);
+        previous = std::move(m_definition);
+        m_definition = std::move(definition);
+    }
+}
+
+// 热重载
+bool Pipeline::reload(const nlohmann::json& json) {
+    std::lock_guard<std::mutex> lock(m_reloadMutex);
+
+    // 在调用者线程上构建新的流水线定义，流水线继续使用当前定义执行
+    // 尚未应用的定义视为当前定义，连续重载时在它的基础上比较
+    std::shared_ptr<const PipelineDefinition> previous = m_pendingDefinition ? m_pendingDefinition : getDefinition();
+    auto definition = PipelineDefinition::build(json, previous.get());
+    if (!definition) {
+        return false;
+    }
+    m_pendingDefinition = std::move(definition);
+
+    // 流水线没有运行时立即应用
+    if (m_state == PipelineState::Stopped) {
+        applyPendingDefinition(nullptr);
+    }
+    return true;
+}
+
+// 应用等待中的流水线定义
+void Pipeline::applyPendingDefinition(Flow* flow) {
+    std::shared_ptr<const PipelineDefinition> definition = std::move(m_pendingDefinition);
+    if (!definition) {
+        return;
+    }
+
+    // 被替换的节点的分支可能已经不存在，清除这些节点生效的分支
+    {
+        std::lock_guard<std::mutex> lock(m_graphMutex);
+        for (auto it = m_activeBranches.begin(); it != m_activeBranches.end();) {
+            if (definition->getNodeById(it->first) != getNodeById(it->first)) {
+                it = m_activeBranches.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // 节点ID保持不变，当前节点被替换时之前命中的识别结果不再可信，进入节点时重新识别
+    const Node* currentNode = flow ? definition->getNodeById(m_currentNodeId.load()) : nullptr;
+    bool currentNodeReplaced = flow && currentNode != flow->currentNode;
+    swapDefinition(definition);
+    if (currentNodeReplaced) {
+        flow->pendingResult.reset();
+        flow->currentNode = currentNode;
+        if (!currentNode) {
+            m_currentNodeId = InvalidNodeId;
+        }
+    }
+
+    // 被替换的节点可能使用了不同的识别参数，丢弃按最小评估间隔保存的识别结果
+    m_candidateScheduler->clearSamples();
+
+    // 只定义新增的变量，已有变量保持当前值
+    defineMissingVariables(definition->getGlobalVariables());
+    for (NodeId id = 0; id < definition->getNodeTableSize(); ++id) {
+        if (const Node* node = definition->getNodeById(id)) {
+            defineMissingVariables(node->getVariableDefinitions());
+        }
+    }
+}
+
+// 只定义尚不存在的变量
+void Pipeline::defineMissingVariables(const std::vector<std::string>& definitions) {
+    for (const auto& definition : definitions) {
+        std::string name = definition.substr(0, definition.find('='));
+        if (!m_variableManager.getVariable(name)) {
+            m_variableManager.parseVariableDefinition(definition);
+        }
+    }
+}
+
 } // namespace Pipeline
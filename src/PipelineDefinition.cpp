@@ -0,0 +1,186 @@
+#include "Pipeline/PipelineDefinition.h"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+namespace Pipeline {
+
+// 根对象中不是节点的字段
+static bool isReservedKey(const std::string& key) {
+    return key == "var_global" || key == "watchdog";
+}
+
+std::shared_ptr<const PipelineDefinition> PipelineDefinition::loadFromFile(const std::string& filePath) {
+    try {
+        // 打开文件
+        std::ifstream file(filePath);
+        if (!file.is_open()) {
+            return nullptr;
+        }
+
+        // 读取文件内容
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        file.close();
+
+        // 解析JSON
+        nlohmann::json json = nlohmann::json::parse(buffer.str());
+        return build(json);
+    } catch (const std::exception& e) {
+        // 处理异常
+        return nullptr;
+    }
+}
+
+std::shared_ptr<const PipelineDefinition> PipelineDefinition::loadFromString(const std::string& jsonString) {
+    try {
+        // 解析JSON
+        nlohmann::json json = nlohmann::json::parse(jsonString);
+        return build(json);
+    } catch (const std::exception& e) {
+        // 处理异常
+        return nullptr;
+    }
+}
+
+std::shared_ptr<const PipelineDefinition> PipelineDefinition::build(const nlohmann::json& json, const PipelineDefinition* previous) {
+    try {
+        std::shared_ptr<PipelineDefinition> definition(new PipelineDefinition());
+        definition->m_globalVariables = parseGlobalVariables(json);
+
+        // 分配节点ID，已有节点保持原来的节点ID，新节点按出现顺序追加在节点表末尾
+        if (previous) {
+            definition->m_nodeTable.resize(previous->m_nodeTable.size());
+            definition->m_nodeConfigs.resize(previous->m_nodeConfigs.size());
+        }
+        for (auto it = json.begin(); it != json.end(); ++it) {
+            const std::string& nodeName = it.key();
+            // 跳过var_global和watchdog字段
+            if (isReservedKey(nodeName)) {
+                continue;
+            }
+
+            NodeId id = previous ? previous->getNodeId(nodeName) : InvalidNodeId;
+            if (id == InvalidNodeId) {
+                id = static_cast<NodeId>(definition->m_nodeTable.size());
+                definition->m_nodeTable.emplace_back();
+                definition->m_nodeConfigs.emplace_back();
+            }
+            definition->m_nodeIds[nodeName] = id;
+        }
+
+        // 初始化所有节点，同时将节点间的引用解析为节点ID，引用不存在的节点时加载失败
+        definition->m_recognitionPool.setPrevious(previous ? &previous->m_recognitionPool : nullptr);
+        for (auto it = json.begin(); it != json.end(); ++it) {
+            const std::string& nodeName = it.key();
+            if (isReservedKey(nodeName)) {
+                continue;
+            }
+            const nlohmann::json& nodeConfig = it.value();
+            NodeId id = definition->m_nodeIds[nodeName];
+
+            // nlohmann::json的对象按键名排序，序列化结果可以直接比较
+            std::string config = nodeConfig.dump();
+
+            // 配置没有变化且引用的节点ID都没有变化时复用原来的节点
+            const Node* existing = previous ? previous->getNodeById(id) : nullptr;
+            if (existing && previous->m_nodeConfigs[id] == config && existing->hasValidReferences(definition->m_nodeIds)) {
+                definition->m_nodeTable[id] = previous->m_nodeTable[id];
+                definition->m_recognitionPool.insert(existing->getRecognition());
+            } else {
+                auto node = std::make_shared<Node>(nodeName, id);
+                if (!node->initialize(nodeConfig, definition->m_nodeIds, &definition->m_recognitionPool)) {
+                    return nullptr;
+                }
+                definition->m_nodeTable[id] = std::move(node);
+            }
+            definition->m_nodeConfigs[id] = std::move(config);
+        }
+        definition->m_recognitionPool.setPrevious(nullptr);
+
+        // 解析看门狗
+        if (!definition->parseWatchdogs(json)) {
+            return nullptr;
+        }
+
+        return definition;
+    } catch (const std::exception& e) {
+        // 处理异常
+        return nullptr;
+    }
+}
+
+std::vector<std::string> PipelineDefinition::parseGlobalVariables(const nlohmann::json& json) {
+    std::vector<std::string> definitions;
+    if (json.contains("var_global")) {
+        const auto& varGlobal = json["var_global"];
+        if (varGlobal.is_string()) {
+            definitions.push_back(varGlobal.get<std::string>());
+        } else if (varGlobal.is_array()) {
+            definitions = varGlobal.get<std::vector<std::string>>();
+        }
+    }
+    return definitions;
+}
+
+bool PipelineDefinition::parseWatchdogs(const nlohmann::json& json) {
+    if (!json.contains("watchdog")) {
+        return true;
+    }
+
+    // 支持节点名、节点名数组，或以节点名为键、值为interval和priority的对象
+    const auto& config = json["watchdog"];
+    std::vector<std::pair<std::string, Watchdog>> watchdogs;
+    if (config.is_string()) {
+        watchdogs.emplace_back(config.get<std::string>(), Watchdog{});
+    } else if (config.is_array()) {
+        for (const auto& name : config) {
+            watchdogs.emplace_back(name.get<std::string>(), Watchdog{});
+        }
+    } else if (config.is_object()) {
+        for (auto it = config.begin(); it != config.end(); ++it) {
+            Watchdog watchdog;
+            if (it.value().contains("interval")) {
+                watchdog.interval = std::chrono::milliseconds(it.value()["interval"].get<uint32_t>());
+            }
+            if (it.value().contains("priority")) {
+                watchdog.priority = it.value()["priority"].get<int>();
+            }
+            watchdogs.emplace_back(it.key(), watchdog);
+        }
+    } else {
+        return false;
+    }
+
+    for (auto& [name, watchdog] : watchdogs) {
+        watchdog.nodeId = getNodeId(name);
+        if (watchdog.nodeId == InvalidNodeId || watchdog.interval.count() == 0) {
+            return false;
+        }
+    }
+
+    // 同一帧上优先级高的看门狗先评估
+    std::stable_sort(watchdogs.begin(), watchdogs.end(), [](const auto& a, const auto& b) {
+        return a.second.priority != b.second.priority ? a.second.priority > b.second.priority : a.first < b.first;
+    });
+    for (const auto& entry : watchdogs) {
+        m_watchdogs.push_back(entry.second);
+    }
+    return true;
+}
+
+std::shared_ptr<const Node> PipelineDefinition::getNode(const std::string& name) const {
+    NodeId id = getNodeId(name);
+    return id != InvalidNodeId ? m_nodeTable[id] : nullptr;
+}
+
+NodeId PipelineDefinition::getNodeId(const std::string& name) const {
+    auto it = m_nodeIds.find(name);
+    if (it != m_nodeIds.end()) {
+        return it->second;
+    }
+    return InvalidNodeId;
+}
+
+} // namespace Pipeline
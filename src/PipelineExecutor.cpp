@@ -2,8 +2,13 @@
 
 namespace Pipeline {
 
-PipelineExecutor::PipelineExecutor(){
+PipelineExecutor::PipelineExecutor(std::shared_ptr<Runtime> runtime) : m_runtime(std::move(runtime)) {
+    if (!m_runtime) {
+        m_runtime = std::make_shared<Runtime>(1);
+    }
+
     m_pipeline = std::make_unique<Pipeline>();
+    m_pipeline->setRuntime(m_runtime.get());
     // 初始化时设置流水线的任务停止回调
     m_pipeline->setTaskStopCallback([this](const std::string& nodeName, const std::string& reason) {
         if (m_taskStopCallback) {
@@ -25,10 +30,7 @@ bool PipelineExecutor::executeFromFile(const std::string& filePath, const std::s
         return false;
     }
 
-    // 执行流水线
-    m_currentTask = m_pipeline->execute(startNodeName);
-
-    return true;
+    return start(startNodeName);
 }
 
 bool PipelineExecutor::executeFromString(const std::string& jsonString, const std::string& startNodeName) {
@@ -40,8 +42,103 @@ bool PipelineExecutor::executeFromString(const std::string& jsonString, const st
         return false;
     }
 
-    // 执行流水线
+    return start(startNodeName);
+}
+
+bool PipelineExecutor::execute(std::shared_ptr<const PipelineDefinition> definition, const std::string& startNodeName) {
+    // 停止当前执行
+    stop();
+
+    // 使用共享的流水线定义
+    if (!m_pipeline->setDefinition(std::move(definition))) {
+        return false;
+    }
+
+    return start(startNodeName);
+}
+
+bool PipelineExecutor::restoreFromFile(const std::string& filePath, const std::vector<uint8_t>& checkpoint) {
+    // 停止当前执行
+    stop();
+
+    // 加载流水线
+    if (!m_pipeline->loadFromFile(filePath)) {
+        return false;
+    }
+
+    return startFromCheckpoint(checkpoint);
+}
+
+bool PipelineExecutor::restoreFromString(const std::string& jsonString, const std::vector<uint8_t>& checkpoint) {
+    // 停止当前执行
+    stop();
+
+    // 加载流水线
+    if (!m_pipeline->loadFromString(jsonString)) {
+        return false;
+    }
+
+    return startFromCheckpoint(checkpoint);
+}
+
+bool PipelineExecutor::restore(std::shared_ptr<const PipelineDefinition> definition, const std::vector<uint8_t>& checkpoint) {
+    // 停止当前执行
+    stop();
+
+    // 使用共享的流水线定义
+    if (!m_pipeline->setDefinition(std::move(definition))) {
+        return false;
+    }
+
+    return startFromCheckpoint(checkpoint);
+}
+
+std::vector<uint8_t> PipelineExecutor::checkpoint() const {
+    if (m_pipeline) {
+        if (auto checkpoint = m_pipeline->checkpoint()) {
+            return checkpoint->serialize();
+        }
+    }
+    return {};
+}
+
+bool PipelineExecutor::reloadFromFile(const std::string& filePath) {
+    if (!m_pipeline || m_pipeline->getNodeCount() == 0) {
+        return false;
+    }
+    return m_pipeline->reloadFromFile(filePath);
+}
+
+bool PipelineExecutor::reloadFromString(const std::string& jsonString) {
+    if (!m_pipeline || m_pipeline->getNodeCount() == 0) {
+        return false;
+    }
+    return m_pipeline->reloadFromString(jsonString);
+}
+
+bool PipelineExecutor::start(const std::string& startNodeName) {
+    // 检查起始节点是否存在
+    if (m_pipeline->getNodeId(startNodeName) == InvalidNodeId) {
+        return false;
+    }
+
+    // 创建协程并交给运行时执行
     m_currentTask = m_pipeline->execute(startNodeName);
+    m_currentTask.start(*m_runtime);
+
+    return true;
+}
+
+bool PipelineExecutor::startFromCheckpoint(const std::vector<uint8_t>& checkpoint) {
+    // 检查检查点能否解析，以及其中的节点是否存在
+    auto restored = Checkpoint::deserialize(checkpoint);
+    if (!restored || m_pipeline->getNodeId(restored->nodeName) == InvalidNodeId) {
+        return false;
+    }
+
+    // 创建协程并交给运行时执行
+    m_currentTask = m_pipeline->restore(*restored);
+    m_currentTask.start(*m_runtime);
 
     return true;
 }
@@ -50,6 +147,10 @@ void PipelineExecutor::stop() {
     if (m_pipeline) {
         m_pipeline->stop();
     }
+
+    // 等待协程退出，之后才能安全地重新加载或销毁流水线
+    m_currentTask.wait();
+    m_currentTask = Task{};
 }
 
 void PipelineExecutor::suspend() {
@@ -78,6 +179,62 @@ std::string PipelineExecutor::getCurrentNodeName() const {
     return "";
 }
 
+RecognitionCacheStats PipelineExecutor::getRecognitionCacheStats() const {
+    if (m_pipeline) {
+        return m_pipeline->getRecognitionCacheStats();
+    }
+    return RecognitionCacheStats{};
+}
+
+std::vector<EdgeStats> PipelineExecutor::getEdgeStats(const std::string& nodeName) const {
+    if (m_pipeline) {
+        return m_pipeline->getEdgeStats(nodeName);
+    }
+    return {};
+}
+
+bool PipelineExecutor::saveTransitionModel(const std::string& filePath) const {
+    if (m_pipeline) {
+        return m_pipeline->saveTransitionModel(filePath);
+    }
+    return false;
+}
+
+bool PipelineExecutor::loadTransitionModel(const std::string& filePath) {
+    if (m_pipeline) {
+        return m_pipeline->loadTransitionModel(filePath);
+    }
+    return false;
+}
+
+std::optional<uint32_t> PipelineExecutor::getLearnedPostDelay(const std::string& nodeName) const {
+    if (m_pipeline) {
+        return m_pipeline->getLearnedPostDelay(nodeName);
+    }
+    return std::nullopt;
+}
+
+bool PipelineExecutor::saveLatencyModel(const std::string& filePath) const {
+    if (m_pipeline) {
+        return m_pipeline->saveLatencyModel(filePath);
+    }
+    return false;
+}
+
+bool PipelineExecutor::loadLatencyModel(const std::string& filePath) {
+    if (m_pipeline) {
+        return m_pipeline->loadLatencyModel(filePath);
+    }
+    return false;
+}
+
+std::string PipelineExecutor::getNodeName(NodeId id) const {
+    if (m_pipeline) {
+        return m_pipeline->getNodeName(id);
+    }
+    return "";
+}
+
 void PipelineExecutor::setNodeCallback(NodeCallback callback) {
     m_nodeCallback = std::move(callback);
 }
@@ -95,4 +252,16 @@ void PipelineExecutor::setTaskStopCallback(TaskStopCallback callback) {
     }
 }
 
+void PipelineExecutor::setFrameSource(std::shared_ptr<FrameSource> frameSource) {
+    if (m_pipeline) {
+        m_pipeline->setFrameSource(std::move(frameSource));
+    }
+}
+
+void PipelineExecutor::setMaxFrameWait(std::chrono::milliseconds maxWait) {
+    if (m_pipeline) {
+        m_pipeline->setMaxFrameWait(maxWait);
+    }
+}
+
 } // namespace Pipeline
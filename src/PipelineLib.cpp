@@ -1,4 +1,15 @@
 #include "PipelineLib.h"
+#include <nlohmann/json.hpp>
+
+// 运行时句柄，持有共享的运行时
+struct PipelineRuntimeHandle {
+    std::shared_ptr<Pipeline::Runtime> runtime;
+};
+
+// 流水线定义句柄，持有共享的流水线定义
+struct PipelineDefinitionHandle {
+    std::shared_ptr<const Pipeline::PipelineDefinition> definition;
+};
 
 // DLL导出函数实现
 extern "C" {
@@ -21,6 +32,27 @@ PIPELINE_API Pipeline::PipelineExecutor* PipelineCreateExecutor() {
     return new Pipeline::PipelineExecutor();
 }
 
+// 创建运行时
+PIPELINE_API PipelineRuntimeHandle* PipelineCreateRuntime(int workerCount) {
+    if (workerCount < 0) {
+        workerCount = 0;
+    }
+
+    return new PipelineRuntimeHandle{std::make_shared<Pipeline::Runtime>(static_cast<size_t>(workerCount))};
+}
+
+// 销毁运行时句柄
+PIPELINE_API void PipelineDestroyRuntime(PipelineRuntimeHandle* runtime) {
+    if (runtime) {
+        delete runtime;
+    }
+}
+
+// 创建使用指定运行时的流水线执行器
+PIPELINE_API Pipeline::PipelineExecutor* PipelineCreateExecutorWithRuntime(PipelineRuntimeHandle* runtime) {
+    return new Pipeline::PipelineExecutor(runtime ? runtime->runtime : nullptr);
+}
+
 // 销毁流水线执行器
 PIPELINE_API void PipelineDestroyExecutor(Pipeline::PipelineExecutor* executor) {
     if (executor) {
@@ -46,6 +78,64 @@ PIPELINE_API bool PipelineExecuteFromString(Pipeline::PipelineExecutor* executor
     return executor->executeFromString(jsonString, startNodeName);
 }
 
+// 从文件加载流水线定义
+PIPELINE_API PipelineDefinitionHandle* PipelineLoadDefinitionFromFile(const char* filePath) {
+    if (!filePath) {
+        return nullptr;
+    }
+
+    auto definition = Pipeline::PipelineDefinition::loadFromFile(filePath);
+    if (!definition) {
+        return nullptr;
+    }
+    return new PipelineDefinitionHandle{std::move(definition)};
+}
+
+// 从字符串加载流水线定义
+PIPELINE_API PipelineDefinitionHandle* PipelineLoadDefinitionFromString(const char* jsonString) {
+    if (!jsonString) {
+        return nullptr;
+    }
+
+    auto definition = Pipeline::PipelineDefinition::loadFromString(jsonString);
+    if (!definition) {
+        return nullptr;
+    }
+    return new PipelineDefinitionHandle{std::move(definition)};
+}
+
+// 销毁流水线定义句柄
+PIPELINE_API void PipelineDestroyDefinition(PipelineDefinitionHandle* definition) {
+    delete definition;
+}
+
+// 执行已加载的流水线定义
+PIPELINE_API bool PipelineExecuteDefinition(Pipeline::PipelineExecutor* executor, PipelineDefinitionHandle* definition, const char* startNodeName) {
+    if (!executor || !definition || !startNodeName) {
+        return false;
+    }
+
+    return executor->execute(definition->definition, startNodeName);
+}
+
+// 从文件热重载流水线定义
+PIPELINE_API bool PipelineReloadFromFile(Pipeline::PipelineExecutor* executor, const char* filePath) {
+    if (!executor || !filePath) {
+        return false;
+    }
+
+    return executor->reloadFromFile(filePath);
+}
+
+// 从字符串热重载流水线定义
+PIPELINE_API bool PipelineReloadFromString(Pipeline::PipelineExecutor* executor, const char* jsonString) {
+    if (!executor || !jsonString) {
+        return false;
+    }
+
+    return executor->reloadFromString(jsonString);
+}
+
 // 停止流水线执行
 PIPELINE_API void PipelineStop(Pipeline::PipelineExecutor* executor) {
     if (executor) {
@@ -88,6 +178,118 @@ PIPELINE_API const char* PipelineGetCurrentNodeName(Pipeline::PipelineExecutor*
     return nodeName.c_str();
 }
 
+// 获取识别结果缓存统计
+PIPELINE_API void PipelineGetRecognitionCacheStats(Pipeline::PipelineExecutor* executor, uint64_t* hits, uint64_t* misses) {
+    Pipeline::RecognitionCacheStats stats;
+    if (executor) {
+        stats = executor->getRecognitionCacheStats();
+    }
+
+    if (hits) {
+        *hits = stats.hits;
+    }
+    if (misses) {
+        *misses = stats.misses;
+    }
+}
+
+// 获取候选边统计
+PIPELINE_API const char* PipelineGetEdgeStats(Pipeline::PipelineExecutor* executor, const char* nodeName) {
+    static thread_local std::string statsJson;
+
+    nlohmann::json stats = nlohmann::json::array();
+    if (executor && nodeName) {
+        for (const auto& edge : executor->getEdgeStats(nodeName)) {
+            stats.push_back({
+                {"from", executor->getNodeName(edge.from)},
+                {"to", executor->getNodeName(edge.to)},
+                {"attempts", edge.attempts},
+                {"hits", edge.hits},
+                {"average_cost", edge.averageCost},
+                {"score", edge.score}
+            });
+        }
+    }
+
+    statsJson = stats.dump();
+    return statsJson.c_str();
+}
+
+// 保存节点转移模型
+PIPELINE_API bool PipelineSaveTransitionModel(Pipeline::PipelineExecutor* executor, const char* filePath) {
+    if (executor && filePath) {
+        return executor->saveTransitionModel(filePath);
+    }
+    return false;
+}
+
+// 加载节点转移模型
+PIPELINE_API bool PipelineLoadTransitionModel(Pipeline::PipelineExecutor* executor, const char* filePath) {
+    if (executor && filePath) {
+        return executor->loadTransitionModel(filePath);
+    }
+    return false;
+}
+
+// 获取学习到的后置延迟
+PIPELINE_API int PipelineGetLearnedPostDelay(Pipeline::PipelineExecutor* executor, const char* nodeName) {
+    if (executor && nodeName) {
+        if (auto postDelay = executor->getLearnedPostDelay(nodeName)) {
+            return static_cast<int>(*postDelay);
+        }
+    }
+    return -1;
+}
+
+// 保存动作延迟模型
+PIPELINE_API bool PipelineSaveLatencyModel(Pipeline::PipelineExecutor* executor, const char* filePath) {
+    if (executor && filePath) {
+        return executor->saveLatencyModel(filePath);
+    }
+    return false;
+}
+
+// 加载动作延迟模型
+PIPELINE_API bool PipelineLoadLatencyModel(Pipeline::PipelineExecutor* executor, const char* filePath) {
+    if (executor && filePath) {
+        return executor->loadLatencyModel(filePath);
+    }
+    return false;
+}
+
+// 生成检查点
+PIPELINE_API size_t PipelineCheckpoint(Pipeline::PipelineExecutor* executor, uint8_t* buffer, size_t bufferSize) {
+    if (!executor) {
+        return 0;
+    }
+
+    std::vector<uint8_t> checkpoint = executor->checkpoint();
+    if (buffer && bufferSize >= checkpoint.size()) {
+        std::copy(checkpoint.begin(), checkpoint.end(), buffer);
+    }
+    return checkpoint.size();
+}
+
+// 从文件加载流水线并从检查点恢复执行
+PIPELINE_API bool PipelineRestoreFromFile(Pipeline::PipelineExecutor* executor, const char* filePath,
+                                          const uint8_t* checkpoint, size_t checkpointSize) {
+    if (!executor || !filePath || !checkpoint) {
+        return false;
+    }
+
+    return executor->restoreFromFile(filePath, std::vector<uint8_t>(checkpoint, checkpoint + checkpointSize));
+}
+
+// 从字符串加载流水线并从检查点恢复执行
+PIPELINE_API bool PipelineRestoreFromString(Pipeline::PipelineExecutor* executor, const char* jsonString,
+                                            const uint8_t* checkpoint, size_t checkpointSize) {
+    if (!executor || !jsonString || !checkpoint) {
+        return false;
+    }
+
+    return executor->restoreFromString(jsonString, std::vector<uint8_t>(checkpoint, checkpoint + checkpointSize));
+}
+
 // 设置任务停止回调
 PIPELINE_API void PipelineSetTaskStopCallback(Pipeline::PipelineExecutor* executor, PipelineTaskStopCallbackFunc callback) {
     if (executor && callback) {
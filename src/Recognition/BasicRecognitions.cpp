@@ -7,7 +7,7 @@ namespace Pipeline {
 DirectHitRecognition::DirectHitRecognition() : Recognition(RecognitionType::DirectHit) {
 }
 
-RecognitionResult DirectHitRecognition::recognize() {
+RecognitionResult DirectHitRecognition::recognize(const Frame& frame, const CancellationToken& token) const {
     RecognitionResult result;
     result.success = true;
     
@@ -20,15 +20,36 @@ RecognitionResult DirectHitRecognition::recognize() {
 }
 
 bool DirectHitRecognition::parseConfig(const nlohmann::json& config) {
-    // DirectHitRecognition不需要额外的参数
+    // ROI只用于画面稳定检测，不影响识别结果
+    if (config.contains("roi")) {
+        m_roi = config["roi"].get<std::vector<int>>();
+    }
+    if (config.contains("roi_offset")) {
+        m_roiOffset = config["roi_offset"].get<std::vector<int>>();
+    }
     return true;
 }
 
+std::optional<Rect> DirectHitRecognition::getRoi() const {
+    return resolveRoi(m_roi, m_roiOffset);
+}
+
+nlohmann::json DirectHitRecognition::configToJson() const {
+    // 没有设置ROI时规范化键与之前相同，参数相同的DirectHit仍然共享识别对象
+    if (!getRoi()) {
+        return nlohmann::json::object();
+    }
+    return {
+        {"roi", m_roi},
+        {"roi_offset", m_roiOffset}
+    };
+}
+
 // AlwaysRecognition实现
 AlwaysRecognition::AlwaysRecognition() : Recognition(RecognitionType::Always) {
 }
 
-RecognitionResult AlwaysRecognition::recognize() {
+RecognitionResult AlwaysRecognition::recognize(const Frame& frame, const CancellationToken& token) const {
     RecognitionResult result;
     result.success = true;
     
@@ -5,8 +5,28 @@
 
 namespace Pipeline {
 
+// 由roi和roi_offset参数创建识别区域，未设置roi时使用全屏
+static vision::Rect createVisionRoi(const std::vector<int>& roi, const std::vector<int>& roiOffset) {
+    if (roi.size() < 4) {
+        // 使用全屏
+        return vision::Rect(0, 0, 1920, 1080); // 默认全屏分辨率
+    }
+
+    vision::Rect visionRoi(roi[0], roi[1], roi[2], roi[3]);
+
+    // 应用ROI偏移
+    if (roiOffset.size() >= 4) {
+        visionRoi.x1 += roiOffset[0];
+        visionRoi.y1 += roiOffset[1];
+        visionRoi.x2 += roiOffset[2];
+        visionRoi.y2 += roiOffset[3];
+    }
+    return visionRoi;
+}
+
 // FindColorRecognition实现
 FindColorRecognition::FindColorRecognition() : Recognition(RecognitionType::FindColor) {
+    m_params = createParams();
 }
 
 bool FindColorRecognition::parseConfig(const nlohmann::json& config) {
@@ -35,42 +55,27 @@ bool FindColorRecognition::parseConfig(const nlohmann::json& config) {
         m_direction = config["direction"].get<int>();
     }
 
+    // 参数在识别时不再变化，预先创建，识别时不必复制颜色字符串
+    m_params = createParams();
+
     return true;
 }
 
-RecognitionResult FindColorRecognition::recognize() {
-    RecognitionResult result;
-
-    // 创建找色参数
-    vision::FindColorParams params;
-
-    // 设置ROI
-    if (m_roi.size() >= 4) {
-        params.roi = vision::Rect(m_roi[0], m_roi[1], m_roi[2], m_roi[3]);
-
-        // 应用ROI偏移
-        if (m_roiOffset.size() >= 4) {
-            params.roi.x1 += m_roiOffset[0];
-            params.roi.y1 += m_roiOffset[1];
-            params.roi.x2 += m_roiOffset[2];
-            params.roi.y2 += m_roiOffset[3];
-        }
-    } else {
-        // 使用全屏
-        params.roi = vision::Rect(0, 0, 1920, 1080); // 默认全屏分辨率
-    }
-
-    // 设置颜色
-    params.color = m_color;
-
-    // 设置相似度
-    params.similarity = m_similarity;
+// 创建找色参数
+std::shared_ptr<const vision::FindColorParams> FindColorRecognition::createParams() const {
+    auto params = std::make_shared<vision::FindColorParams>();
+    params->roi = createVisionRoi(m_roi, m_roiOffset);
+    params->color = m_color;
+    params->similarity = m_similarity;
+    params->direction = m_direction;
+    return params;
+}
 
-    // 设置方向
-    params.direction = m_direction;
+RecognitionResult FindColorRecognition::recognize(const Frame& frame, const CancellationToken& token) const {
+    RecognitionResult result;
 
-    // 执行找色
-    auto visionResult = vision::VisionEngine::findColor(params);
+    // 执行找色，参数在解析时已经创建
+    auto visionResult = vision::VisionEngine::findColor(static_cast<vision::VisionHandle>(frame.vision), *m_params);
 
     // 转换结果
     result.success = visionResult.success;
@@ -90,6 +95,7 @@ RecognitionResult FindColorRecognition::recognize() {
 
 // FindMultiColorRecognition实现
 FindMultiColorRecognition::FindMultiColorRecognition() : Recognition(RecognitionType::FindMultiColor) {
+    m_params = createParams();
 }
 
 bool FindMultiColorRecognition::parseConfig(const nlohmann::json& config) {
@@ -123,45 +129,28 @@ bool FindMultiColorRecognition::parseConfig(const nlohmann::json& config) {
         m_direction = config["direction"].get<int>();
     }
 
+    // 参数在识别时不再变化，预先创建，识别时不必复制颜色字符串
+    m_params = createParams();
+
     return true;
 }
 
-RecognitionResult FindMultiColorRecognition::recognize() {
-    RecognitionResult result;
-
-    // 创建多点找色参数
-    vision::FindMultiColorParams params;
-
-    // 设置ROI
-    if (m_roi.size() >= 4) {
-        params.roi = vision::Rect(m_roi[0], m_roi[1], m_roi[2], m_roi[3]);
-
-        // 应用ROI偏移
-        if (m_roiOffset.size() >= 4) {
-            params.roi.x1 += m_roiOffset[0];
-            params.roi.y1 += m_roiOffset[1];
-            params.roi.x2 += m_roiOffset[2];
-            params.roi.y2 += m_roiOffset[3];
-        }
-    } else {
-        // 使用全屏
-        params.roi = vision::Rect(0, 0, 1920, 1080); // 默认全屏分辨率
-    }
-
-    // 设置第一个颜色
-    params.firstColor = m_firstColor;
-
-    // 设置偏移颜色
-    params.offsetColor = m_offsetColor;
-
-    // 设置相似度
-    params.similarity = m_similarity;
+// 创建多点找色参数
+std::shared_ptr<const vision::FindMultiColorParams> FindMultiColorRecognition::createParams() const {
+    auto params = std::make_shared<vision::FindMultiColorParams>();
+    params->roi = createVisionRoi(m_roi, m_roiOffset);
+    params->firstColor = m_firstColor;
+    params->offsetColor = m_offsetColor;
+    params->similarity = m_similarity;
+    params->direction = m_direction;
+    return params;
+}
 
-    // 设置方向
-    params.direction = m_direction;
+RecognitionResult FindMultiColorRecognition::recognize(const Frame& frame, const CancellationToken& token) const {
+    RecognitionResult result;
 
-    // 执行多点找色
-    auto visionResult = vision::VisionEngine::findMultiColor(params);
+    // 执行多点找色，参数在解析时已经创建
+    auto visionResult = vision::VisionEngine::findMultiColor(static_cast<vision::VisionHandle>(frame.vision), *m_params);
 
     // 转换结果
     result.success = visionResult.success;
@@ -181,6 +170,7 @@ RecognitionResult FindMultiColorRecognition::recognize() {
 
 // FindColorListRecognition实现
 FindColorListRecognition::FindColorListRecognition() : Recognition(RecognitionType::FindColorList) {
+    m_paramsList = createParams();
 }
 
 bool FindColorListRecognition::parseConfig(const nlohmann::json& config) {
@@ -213,10 +203,28 @@ bool FindColorListRecognition::parseConfig(const nlohmann::json& config) {
         m_direction = config["direction"].get<int>();
     }
 
+    // 参数在识别时不再变化，预先创建，识别时不必复制颜色字符串
+    m_paramsList = createParams();
+
     return true;
 }
 
-RecognitionResult FindColorListRecognition::recognize() {
+// 为每个颜色创建找色参数
+std::shared_ptr<const std::vector<vision::FindColorParams>> FindColorListRecognition::createParams() const {
+    auto paramsList = std::make_shared<std::vector<vision::FindColorParams>>();
+    paramsList->reserve(m_colorList.size());
+    for (const auto& color : m_colorList) {
+        vision::FindColorParams params;
+        params.roi = createVisionRoi(m_roi, m_roiOffset);
+        params.color = color;
+        params.similarity = m_similarity;
+        params.direction = m_direction;
+        paramsList->push_back(std::move(params));
+    }
+    return paramsList;
+}
+
+RecognitionResult FindColorListRecognition::recognize(const Frame& frame, const CancellationToken& token) const {
     RecognitionResult result;
 
     // 如果颜色列表为空，直接返回失败
@@ -231,38 +239,16 @@ RecognitionResult FindColorListRecognition::recognize() {
         return result;
     }
 
-    // 遍历颜色列表，逐个尝试找色
-    for (const auto& color : m_colorList) {
-        // 创建找色参数
-        vision::FindColorParams params;
-
-        // 设置ROI
-        if (m_roi.size() >= 4) {
-            params.roi = vision::Rect(m_roi[0], m_roi[1], m_roi[2], m_roi[3]);
-
-            // 应用ROI偏移
-            if (m_roiOffset.size() >= 4) {
-                params.roi.x1 += m_roiOffset[0];
-                params.roi.y1 += m_roiOffset[1];
-                params.roi.x2 += m_roiOffset[2];
-                params.roi.y2 += m_roiOffset[3];
-            }
-        } else {
-            // 使用全屏
-            params.roi = vision::Rect(0, 0, 1920, 1080); // 默认全屏分辨率
+    // 遍历颜色列表，逐个尝试找色，每个颜色的参数在解析时已经创建
+    for (const auto& params : *m_paramsList) {
+        // 流水线停止或暂停时不再继续尝试
+        if (token.isCancelled()) {
+            result.success = false;
+            return result;
         }
 
-        // 设置颜色
-        params.color = color;
-
-        // 设置相似度
-        params.similarity = m_similarity;
-
-        // 设置方向
-        params.direction = m_direction;
-
         // 执行找色
-        auto visionResult = vision::VisionEngine::findColor(params);
+        auto visionResult = vision::VisionEngine::findColor(static_cast<vision::VisionHandle>(frame.vision), params);
 
         // 如果找到了颜色，返回结果
         if (visionResult.success) {
@@ -295,6 +281,7 @@ RecognitionResult FindColorListRecognition::recognize() {
 
 // FindMultiColorListRecognition实现
 FindMultiColorListRecognition::FindMultiColorListRecognition() : Recognition(RecognitionType::FindMultiColorList) {
+    m_paramsList = createParams();
 }
 
 bool FindMultiColorListRecognition::parseConfig(const nlohmann::json& config) {
@@ -329,10 +316,29 @@ bool FindMultiColorListRecognition::parseConfig(const nlohmann::json& config) {
         m_direction = config["direction"].get<int>();
     }
 
+    // 参数在识别时不再变化，预先创建，识别时不必复制颜色字符串
+    m_paramsList = createParams();
+
     return true;
 }
 
-RecognitionResult FindMultiColorListRecognition::recognize() {
+// 为多点找色列表的每一项创建多点找色参数
+std::shared_ptr<const std::vector<vision::FindMultiColorParams>> FindMultiColorListRecognition::createParams() const {
+    auto paramsList = std::make_shared<std::vector<vision::FindMultiColorParams>>();
+    paramsList->reserve(m_multiColorList.size());
+    for (const auto& [firstColor, offsetColor] : m_multiColorList) {
+        vision::FindMultiColorParams params;
+        params.roi = createVisionRoi(m_roi, m_roiOffset);
+        params.firstColor = firstColor;
+        params.offsetColor = offsetColor;
+        params.similarity = m_similarity;
+        params.direction = m_direction;
+        paramsList->push_back(std::move(params));
+    }
+    return paramsList;
+}
+
+RecognitionResult FindMultiColorListRecognition::recognize(const Frame& frame, const CancellationToken& token) const {
     RecognitionResult result;
 
     // 如果多点找色列表为空，直接返回失败
@@ -347,41 +353,16 @@ RecognitionResult FindMultiColorListRecognition::recognize() {
         return result;
     }
 
-    // 遍历多点找色列表，逐个尝试多点找色
-    for (const auto& [firstColor, offsetColor] : m_multiColorList) {
-        // 创建多点找色参数
-        vision::FindMultiColorParams params;
-
-        // 设置ROI
-        if (m_roi.size() >= 4) {
-            params.roi = vision::Rect(m_roi[0], m_roi[1], m_roi[2], m_roi[3]);
-
-            // 应用ROI偏移
-            if (m_roiOffset.size() >= 4) {
-                params.roi.x1 += m_roiOffset[0];
-                params.roi.y1 += m_roiOffset[1];
-                params.roi.x2 += m_roiOffset[2];
-                params.roi.y2 += m_roiOffset[3];
-            }
-        } else {
-            // 使用全屏
-            params.roi = vision::Rect(0, 0, 1920, 1080); // 默认全屏分辨率
+    // 遍历多点找色列表，逐个尝试多点找色，每一项的参数在解析时已经创建
+    for (const auto& params : *m_paramsList) {
+        // 流水线停止或暂停时不再继续尝试
+        if (token.isCancelled()) {
+            result.success = false;
+            return result;
         }
 
-        // 设置第一个颜色
-        params.firstColor = firstColor;
-
-        // 设置偏移颜色
-        params.offsetColor = offsetColor;
-
-        // 设置相似度
-        params.similarity = m_similarity;
-
-        // 设置方向
-        params.direction = m_direction;
-
         // 执行多点找色
-        auto visionResult = vision::VisionEngine::findMultiColor(params);
+        auto visionResult = vision::VisionEngine::findMultiColor(static_cast<vision::VisionHandle>(frame.vision), params);
 
         // 如果找到了多点找色，返回结果
         if (visionResult.success) {
@@ -412,4 +393,61 @@ RecognitionResult FindMultiColorListRecognition::recognize() {
     return result;
 }
 
+std::optional<Rect> FindColorRecognition::getRoi() const {
+    return resolveRoi(m_roi, m_roiOffset);
+}
+
+nlohmann::json FindColorRecognition::configToJson() const {
+    return {
+        {"roi", m_roi},
+        {"roi_offset", m_roiOffset},
+        {"color", m_color},
+        {"similarity", m_similarity},
+        {"direction", m_direction}
+    };
+}
+
+std::optional<Rect> FindMultiColorRecognition::getRoi() const {
+    return resolveRoi(m_roi, m_roiOffset);
+}
+
+nlohmann::json FindMultiColorRecognition::configToJson() const {
+    return {
+        {"roi", m_roi},
+        {"roi_offset", m_roiOffset},
+        {"first_color", m_firstColor},
+        {"offset_color", m_offsetColor},
+        {"similarity", m_similarity},
+        {"direction", m_direction}
+    };
+}
+
+std::optional<Rect> FindColorListRecognition::getRoi() const {
+    return resolveRoi(m_roi, m_roiOffset);
+}
+
+nlohmann::json FindColorListRecognition::configToJson() const {
+    return {
+        {"roi", m_roi},
+        {"roi_offset", m_roiOffset},
+        {"color_list", m_colorList},
+        {"similarity", m_similarity},
+        {"direction", m_direction}
+    };
+}
+
+std::optional<Rect> FindMultiColorListRecognition::getRoi() const {
+    return resolveRoi(m_roi, m_roiOffset);
+}
+
+nlohmann::json FindMultiColorListRecognition::configToJson() const {
+    return {
+        {"roi", m_roi},
+        {"roi_offset", m_roiOffset},
+        {"multi_color_list", m_multiColorList},
+        {"similarity", m_similarity},
+        {"direction", m_direction}
+    };
+}
+
 } // namespace Pipeline
@@ -8,6 +8,7 @@ namespace Pipeline {
 
 // OCRRecognition实现
 OCRRecognition::OCRRecognition() : Recognition(RecognitionType::OCR) {
+    m_params = std::make_shared<vision::OcrParams>(createParams());
 }
 
 bool OCRRecognition::parseConfig(const nlohmann::json& config) {
@@ -61,6 +62,9 @@ bool OCRRecognition::parseConfig(const nlohmann::json& config) {
         m_model = config["model"].get<std::string>();
     }
 
+    // 参数在识别时不再变化，预先创建，识别时不必复制字符串和列表
+    m_params = std::make_shared<vision::OcrParams>(createParams());
+
     return true;
 }
 
@@ -105,18 +109,24 @@ vision::OcrParams OCRRecognition::createParams() const {
     return params;
 }
 
-RecognitionResult OCRRecognition::recognize() {
+RecognitionResult OCRRecognition::recognize(const Frame& frame, const CancellationToken& token) const {
     // 使用vision库进行OCR识别
 
-    // 创建识别参数
-    vision::OcrParams params = createParams();
+    // 使用预先创建的识别参数
+    const vision::OcrParams& params = *m_params;
 
     // 初始化结果
     RecognitionResult result;
 
+    // 已取消时不再启动耗时的OCR
+    if (token.isCancelled()) {
+        result.success = false;
+        return result;
+    }
+
     try {
         // 先尝试使用新的批量OCR功能
-        auto visionResults = vision::VisionEngine::ocrBatch(params);
+        auto visionResults = vision::VisionEngine::ocrBatch(static_cast<vision::VisionHandle>(frame.vision), params);
 
         if (!visionResults.empty()) {
             // 根据索引选择结果
@@ -139,8 +149,14 @@ RecognitionResult OCRRecognition::recognize() {
             }
         }
     } catch (const std::exception& e) {
+        // 流水线停止或暂停时不再回退重试
+        if (token.isCancelled()) {
+            result.success = false;
+            return result;
+        }
+
         // 如果新方法失败，回退到旧方法
-        auto visionResult = vision::VisionEngine::ocr(params);
+        auto visionResult = vision::VisionEngine::ocr(static_cast<vision::VisionHandle>(frame.vision), params);
 
         // 转换结果
         result.success = visionResult.success;
@@ -161,16 +177,16 @@ RecognitionResult OCRRecognition::recognize() {
 }
 
 // 批量OCR识别，返回所有结果
-std::vector<RecognitionResult> OCRRecognition::recognizeBatch() {
-    // 创建识别参数
-    vision::OcrParams params = createParams();
+std::vector<RecognitionResult> OCRRecognition::recognizeBatch(const Frame& frame, const CancellationToken& token) const {
+    // 使用预先创建的识别参数
+    const vision::OcrParams& params = *m_params;
 
     // 初始化结果列表
     std::vector<RecognitionResult> results;
 
     try {
         // 执行批量OCR识别
-        auto visionResults = vision::VisionEngine::ocrBatch(params);
+        auto visionResults = vision::VisionEngine::ocrBatch(static_cast<vision::VisionHandle>(frame.vision), params);
 
         // 转换结果
         for (const auto& visionResult : visionResults) {
@@ -191,8 +207,13 @@ std::vector<RecognitionResult> OCRRecognition::recognizeBatch() {
             results.push_back(result);
         }
     } catch (const std::exception& e) {
+        // 流水线停止或暂停时不再回退重试
+        if (token.isCancelled()) {
+            return results;
+        }
+
         // 如果新方法失败，回退到旧方法
-        auto visionResult = vision::VisionEngine::ocr(params);
+        auto visionResult = vision::VisionEngine::ocr(static_cast<vision::VisionHandle>(frame.vision), params);
 
         if (visionResult.success) {
             RecognitionResult result;
@@ -216,4 +237,21 @@ std::vector<RecognitionResult> OCRRecognition::recognizeBatch() {
     return results;
 }
 
+std::optional<Rect> OCRRecognition::getRoi() const {
+    return resolveRoi(m_roi, m_roiOffset);
+}
+
+nlohmann::json OCRRecognition::configToJson() const {
+    return {
+        {"roi", m_roi},
+        {"roi_offset", m_roiOffset},
+        {"expected", m_expected},
+        {"replace", m_replace},
+        {"orderBy", m_orderBy},
+        {"index", m_index},
+        {"only_rec", m_onlyRec},
+        {"model", m_model}
+    };
+}
+
 } // namespace Pipeline
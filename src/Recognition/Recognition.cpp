@@ -4,6 +4,7 @@
 #include "Pipeline/Recognition/TemplateRecognitions.h"
 #include "Pipeline/Recognition/OcrRecognition.h"
 #include "Pipeline/Common.h"
+#include <algorithm>
 
 namespace Pipeline {
 
@@ -46,10 +47,43 @@ std::unique_ptr<Recognition> Recognition::create(RecognitionType type, const nlo
     if (recognition && !config.empty()) {
         recognition->parseConfig(config);
     }
+
+    if (recognition) {
+        recognition->updateConfigKey();
+    }
     
     return recognition;
 }
 
+// 生成规范化键，nlohmann::json的对象按键名排序，参数书写顺序不影响结果
+void Recognition::updateConfigKey() {
+    m_configKey = recognitionTypeToString(m_type) + "|" + (m_inverse ? "1" : "0") + "|" + configToJson().dump();
+    m_configHash = std::hash<std::string>{}(m_configKey);
+}
+
+// 预热资源，识别对象在多个节点和流水线之间共享，只预热一次
+void Recognition::prepare() const {
+    if (!m_prepared.exchange(true, std::memory_order_acq_rel)) {
+        onPrepare();
+    }
+}
+
+// 由roi和roi_offset计算识别区域，偏移方式与各识别类的recognize一致
+std::optional<Rect> Recognition::resolveRoi(const std::vector<int>& roi, const std::vector<int>& roiOffset) {
+    if (roi.size() < 4 || std::all_of(roi.begin(), roi.begin() + 4, [](int value) { return value == 0; })) {
+        return std::nullopt;
+    }
+
+    Rect rect(roi[0], roi[1], roi[2], roi[3]);
+    if (roiOffset.size() >= 4) {
+        rect.x1 += roiOffset[0];
+        rect.y1 += roiOffset[1];
+        rect.x2 += roiOffset[2];
+        rect.y2 += roiOffset[3];
+    }
+    return rect;
+}
+
 // 将字符串转换为识别类型
 RecognitionType stringToRecognitionType(const std::string& typeStr) {
     if (typeStr == "DirectHit") {
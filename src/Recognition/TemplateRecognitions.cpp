@@ -1,12 +1,14 @@
 #include "Pipeline/Recognition/TemplateRecognitions.h"
 #include "Pipeline/RecognitionResult.h"
 #include <vision/vision.h>
+#include <fstream>
 #include <iostream>
 
 namespace Pipeline {
 
 // TemplateMatchRecognition实现
 TemplateMatchRecognition::TemplateMatchRecognition() : Recognition(RecognitionType::TemplateMatch) {
+    m_params = std::make_shared<vision::TemplateMatchParams>(createParams());
 }
 
 bool TemplateMatchRecognition::parseConfig(const nlohmann::json& config) {
@@ -42,26 +44,15 @@ bool TemplateMatchRecognition::parseConfig(const nlohmann::json& config) {
     if (config.contains("method")) {
         m_method = config["method"].get<int>();
     }
+
+    // 参数在识别时不再变化，预先创建，识别时不必复制模板路径和阈值列表
+    m_params = std::make_shared<vision::TemplateMatchParams>(createParams());
     
     return true;
 }
 
-RecognitionResult TemplateMatchRecognition::recognize() {
-    RecognitionResult result;
-    
-    // 如果模板列表为空，直接返回失败
-    if (m_templates.empty()) {
-        result.success = false;
-        
-        // 如果设置了inverse，则反转结果
-        if (m_inverse) {
-            result.success = !result.success;
-        }
-        
-        return result;
-    }
-    
-    // 创建模板匹配参数
+// 创建模板匹配参数
+vision::TemplateMatchParams TemplateMatchRecognition::createParams() const {
     vision::TemplateMatchParams params;
     
     // 设置ROI
@@ -93,9 +84,30 @@ RecognitionResult TemplateMatchRecognition::recognize() {
     
     // 设置方法
     params.method = m_method;
+
+    return params;
+}
+
+RecognitionResult TemplateMatchRecognition::recognize(const Frame& frame, const CancellationToken& token) const {
+    RecognitionResult result;
+    
+    // 如果模板列表为空，直接返回失败
+    if (m_templates.empty()) {
+        result.success = false;
+        
+        // 如果设置了inverse，则反转结果
+        if (m_inverse) {
+            result.success = !result.success;
+        }
+        
+        return result;
+    }
+    
+    // 使用预先创建的模板匹配参数
+    const vision::TemplateMatchParams& params = *m_params;
     
     // 执行模板匹配
-    auto visionResult = vision::VisionEngine::templateMatch(params);
+    auto visionResult = vision::VisionEngine::templateMatch(static_cast<vision::VisionHandle>(frame.vision), params);
     
     // 转换结果
     result.success = visionResult.success;
@@ -113,4 +125,28 @@ RecognitionResult TemplateMatchRecognition::recognize() {
     return result;
 }
 
+std::optional<Rect> TemplateMatchRecognition::getRoi() const {
+    return resolveRoi(m_roi, m_roiOffset);
+}
+
+nlohmann::json TemplateMatchRecognition::configToJson() const {
+    return {
+        {"roi", m_roi},
+        {"roi_offset", m_roiOffset},
+        {"template", m_templates},
+        {"threshold", m_thresholds},
+        {"method", m_method}
+    };
+}
+
+void TemplateMatchRecognition::onPrepare() const {
+    // 模板由vision库在匹配时加载，这里只读取一遍文件内容，不存在的模板留给匹配时报告
+    std::vector<char> buffer(64 * 1024);
+    for (const auto& templatePath : m_templates) {
+        std::ifstream file(templatePath, std::ios::binary);
+        while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+        }
+    }
+}
+
 } // namespace Pipeline
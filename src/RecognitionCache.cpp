@@ -0,0 +1,63 @@
+#include "Pipeline/RecognitionCache.h"
+
+namespace Pipeline {
+
+std::optional<RecognitionResult> RecognitionCache::lookup(uint64_t frameId, size_t configHash, const std::string& configKey) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        advanceFrame(frameId);
+
+        auto it = m_entries.find(configHash);
+        if (frameId == m_frameId && it != m_entries.end() && it->second.frameId == m_frameId &&
+            it->second.configKey == configKey) {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second.result;
+        }
+    }
+
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+}
+
+void RecognitionCache::store(uint64_t frameId, size_t configHash, const std::string& configKey, const RecognitionResult& result) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    advanceFrame(frameId);
+    if (frameId != m_frameId) {
+        return;
+    }
+
+    // 哈希冲突时保留本帧先存入的结果，旧帧的条目直接覆盖，复用字符串的内存
+    Entry& entry = m_entries[configHash];
+    if (entry.frameId == m_frameId) {
+        return;
+    }
+    entry.frameId = m_frameId;
+    entry.configKey = configKey;
+    entry.result = result;
+}
+
+void RecognitionCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_frameId = 0;
+}
+
+RecognitionCacheStats RecognitionCache::getStats() const {
+    RecognitionCacheStats stats;
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    stats.misses = m_misses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void RecognitionCache::resetStats() {
+    m_hits.store(0, std::memory_order_relaxed);
+    m_misses.store(0, std::memory_order_relaxed);
+}
+
+void RecognitionCache::advanceFrame(uint64_t frameId) {
+    if (frameId > m_frameId) {
+        m_frameId = frameId;
+    }
+}
+
+} // namespace Pipeline
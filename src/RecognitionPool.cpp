@@ -0,0 +1,35 @@
+#include "Pipeline/RecognitionPool.h"
+
+namespace Pipeline {
+
+std::shared_ptr<const Recognition> RecognitionPool::intern(std::unique_ptr<Recognition> recognition) {
+    if (!recognition) {
+        return nullptr;
+    }
+
+    auto it = m_recognitions.find(recognition->getConfigKey());
+    if (it != m_recognitions.end()) {
+        return it->second;
+    }
+
+    // 复用上一个池中参数相同的识别对象
+    if (m_previous) {
+        auto previous = m_previous->m_recognitions.find(recognition->getConfigKey());
+        if (previous != m_previous->m_recognitions.end()) {
+            m_recognitions.emplace(previous->first, previous->second);
+            return previous->second;
+        }
+    }
+
+    std::shared_ptr<const Recognition> shared = std::move(recognition);
+    m_recognitions.emplace(shared->getConfigKey(), shared);
+    return shared;
+}
+
+void RecognitionPool::insert(const std::shared_ptr<const Recognition>& recognition) {
+    if (recognition) {
+        m_recognitions.emplace(recognition->getConfigKey(), recognition);
+    }
+}
+
+} // namespace Pipeline
@@ -0,0 +1,375 @@
+#include "Pipeline/Runtime.h"
+#include "Pipeline/Task.h"
+#include <algorithm>
+#include <new>
+
+namespace Pipeline {
+
+Runtime::Runtime(size_t workerCount, std::shared_ptr<Clock> clock)
+    : m_clock(clock ? std::move(clock) : Clock::steady()), m_wheel(m_clock->now()) {
+    m_virtualClock = dynamic_cast<VirtualClock*>(m_clock.get());
+    if (workerCount == 0) {
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+Runtime::~Runtime() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    // 未执行的协程由持有它的Task负责销毁，这里只丢弃句柄，postAt分配的定时器在这里释放
+    std::vector<Timer*> timers;
+    m_wheel.clear(timers);
+    for (Timer* timer : timers) {
+        if (timer->owned) {
+            delete timer;
+        }
+    }
+    m_ready.clear();
+    m_readyCount = 0;
+}
+
+void Runtime::post(std::coroutine_handle<> handle) {
+    if (!handle) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pushReady(handle);
+    }
+    m_condition.notify_one();
+}
+
+void Runtime::postAt(std::coroutine_handle<> handle, std::chrono::steady_clock::time_point deadline,
+                     std::shared_ptr<std::atomic<bool>> resumed) {
+    if (!handle) {
+        return;
+    }
+
+    // 调用者不持有定时器，由运行时分配，到期后释放
+    auto* timer = new Timer;
+    timer->deadline = deadline;
+    timer->handle = handle;
+    timer->resumed = resumed.get();
+    timer->resumedHolder = std::move(resumed);
+    timer->owned = true;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    armLocked(*timer);
+}
+
+void Runtime::arm(Timer& timer) {
+    if (!timer.handle) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    armLocked(timer);
+}
+
+bool Runtime::cancel(Timer& timer) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_wheel.cancel(timer);
+}
+
+void Runtime::armLocked(Timer& timer) {
+    m_wheel.arm(timer);
+
+    // 没有工作线程在等待定时器时唤醒一个空闲的工作线程，新定时器更早到期时唤醒等待中的工作线程重新计算等待时间
+    // 工作线程都在忙时不必唤醒，它们在调度间隙会推进时间轮
+    if (!m_hasTimerKeeper) {
+        m_condition.notify_one();
+    } else if (timer.deadline < m_keeperDeadline) {
+        m_condition.notify_all();
+    }
+}
+
+void Runtime::pushReady(std::coroutine_handle<> handle) {
+    // 队列已满时扩容为两倍，按队列顺序重新排列
+    if (m_readyCount == m_ready.size()) {
+        std::vector<std::coroutine_handle<>> grown(std::max<size_t>(m_ready.size() * 2, 64));
+        for (size_t i = 0; i < m_readyCount; ++i) {
+            grown[i] = m_ready[(m_readyHead + i) % m_ready.size()];
+        }
+        m_ready.swap(grown);
+        m_readyHead = 0;
+    }
+
+    m_ready[(m_readyHead + m_readyCount) % m_ready.size()] = handle;
+    ++m_readyCount;
+}
+
+std::coroutine_handle<> Runtime::popReady() {
+    auto handle = m_ready[m_readyHead];
+    m_readyHead = (m_readyHead + 1) % m_ready.size();
+    --m_readyCount;
+    return handle;
+}
+
+size_t Runtime::getTimerCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_wheel.size();
+}
+
+size_t Runtime::getReadyCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_readyCount;
+}
+
+std::shared_ptr<WorkerPool> Runtime::getWorkerPool() {
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    if (!m_workerPool) {
+        m_workerPool = std::make_shared<WorkerPool>();
+    }
+    return m_workerPool;
+}
+
+void Runtime::collectExpired(std::chrono::steady_clock::time_point now) {
+    m_expired.clear();
+    m_wheel.advance(now, m_expired);
+
+    size_t posted = 0;
+    for (Timer* timer : m_expired) {
+        // 其他唤醒源已经恢复协程时丢弃
+        if (!timer->resumed || !timer->resumed->exchange(true)) {
+            pushReady(timer->handle);
+            ++posted;
+        }
+        if (timer->owned) {
+            delete timer;
+        }
+    }
+
+    // 一次到期多个协程时唤醒其他空闲的工作线程一起执行
+    if (posted > 1) {
+        m_condition.notify_all();
+    }
+}
+
+void Runtime::workerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        if (!m_wheel.empty()) {
+            collectExpired(m_clock->now());
+        }
+
+        if (m_stopping) {
+            return;
+        }
+
+        if (m_readyCount > 0) {
+            auto handle = popReady();
+
+            // 没有工作线程在等待定时器时，交给一个空闲的工作线程接替
+            if (!m_hasTimerKeeper && !m_wheel.empty()) {
+                m_condition.notify_one();
+            }
+            ++m_activeWorkers;
+            lock.unlock();
+
+            // 恢复协程，直到它再次挂起或结束
+            handle.resume();
+
+            lock.lock();
+            --m_activeWorkers;
+            continue;
+        }
+
+        if (m_virtualClock) {
+            // 虚拟时间只在没有协程执行时前进，正在执行的协程结束后由它的工作线程推进
+            if (m_activeWorkers == 0 && !m_wheel.empty()) {
+                m_virtualClock->advanceTo(*m_wheel.nextWakeup());
+                continue;
+            }
+            m_condition.wait(lock);
+        } else if (!m_hasTimerKeeper && !m_wheel.empty()) {
+            // 由一个空闲的工作线程等待最近的到期时间，其他工作线程等待新的协程
+            m_hasTimerKeeper = true;
+            m_keeperDeadline = *m_wheel.nextWakeup();
+            m_condition.wait_until(lock, m_keeperDeadline);
+            m_hasTimerKeeper = false;
+        } else {
+            m_condition.wait(lock);
+        }
+    }
+}
+
+// 表示协程已经恢复、取消回调需要由注册方自行注销
+constexpr CancellationToken::CallbackId ResumedCallbackId = static_cast<CancellationToken::CallbackId>(-1);
+
+// 定时等待器的唤醒状态，恢复标志可能在协程恢复后仍被帧源的回调持有，因此共享持有
+// 取消回调只捕获裸指针，注销时等待正在执行的回调结束，唤醒状态在注销之前一直由等待器或await_suspend持有
+struct DelayAwaiter::WakeState {
+    std::atomic<bool> resumed{false};
+    std::atomic<CancellationToken::CallbackId> callbackId{0};
+    Runtime* runtime = nullptr;
+    CancellationToken* token = nullptr;
+    Runtime::Timer timer;
+
+    // 协程在等待中被销毁时定时器仍在时间轮中，取消回调仍在令牌中，在这里取下
+    ~WakeState() {
+        if (runtime && !resumed.load()) {
+            runtime->cancel(timer);
+        }
+        auto id = callbackId.load();
+        if (token && id != ResumedCallbackId) {
+            token->unregisterCallback(id);
+        }
+    }
+};
+
+namespace {
+
+// 唤醒状态的分配器，释放的内存放入空闲链表供之后的等待复用，稳定运行后定时等待不再分配内存
+// 帧源的回调可能在运行时销毁之后仍持有唤醒状态，因此空闲链表属于整个进程，不随运行时释放
+template<typename T>
+class WakeStateAllocator {
+public:
+    using value_type = T;
+
+    WakeStateAllocator() = default;
+    template<typename U>
+    WakeStateAllocator(const WakeStateAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        static_assert(sizeof(T) >= sizeof(FreeBlock), "block too small");
+        if (n == 1) {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            if (s_free) {
+                FreeBlock* block = s_free;
+                s_free = block->next;
+                block->~FreeBlock();
+                return reinterpret_cast<T*>(block);
+            }
+        }
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        if (n != 1) {
+            std::allocator<T>().deallocate(p, n);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_free = new (p) FreeBlock{s_free};
+    }
+
+    template<typename U>
+    bool operator==(const WakeStateAllocator<U>&) const { return true; }
+    template<typename U>
+    bool operator!=(const WakeStateAllocator<U>&) const { return false; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static inline std::mutex s_mutex;
+    static inline FreeBlock* s_free = nullptr;
+};
+
+} // namespace
+
+// 定时等待器在到期前挂起协程
+DelayAwaiter delay(Runtime* runtime, std::chrono::milliseconds duration, CancellationToken* token) {
+    return DelayAwaiter(runtime, (runtime ? runtime->now() : std::chrono::steady_clock::now()) + duration, token);
+}
+
+bool DelayAwaiter::await_ready() const {
+    if ((m_runtime ? m_runtime->now() : std::chrono::steady_clock::now()) >= m_deadline ||
+        (m_token && m_token->isCancelled())) {
+        return true;
+    }
+
+    // 没有运行时时只能阻塞等待
+    if (!m_runtime) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(m_deadline - std::chrono::steady_clock::now());
+        if (m_token) {
+            m_token->waitFor(remaining);
+        } else {
+            std::this_thread::sleep_for(remaining);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+std::shared_ptr<std::atomic<bool>> DelayAwaiter::getResumedFlag() {
+    if (!m_wakeState) {
+        m_wakeState = std::allocate_shared<WakeState>(WakeStateAllocator<WakeState>());
+    }
+    return std::shared_ptr<std::atomic<bool>>(m_wakeState, &m_wakeState->resumed);
+}
+
+void DelayAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    // 协程可能在本函数返回前就在其他线程上恢复，之后只使用局部变量
+    Runtime* runtime = m_runtime;
+    CancellationToken* token = m_token;
+    auto resumed = getResumedFlag();
+    auto state = m_wakeState;
+
+    // 先添加定时器再登记取消回调，取消令牌已经取消时回调立即恢复协程，之后不能再添加定时器
+    state->runtime = runtime;
+    state->token = token;
+    state->timer.deadline = m_deadline;
+    state->timer.handle = handle;
+    state->timer.resumed = &state->resumed;
+    runtime->arm(state->timer);
+
+    if (token) {
+        // 只捕获一个指针，std::function不必为回调分配内存
+        auto id = token->registerCallback([wake = state.get()]() {
+            if (!wake->resumed.exchange(true)) {
+                wake->runtime->post(wake->timer.handle);
+            }
+        });
+
+        // 协程已经恢复时由这里注销回调
+        if (state->callbackId.exchange(id) == ResumedCallbackId) {
+            token->unregisterCallback(id);
+        }
+    }
+}
+
+void DelayAwaiter::await_resume() {
+    if (!m_wakeState) {
+        return;
+    }
+
+    // 由取消或新帧提前唤醒时，定时器仍在时间轮中，直接取下
+    if (m_wakeState->runtime) {
+        m_wakeState->runtime->cancel(m_wakeState->timer);
+    }
+
+    if (m_token) {
+        // 回调尚未登记完成时，由await_suspend负责注销
+        auto id = m_wakeState->callbackId.exchange(ResumedCallbackId);
+        m_token->unregisterCallback(id);
+    }
+}
+
+// 将任务交给运行时调度执行
+void Task::start(Runtime& runtime) {
+    if (m_handle && !done()) {
+        runtime.post(m_handle);
+    }
+}
+
+} // namespace Pipeline
@@ -0,0 +1,172 @@
+#include "Pipeline/TimerWheel.h"
+#include <bit>
+#include <limits>
+
+namespace Pipeline {
+
+TimerWheel::TimerWheel(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::duration tick)
+    : m_start(start), m_tick(tick) {
+}
+
+void TimerWheel::arm(Entry& entry) {
+    if (entry.linked) {
+        unlink(entry);
+        --m_size;
+    }
+    entry.expiry = toTick(entry.deadline);
+    insert(entry);
+    ++m_size;
+}
+
+bool TimerWheel::cancel(Entry& entry) {
+    if (!entry.linked) {
+        return false;
+    }
+    unlink(entry);
+    --m_size;
+    return true;
+}
+
+void TimerWheel::advance(std::chrono::steady_clock::time_point now, std::vector<Entry*>& expired) {
+    if (now < m_start) {
+        return;
+    }
+    uint64_t target = static_cast<uint64_t>((now - m_start) / m_tick);
+
+    while (true) {
+        // 直接跳到下一个有事件的刻度，中间的空刻度不必逐个处理
+        uint64_t next = nextEventTick();
+        if (next > target) {
+            m_current = std::max(m_current, target + 1);
+            return;
+        }
+        m_current = next;
+
+        // 到达上层的槽边界时，先将上层槽中的定时器下移，到期刻度正好是当前刻度的定时器随后一起取出
+        if ((m_current & SlotMask) == 0) {
+            for (int level = 1; level < LevelCount; ++level) {
+                uint64_t block = m_current >> (LevelBits * level);
+                cascade(level, static_cast<uint8_t>(block & SlotMask));
+                if ((block & SlotMask) != 0) {
+                    break;
+                }
+            }
+        }
+
+        // 第0层当前槽中的定时器全部到期
+        uint8_t slot = static_cast<uint8_t>(m_current & SlotMask);
+        while (Entry* entry = m_slots[0][slot]) {
+            unlink(*entry);
+            --m_size;
+            expired.push_back(entry);
+        }
+        ++m_current;
+    }
+}
+
+std::optional<std::chrono::steady_clock::time_point> TimerWheel::nextWakeup() const {
+    uint64_t tick = nextEventTick();
+    if (tick == std::numeric_limits<uint64_t>::max()) {
+        return std::nullopt;
+    }
+    return m_start + m_tick * static_cast<std::chrono::steady_clock::duration::rep>(tick);
+}
+
+void TimerWheel::clear(std::vector<Entry*>& entries) {
+    for (auto& level : m_slots) {
+        for (auto& head : level) {
+            while (head) {
+                Entry* entry = head;
+                unlink(*entry);
+                entries.push_back(entry);
+            }
+        }
+    }
+    m_size = 0;
+}
+
+uint64_t TimerWheel::nextEventTick() const {
+    uint64_t best = std::numeric_limits<uint64_t>::max();
+    for (int level = 0; level < LevelCount; ++level) {
+        if (!m_occupied[level]) {
+            continue;
+        }
+
+        // 从不早于当前刻度的第一个槽边界开始，找到下一个非空的槽
+        int shift = LevelBits * level;
+        uint64_t block = (m_current + (uint64_t{1} << shift) - 1) >> shift;
+        uint64_t rotated = std::rotr(m_occupied[level], static_cast<int>(block & SlotMask));
+        uint64_t tick = (block + static_cast<uint64_t>(std::countr_zero(rotated))) << shift;
+        best = std::min(best, tick);
+    }
+    return best;
+}
+
+void TimerWheel::insert(Entry& entry) {
+    // 已经到期的定时器放在当前刻度的槽中
+    uint64_t expiry = std::max(entry.expiry, m_current);
+    uint64_t delta = expiry - m_current;
+
+    int level = 0;
+    while (level < LevelCount - 1 && delta >= (uint64_t{1} << (LevelBits * (level + 1)))) {
+        ++level;
+    }
+
+    // 超出时间轮范围的定时器放在最高层最远的槽中，下移时重新计算位置
+    if (delta >= (uint64_t{1} << (LevelBits * LevelCount))) {
+        expiry = m_current + (uint64_t{1} << (LevelBits * LevelCount)) - 1;
+    }
+
+    uint8_t slot = static_cast<uint8_t>((expiry >> (LevelBits * level)) & SlotMask);
+    Entry*& head = m_slots[level][slot];
+    entry.prev = nullptr;
+    entry.next = head;
+    if (head) {
+        head->prev = &entry;
+    }
+    head = &entry;
+    entry.level = static_cast<uint8_t>(level);
+    entry.slot = slot;
+    entry.linked = true;
+    m_occupied[level] |= uint64_t{1} << slot;
+}
+
+void TimerWheel::unlink(Entry& entry) {
+    Entry*& head = m_slots[entry.level][entry.slot];
+    if (entry.prev) {
+        entry.prev->next = entry.next;
+    } else {
+        head = entry.next;
+    }
+    if (entry.next) {
+        entry.next->prev = entry.prev;
+    }
+    if (!head) {
+        m_occupied[entry.level] &= ~(uint64_t{1} << entry.slot);
+    }
+    entry.prev = nullptr;
+    entry.next = nullptr;
+    entry.linked = false;
+}
+
+void TimerWheel::cascade(int level, uint8_t slot) {
+    Entry* entry = m_slots[level][slot];
+    m_slots[level][slot] = nullptr;
+    m_occupied[level] &= ~(uint64_t{1} << slot);
+
+    while (entry) {
+        Entry* next = entry->next;
+        insert(*entry);
+        entry = next;
+    }
+}
+
+uint64_t TimerWheel::toTick(std::chrono::steady_clock::time_point time) const {
+    if (time <= m_start) {
+        return 0;
+    }
+    auto elapsed = time - m_start;
+    return static_cast<uint64_t>((elapsed + m_tick - std::chrono::steady_clock::duration(1)) / m_tick);
+}
+
+} // namespace Pipeline
@@ -0,0 +1,88 @@
+#include "Pipeline/TransitionModel.h"
+#include <algorithm>
+
+namespace Pipeline {
+
+void TransitionModel::record(NodeId from, NodeId to, uint64_t count) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Row& row = m_rows[from];
+    row.counts[to] += count;
+    row.total += count;
+}
+
+std::vector<NodeId> TransitionModel::predict(NodeId from, size_t count) const {
+    std::vector<NodeId> predicted;
+    predict(from, count, predicted);
+    return predicted;
+}
+
+void TransitionModel::predict(NodeId from, size_t count, std::vector<NodeId>& predicted) const {
+    predicted.clear();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_rows.find(from);
+    if (it == m_rows.end()) {
+        return;
+    }
+
+    // 转移次数多的在前，次数相同时节点ID小的在前
+    auto before = [](const std::pair<const NodeId, uint64_t>& a, const std::pair<const NodeId, uint64_t>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+
+    // 只需要前几个，每次选出排在上一个之后的第一个，不必复制和排序整行
+    const std::pair<const NodeId, uint64_t>* last = nullptr;
+    while (predicted.size() < count) {
+        const std::pair<const NodeId, uint64_t>* best = nullptr;
+        for (const auto& successor : it->second.counts) {
+            if ((!last || before(*last, successor)) && (!best || before(successor, *best))) {
+                best = &successor;
+            }
+        }
+        if (!best) {
+            break;
+        }
+        predicted.push_back(best->first);
+        last = best;
+    }
+}
+
+uint64_t TransitionModel::getCount(NodeId from, NodeId to) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto row = m_rows.find(from);
+    if (row == m_rows.end()) {
+        return 0;
+    }
+    auto it = row->second.counts.find(to);
+    return it != row->second.counts.end() ? it->second : 0;
+}
+
+double TransitionModel::getProbability(NodeId from, NodeId to) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto row = m_rows.find(from);
+    if (row == m_rows.end() || row->second.total == 0) {
+        return 0.0;
+    }
+    auto it = row->second.counts.find(to);
+    uint64_t transitions = it != row->second.counts.end() ? it->second : 0;
+    return static_cast<double>(transitions) / static_cast<double>(row->second.total);
+}
+
+std::vector<Transition> TransitionModel::getTransitions() const {
+    std::vector<Transition> transitions;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [from, row] : m_rows) {
+        for (const auto& [to, count] : row.counts) {
+            transitions.push_back(Transition{from, to, count});
+        }
+    }
+    return transitions;
+}
+
+void TransitionModel::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rows.clear();
+}
+
+} // namespace Pipeline
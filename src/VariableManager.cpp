@@ -75,6 +75,7 @@ bool Variable::fromString(const std::string& str) {
 
 // 定义变量
 bool VariableManager::defineVariable(const std::string& name, VariableType type) {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     // 检查变量名是否合法
     if (name.empty() || name[0] != '%') {
         return false;
@@ -87,6 +88,7 @@ bool VariableManager::defineVariable(const std::string& name, VariableType type)
 
 // 定义并初始化变量
 bool VariableManager::defineVariable(const std::string& name, VariableType type, const std::string& value) {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     // 检查变量名是否合法
     if (name.empty() || name[0] != '%') {
         return false;
@@ -107,6 +109,7 @@ bool VariableManager::defineVariable(const std::string& name, VariableType type,
 
 // 获取变量
 std::optional<Variable> VariableManager::getVariable(const std::string& name) const {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     auto it = m_variables.find(name);
     if (it != m_variables.end()) {
         return it->second;
@@ -116,6 +119,7 @@ std::optional<Variable> VariableManager::getVariable(const std::string& name) co
 
 // 设置变量值
 bool VariableManager::setVariable(const std::string& name, const VariableValue& value) {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     auto it = m_variables.find(name);
     if (it != m_variables.end()) {
         // 检查类型是否匹配
@@ -142,6 +146,24 @@ bool VariableManager::setVariable(const std::string& name, const VariableValue&
     return false;
 }
 
+// 获取所有变量的快照
+std::vector<std::pair<std::string, Variable>> VariableManager::getVariables() const {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    std::vector<std::pair<std::string, Variable>> variables(m_variables.begin(), m_variables.end());
+    std::sort(variables.begin(), variables.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    return variables;
+}
+
+// 用快照替换所有变量
+void VariableManager::restoreVariables(const std::vector<std::pair<std::string, Variable>>& variables) {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_variables.clear();
+    for (const auto& [name, variable] : variables) {
+        m_variables[name] = variable;
+    }
+}
+
 // 从变量名解析变量类型
 VariableType VariableManager::getTypeFromName(const std::string& name) const {
     if (name.size() < 2) {
@@ -169,6 +191,7 @@ VariableType VariableManager::getTypeFromName(const std::string& name) const {
 
 // 解析变量定义字符串
 bool VariableManager::parseVariableDefinition(const std::string& definition) {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     // 检查变量定义是否合法
     if (definition.empty() || definition[0] != '%') {
         return false;
@@ -193,6 +216,7 @@ bool VariableManager::parseVariableDefinition(const std::string& definition) {
 
 // 解析变量列表
 bool VariableManager::parseVariableList(const std::vector<std::string>& definitions) {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     bool success = true;
 
     for (const auto& definition : definitions) {
@@ -206,6 +230,7 @@ bool VariableManager::parseVariableList(const std::vector<std::string>& definiti
 
 // 计算条件表达式
 bool VariableManager::evaluateCondition(const std::string& condition) {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     // 简单条件解析，支持 <, >, <=, >=, ==, != 操作符
 
     // 查找比较操作符
@@ -395,10 +420,12 @@ bool VariableManager::evaluateCondition(const std::string& condition) {
 
 // 处理日志字符串，替换变量并执行操作
 std::string VariableManager::processLogString(const std::string& logStr) {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     std::string result = logStr;
 
     // 查找并执行花括号中的变量操作
-    std::regex operationRegex("\\{([^{}]+)\\}");
+    // 正则表达式只编译一次
+    static const std::regex operationRegex("\\{([^{}]+)\\}");
     std::smatch match;
     std::string tempStr = logStr;
 
@@ -424,7 +451,7 @@ std::string VariableManager::replaceVariableReferences(const std::string& str) {
     std::string result = str;
 
     // 查找变量引用（方括号中的变量）
-    std::regex varRefRegex("\\[(\\%[^\\[\\]]+)\\]");
+    static const std::regex varRefRegex("\\[(\\%[^\\[\\]]+)\\]");
     std::smatch match;
     std::string tempStr = str;
 
@@ -447,6 +474,7 @@ std::string VariableManager::replaceVariableReferences(const std::string& str) {
 
 // 执行变量操作表达式
 bool VariableManager::executeExpression(const std::string& expression) {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     return executeVariableOperation(expression);
 }
 
@@ -601,7 +629,7 @@ VariableValue VariableManager::evaluateArithmeticExpression(const std::string& e
 
     // 首先将表达式中的变量替换为其值
     std::string expr = expression;
-    std::regex varRegex("\\%[a-zA-Z0-9_]+");
+    static const std::regex varRegex("\\%[a-zA-Z0-9_]+");
     std::smatch match;
 
     while (std::regex_search(expr, match, varRegex)) {
@@ -0,0 +1,89 @@
+#include "Pipeline/WindowFrameSource.h"
+#include "vision/engine/WindowVision.h"
+
+namespace Pipeline {
+
+WindowFrameSource::WindowFrameSource(vision::WindowVision* windowVision, void* hwnd, std::shared_ptr<Clock> clock)
+    : m_windowVision(windowVision), m_hwnd(hwnd), m_clock(clock ? std::move(clock) : Clock::steady()) {
+}
+
+Frame WindowFrameSource::capture() {
+    Frame frame;
+    if (!m_windowVision) {
+        return frame;
+    }
+
+    // 获取窗口当前的帧快照
+    auto windowFrame = m_windowVision->acquireFrame(static_cast<HWND>(m_hwnd));
+    if (!windowFrame) {
+        return frame;
+    }
+
+    frame.epoch = windowFrame->epoch;
+    // 窗口图像按steady_clock记录截取时间，流水线按运行时的时钟比较，两者在虚拟时钟下不可比
+    // 按图像已经存在的实际时长换算到流水线的时钟上，缓存帧仍然早于取出的时间
+    auto age = std::chrono::steady_clock::now() - windowFrame->captureTime;
+    frame.captureTime = m_clock->now() - age;
+    frame.vision = windowFrame->vision;
+    frame.holder = windowFrame;
+    frame.source = this;
+    return frame;
+}
+
+bool WindowFrameSource::waitForNewFrame(uint64_t lastEpoch, std::chrono::milliseconds maxWait) {
+    if (!m_windowVision) {
+        return FrameSource::waitForNewFrame(lastEpoch, maxWait);
+    }
+
+    return m_windowVision->waitForUpdate(static_cast<HWND>(m_hwnd), lastEpoch, maxWait);
+}
+
+bool WindowFrameSource::notifyOnNewFrame(uint64_t lastEpoch, const void* key, std::function<void()> callback) {
+    if (!m_windowVision) {
+        return false;
+    }
+
+    m_windowVision->notifyOnUpdate(static_cast<HWND>(m_hwnd), lastEpoch, key, std::move(callback));
+    return true;
+}
+
+void WindowFrameSource::cancelNewFrameNotification(const void* key) {
+    if (m_windowVision) {
+        m_windowVision->cancelUpdateNotification(key);
+    }
+}
+
+std::optional<double> WindowFrameSource::compareRegion(const Frame& previous, const Frame& current,
+                                                       const std::optional<Rect>& roi) {
+    // 帧数据由capture()放在holder中，先确认两帧都是本帧源产生的，holder的类型才确定
+    if (previous.source != this || current.source != this || !previous.holder || !current.holder) {
+        return std::nullopt;
+    }
+
+    const cv::Mat& previousImage = static_cast<const vision::WindowFrame*>(previous.holder.get())->image;
+    const cv::Mat& currentImage = static_cast<const vision::WindowFrame*>(current.holder.get())->image;
+    if (previousImage.empty() || currentImage.empty()) {
+        return std::nullopt;
+    }
+
+    // 窗口大小或格式变化时整个画面都变了
+    if (previousImage.size() != currentImage.size() || previousImage.type() != currentImage.type()) {
+        return 1.0;
+    }
+
+    // roi为左上角和右下角坐标，裁剪到图像范围内
+    cv::Rect region(0, 0, currentImage.cols, currentImage.rows);
+    if (roi) {
+        region &= cv::Rect(cv::Point(roi->x1, roi->y1), cv::Point(roi->x2, roi->y2));
+    }
+    if (region.empty()) {
+        return std::nullopt;
+    }
+
+    // 直接对两个区域求L1范数，不生成差值图像，稳定检测的每次采样都不分配内存
+    double total = cv::norm(previousImage(region), currentImage(region), cv::NORM_L1);
+    double maxTotal = 255.0 * region.area() * currentImage.channels();
+    return total / maxTotal;
+}
+
+} // namespace Pipeline
@@ -0,0 +1,59 @@
+#include "Pipeline/WorkerPool.h"
+#include <algorithm>
+
+namespace Pipeline {
+
+WorkerPool::WorkerPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void WorkerPool::post(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void WorkerPool::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+
+            // 停止时先执行完队列中剩余的任务
+            if (m_jobs.empty()) {
+                return;
+            }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        job();
+    }
+}
+
+} // namespace Pipeline
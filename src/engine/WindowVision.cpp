@@ -1,142 +1,216 @@
 #include "vision/engine/WindowVision.h"
+#include <algorithm>
+#include <atomic>
 
 namespace vision {
 
+// WindowFrame析构函数
+WindowFrame::~WindowFrame() {
+    if (vision) {
+        VisionDestroy(vision);
+    }
+}
+
 // 构造函数
 WindowVision::WindowVision(int cacheTimeoutMs) : m_cacheTimeoutMs(cacheTimeoutMs) {
 }
 
 // 析构函数
 WindowVision::~WindowVision() {
-    // 清理所有Vision对象
+    // 释放所有帧快照，Vision对象随最后一个引用一起销毁
     std::unique_lock<std::shared_mutex> lock(m_mutex);
-    for (auto& pair : m_visionObjects) {
-        if (pair.second) {
-            VisionDestroy(pair.second);
-        }
-    }
-    m_visionObjects.clear();
-    m_windowImages.clear();
+    m_windows.clear();
 }
 
 // 更新窗口图像
 void WindowVision::updateWindowImage(HWND hwnd, const unsigned char* data, int width, int height, int channels) {
-    std::unique_lock<std::shared_mutex> lock(m_mutex);
-    
-    // 更新图像缓存
+    // 取出上一个快照，只有窗口缓存还持有它时才能复用；被识别等持有的快照保持不变，另建新的快照（写时复制）
+    // 取出后acquireFrame无法再获取它，引用计数为1说明没有其他持有者，可以在锁外修改
+    std::shared_ptr<WindowFrame> frame;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        frame = std::move(m_windows[hwnd].spare);
+    }
+    if (!frame || frame.use_count() != 1) {
+        frame = std::make_shared<WindowFrame>();
+        frame->vision = VisionCreate();
+    } else {
+        // 与其他持有者释放引用时的递减同步，它们对快照的读取都在修改之前完成
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
+    // 在锁外写入图像，避免阻塞正在读取当前帧的线程；尺寸和格式不变时复用图像缓冲区和Vision对象
     cv::Mat image(height, width, channels == 3 ? CV_8UC3 : CV_8UC4, (void*)data);
-    m_windowImages[hwnd] = image.clone();
-    m_lastUpdateTime[hwnd] = std::chrono::steady_clock::now();
-    
-    // 确保该窗口有对应的Vision对象
-    if (m_visionObjects.find(hwnd) == m_visionObjects.end()) {
-        m_visionObjects[hwnd] = VisionCreate();
+    image.copyTo(frame->image);
+    frame->captureTime = std::chrono::steady_clock::now();
+    VisionSetScreenshot(frame->vision, data, width, height, channels);
+
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        frame->epoch = m_nextEpoch++;
+        WindowState& window = m_windows[hwnd];
+        window.spare = std::move(window.current);
+        window.current = std::move(frame);
+
+        // 取出该窗口的更新回调，新帧的序号一定大于回调注册时的帧序号
+        auto it = std::remove_if(m_updateCallbacks.begin(), m_updateCallbacks.end(), [&](UpdateCallback& entry) {
+            if (entry.hwnd != hwnd) {
+                return false;
+            }
+            callbacks.push_back(std::move(entry.callback));
+            return true;
+        });
+        m_updateCallbacks.erase(it, m_updateCallbacks.end());
+    }
+
+    // 唤醒等待新帧的线程
+    m_updateCondition.notify_all();
+
+    // 在锁外调用回调
+    for (auto& callback : callbacks) {
+        callback();
     }
-    
-    // 更新Vision对象的截图
-    VisionSetScreenshot(m_visionObjects[hwnd], data, width, height, channels);
 }
 
-// 获取窗口对应的Vision对象
-VisionHandle WindowVision::getVisionObject(HWND hwnd) {
+// 注册一次性的更新回调
+void WindowVision::notifyOnUpdate(HWND hwnd, uint64_t lastEpoch, const void* key, std::function<void()> callback) {
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_windows.find(hwnd);
+        if (it == m_windows.end() || !it->second.current || it->second.current->epoch <= lastEpoch) {
+            m_updateCallbacks.push_back({hwnd, lastEpoch, key, std::move(callback)});
+            return;
+        }
+    }
+
+    // 已经有更新的帧
+    callback();
+}
+
+// 注销更新回调
+void WindowVision::cancelUpdateNotification(const void* key) {
+    std::function<void()> callback;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        auto it = std::find_if(m_updateCallbacks.begin(), m_updateCallbacks.end(),
+                               [key](const UpdateCallback& entry) { return entry.key == key; });
+        if (it == m_updateCallbacks.end()) {
+            return;
+        }
+
+        // 回调持有的状态在锁外释放
+        callback = std::move(it->callback);
+        m_updateCallbacks.erase(it);
+    }
+}
+
+// 等待窗口图像更新
+bool WindowVision::waitForUpdate(HWND hwnd, uint64_t lastEpoch, std::chrono::milliseconds timeout) {
     std::shared_lock<std::shared_mutex> lock(m_mutex);
-    
-    auto it = m_visionObjects.find(hwnd);
-    if (it == m_visionObjects.end()) {
+    return m_updateCondition.wait_for(lock, timeout, [&]() {
+        auto it = m_windows.find(hwnd);
+        return it != m_windows.end() && it->second.current && it->second.current->epoch > lastEpoch;
+    });
+}
+
+// 获取窗口当前的帧快照
+std::shared_ptr<const WindowFrame> WindowVision::acquireFrame(HWND hwnd) {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+    auto it = m_windows.find(hwnd);
+    if (it == m_windows.end() || !it->second.current) {
         return nullptr;
     }
-    
+
     // 检查缓存是否过期
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now - m_lastUpdateTime[hwnd]).count();
+        now - it->second.current->captureTime).count();
     if (elapsed > m_cacheTimeoutMs) {
         return nullptr; // 缓存过期
     }
-    
-    return it->second;
+
+    return it->second.current;
+}
+
+// 获取窗口对应的Vision对象
+VisionHandle WindowVision::getVisionObject(HWND hwnd) {
+    auto frame = acquireFrame(hwnd);
+    return frame ? frame->vision : nullptr;
 }
 
 // 执行找色操作
 bool WindowVision::findColor(HWND hwnd, int x1, int y1, int x2, int y2, const char* color, double sim, int dir, int* outX, int* outY) {
-    // 获取Vision对象
-    VisionHandle vision = getVisionObject(hwnd);
-    if (!vision) {
+    // 获取帧快照，持有快照保证执行期间Vision对象有效
+    auto frame = acquireFrame(hwnd);
+    if (!frame) {
         return false;
     }
     
     // 直接使用Vision对象执行操作
-    return VisionFindColor(vision, x1, y1, x2, y2, color, sim, dir, outX, outY);
+    return VisionFindColor(frame->vision, x1, y1, x2, y2, color, sim, dir, outX, outY);
 }
 
 // 执行多点找色操作
 bool WindowVision::findMultiColor(HWND hwnd, int x1, int y1, int x2, int y2, const char* firstColor, const char* offsetColor, double sim, int dir, int* outX, int* outY) {
-    VisionHandle vision = getVisionObject(hwnd);
-    if (!vision) {
+    auto frame = acquireFrame(hwnd);
+    if (!frame) {
         return false;
     }
     
-    return VisionFindMultiColor(vision, x1, y1, x2, y2, firstColor, offsetColor, sim, dir, outX, outY);
+    return VisionFindMultiColor(frame->vision, x1, y1, x2, y2, firstColor, offsetColor, sim, dir, outX, outY);
 }
 
 // 执行模板匹配操作
 bool WindowVision::templateMatch(HWND hwnd, int x1, int y1, int x2, int y2, const char* templatePath, double threshold, int method, int* outX, int* outY, double* outScore) {
-    VisionHandle vision = getVisionObject(hwnd);
-    if (!vision) {
+    auto frame = acquireFrame(hwnd);
+    if (!frame) {
         return false;
     }
     
-    return VisionTemplateMatch(vision, x1, y1, x2, y2, templatePath, threshold, method, outX, outY, outScore);
+    return VisionTemplateMatch(frame->vision, x1, y1, x2, y2, templatePath, threshold, method, outX, outY, outScore);
 }
 
 // 执行OCR操作
 bool WindowVision::ocr(HWND hwnd, int x1, int y1, int x2, int y2, const char* expected, char* outText, int outTextSize) {
-    VisionHandle vision = getVisionObject(hwnd);
-    if (!vision) {
+    auto frame = acquireFrame(hwnd);
+    if (!frame) {
         return false;
     }
     
-    return VisionOcr(vision, x1, y1, x2, y2, expected, outText, outTextSize);
+    return VisionOcr(frame->vision, x1, y1, x2, y2, expected, outText, outTextSize);
 }
 
 // 执行批量OCR操作
 int WindowVision::ocrBatch(HWND hwnd, int x1, int y1, int x2, int y2, const char* expected, char* outResults, int outResultsSize) {
-    VisionHandle vision = getVisionObject(hwnd);
-    if (!vision) {
+    auto frame = acquireFrame(hwnd);
+    if (!frame) {
         return 0;
     }
     
-    return VisionOcrBatch(vision, x1, y1, x2, y2, expected, outResults, outResultsSize);
+    return VisionOcrBatch(frame->vision, x1, y1, x2, y2, expected, outResults, outResultsSize);
 }
 
 // 获取窗口图像的ROI区域
 cv::Mat WindowVision::getWindowROI(HWND hwnd, int x1, int y1, int x2, int y2) {
-    std::shared_lock<std::shared_mutex> lock(m_mutex);
-    
-    auto it = m_windowImages.find(hwnd);
-    if (it == m_windowImages.end()) {
+    auto frame = acquireFrame(hwnd);
+    if (!frame) {
         return cv::Mat();
     }
-    
-    // 检查缓存是否过期
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now - m_lastUpdateTime[hwnd]).count();
-    if (elapsed > m_cacheTimeoutMs) {
-        return cv::Mat(); // 缓存过期
-    }
+    const cv::Mat& image = frame->image;
     
     // 获取ROI
     cv::Rect roi(x1, y1, x2 - x1, y2 - y1);
     if (roi.x < 0 || roi.y < 0 || roi.width <= 0 || roi.height <= 0 ||
-        roi.x + roi.width > it->second.cols || roi.y + roi.height > it->second.rows) {
-        roi = roi & cv::Rect(0, 0, it->second.cols, it->second.rows);
+        roi.x + roi.width > image.cols || roi.y + roi.height > image.rows) {
+        roi = roi & cv::Rect(0, 0, image.cols, image.rows);
         if (roi.width <= 0 || roi.height <= 0) {
             return cv::Mat();
         }
     }
     
-    return it->second(roi).clone();
+    return image(roi).clone();
 }
 
 } // namespace vision
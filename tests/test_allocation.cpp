@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <PipelineLib.h>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <optional>
+#include <cstdlib>
+#include <new>
+
+// 替换全局operator new，统计整个进程的堆分配次数
+// 数组形式和释放函数的默认实现都转发到这里，不必另外替换
+static std::atomic<uint64_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// 每次采集都产生新帧的帧源，在指定的采集次数读取分配计数
+// 每轮候选节点评估和每次画面稳定采样各采集一帧，画面从不变化
+class CountingFrameSource : public Pipeline::FrameSource {
+public:
+    CountingFrameSource(std::shared_ptr<Pipeline::Clock> clock, uint64_t warmupTicks, uint64_t measuredTicks)
+        : m_clock(std::move(clock)), m_warmupTicks(warmupTicks), m_measuredTicks(measuredTicks) {}
+
+    Pipeline::Frame capture() override {
+        uint64_t id = ++m_counter;
+        if (id == m_warmupTicks) {
+            m_start = g_allocations.load();
+        } else if (id == m_warmupTicks + m_measuredTicks) {
+            m_end = g_allocations.load();
+            m_measured = true;
+        }
+
+        // 帧的采集时间与流水线使用同一个时钟，否则会被当作动作之前的过时帧
+        Pipeline::Frame frame;
+        frame.epoch = id;
+        frame.captureTime = m_clock->now();
+        return frame;
+    }
+
+    std::optional<double> compareRegion(const Pipeline::Frame&, const Pipeline::Frame&,
+                                        const std::optional<Pipeline::Rect>& roi) override {
+        if (roi) {
+            m_comparedRoi = true;
+        }
+        return 0.0;
+    }
+
+    bool isMeasured() const { return m_measured; }
+    bool hasComparedRoi() const { return m_comparedRoi; }
+    uint64_t getAllocations() const { return m_end - m_start; }
+
+private:
+    std::shared_ptr<Pipeline::Clock> m_clock;
+    uint64_t m_warmupTicks;
+    uint64_t m_measuredTicks;
+    std::atomic<uint64_t> m_counter{0};
+    std::atomic<uint64_t> m_start{0};
+    std::atomic<uint64_t> m_end{0};
+    std::atomic<bool> m_measured{false};
+    std::atomic<bool> m_comparedRoi{false};
+};
+
+// 测试稳定运行后执行节点不分配堆内存
+// 覆盖定时等待、让出执行权、识别缓存、自适应评估顺序和按识别区域的画面稳定检测，不包含日志、条件表达式和并行评估
+TEST(AllocationTest, SteadyStateTick) {
+#ifdef _WIN32
+    // Windows下动态库使用自己的operator new，替换只对测试程序本身生效
+    GTEST_SKIP() << "operator new replacement does not reach the DLL";
+#endif
+
+    const std::string pipelineJson = R"({
+        "A": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 100,
+            "order": "adaptive",
+            "next": ["C", "B"]
+        },
+        "B": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 100,
+            "next": ["S"]
+        },
+        "S": {
+            "recognition": "DirectHit",
+            "roi": [10, 10, 110, 60],
+            "action": "DoNothing",
+            "pre_delay": "stable",
+            "stable_interval": 10,
+            "post_delay": 100,
+            "next": ["A"]
+        },
+        "C": {
+            "recognition": "DirectHit",
+            "inverse": true,
+            "pre_delay": 0
+        }
+    })";
+
+    // 虚拟时钟下后置延迟不消耗实际时间，几千个节点很快执行完
+    auto clock = std::make_shared<Pipeline::VirtualClock>();
+    auto runtime = std::make_shared<Pipeline::Runtime>(1, clock);
+    auto frameSource = std::make_shared<CountingFrameSource>(clock, 1000, 1000);
+    Pipeline::PipelineExecutor executor(runtime);
+    executor.setFrameSource(frameSource);
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "A"));
+
+    auto startTime = std::chrono::steady_clock::now();
+    while (!frameSource->isMeasured() && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(10)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    executor.stop();
+
+    ASSERT_TRUE(frameSource->isMeasured());
+    EXPECT_TRUE(frameSource->hasComparedRoi());
+    EXPECT_EQ(frameSource->getAllocations(), 0u);
+}
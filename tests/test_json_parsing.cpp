@@ -86,9 +86,326 @@ TEST(JsonParsingTest, MissingNode) {
         // 缺少Orange和Banana节点
     })";
     
-    // 测试从字符串加载流水线
-    EXPECT_TRUE(executor.executeFromString(missingNodeJson, "StartFruit"));
+    // 引用了不存在的节点，加载时直接失败
+    EXPECT_FALSE(executor.executeFromString(missingNodeJson, "StartFruit"));
     
     // 测试使用不存在的节点启动流水线
     EXPECT_FALSE(executor.executeFromString(missingNodeJson, "NonExistentNode"));
 }
+
+TEST(JsonParsingTest, NodeIdResolution) {
+    const std::string pipelineJson = R"({
+        "var_global": ["%icount=0"],
+        "Start": {
+            "next": ["End"],
+            "on_error": "End",
+            "condition_process": {
+                "true": {"override_next": ["Start"]}
+            }
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "DoNothing"
+        }
+    })";
+    
+    Pipeline::Pipeline pipeline;
+    ASSERT_TRUE(pipeline.loadFromString(pipelineJson));
+    
+    // var_global不是节点
+    EXPECT_EQ(pipeline.getNodeCount(), 2u);
+    EXPECT_EQ(pipeline.getNodeId("var_global"), Pipeline::InvalidNodeId);
+    
+    auto start = pipeline.getNode("Start");
+    ASSERT_NE(start, nullptr);
+    ASSERT_EQ(start->getNextNodeIds().size(), 1u);
+    EXPECT_EQ(start->getNextNodeIds()[0], pipeline.getNodeId("End"));
+    ASSERT_EQ(start->getOnErrorNodeIds().size(), 1u);
+    EXPECT_EQ(start->getOnErrorNodeIds()[0], pipeline.getNodeId("End"));
+    
+    // 条件处理分支中的重写节点同样在加载时解析
+    auto branch = start->processCondition(pipeline.getVariableManager(), true);
+    ASSERT_EQ(start->getNextNodeIds(branch).size(), 1u);
+    EXPECT_EQ(start->getNextNodeIds(branch)[0], pipeline.getNodeId("Start"));
+    // 节点本身不保存生效的分支
+    EXPECT_EQ(start->getNextNodeIds()[0], pipeline.getNodeId("End"));
+}
+
+TEST(JsonParsingTest, DanglingOverrideNode) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "next": ["End"],
+            "condition_process": {
+                "false": {"override_next": ["Missing"]}
+            }
+        },
+        "End": {}
+    })";
+    
+    Pipeline::Pipeline pipeline;
+    EXPECT_FALSE(pipeline.loadFromString(pipelineJson));
+}
+
+// 测试参数相同的识别对象在节点之间共享
+TEST(JsonParsingTest, RecognitionInterning) {
+    const std::string pipelineJson = R"({
+        "CloseA": {
+            "recognition": {"type": "FindColor", "roi": [0, 0, 100, 100], "color": "FFFFFF", "similarity": 0.9}
+        },
+        "CloseB": {
+            "recognition": {"similarity": 0.9, "color": "FFFFFF", "roi": [0, 0, 100, 100], "type": "FindColor"},
+            "action": "Click"
+        },
+        "CloseInverse": {
+            "recognition": {"type": "FindColor", "roi": [0, 0, 100, 100], "color": "FFFFFF", "similarity": 0.9},
+            "inverse": true
+        },
+        "Other": {
+            "recognition": {"type": "FindColor", "roi": [0, 0, 100, 100], "color": "000000", "similarity": 0.9}
+        }
+    })";
+
+    Pipeline::Pipeline pipeline;
+    ASSERT_TRUE(pipeline.loadFromString(pipelineJson));
+    EXPECT_EQ(pipeline.getRecognitionCount(), 3u);
+
+    auto closeA = pipeline.getNode("CloseA");
+    auto closeB = pipeline.getNode("CloseB");
+    auto closeInverse = pipeline.getNode("CloseInverse");
+    auto other = pipeline.getNode("Other");
+    ASSERT_NE(closeA, nullptr);
+    ASSERT_NE(closeB, nullptr);
+    ASSERT_NE(closeInverse, nullptr);
+    ASSERT_NE(other, nullptr);
+
+    // 参数书写顺序不同但内容相同的识别共享同一个对象
+    EXPECT_EQ(closeA->getRecognition(), closeB->getRecognition());
+    EXPECT_NE(closeA->getRecognition(), closeInverse->getRecognition());
+    EXPECT_NE(closeA->getRecognition(), other->getRecognition());
+    EXPECT_TRUE(closeInverse->getRecognition()->isInverse());
+}
+
+// 测试候选节点评估顺序的解析
+TEST(JsonParsingTest, CandidateOrder) {
+    auto definition = Pipeline::PipelineDefinition::loadFromString(R"({
+        "Adaptive": {"order": "adaptive"},
+        "List": {"order": "list"},
+        "Default": {}
+    })");
+    ASSERT_NE(definition, nullptr);
+    EXPECT_TRUE(definition->getNode("Adaptive")->isAdaptiveOrder());
+    EXPECT_FALSE(definition->getNode("List")->isAdaptiveOrder());
+    EXPECT_FALSE(definition->getNode("Default")->isAdaptiveOrder());
+
+    // 未知的评估顺序
+    EXPECT_EQ(Pipeline::PipelineDefinition::loadFromString(R"({
+        "Start": {"order": "random"}
+    })"), nullptr);
+}
+
+// 测试热重载保留没有变化的节点和变量
+TEST(JsonParsingTest, HotReload) {
+    const std::string pipelineJson = R"({
+        "var_global": ["%iCount=1"],
+        "Start": {
+            "recognition": {"type": "FindColor", "color": "FFFFFF"},
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit"
+        }
+    })";
+
+    Pipeline::Pipeline pipeline;
+    ASSERT_TRUE(pipeline.loadFromString(pipelineJson));
+    auto start = pipeline.getNode("Start");
+    auto end = pipeline.getNode("End");
+    ASSERT_NE(start, nullptr);
+    ASSERT_NE(end, nullptr);
+    pipeline.getVariableManager().setVariable("%iCount", Pipeline::VariableValue(5));
+
+    // 修改End，新增Extra，Start保持不变
+    const std::string reloadedJson = R"({
+        "var_global": ["%iCount=1", "%iTotal=3"],
+        "Extra": {
+            "recognition": {"type": "FindColor", "color": "FFFFFF"}
+        },
+        "Start": {
+            "next": ["End"],
+            "recognition": {"color": "FFFFFF", "type": "FindColor"}
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "next": ["Extra"]
+        }
+    })";
+    ASSERT_TRUE(pipeline.reloadFromString(reloadedJson));
+    EXPECT_FALSE(pipeline.hasPendingReload());
+    EXPECT_EQ(pipeline.getNodeCount(), 3u);
+
+    // 没有变化的节点被保留，已有节点的节点ID不变，新节点追加在末尾
+    EXPECT_EQ(pipeline.getNode("Start"), start);
+    EXPECT_NE(pipeline.getNode("End"), end);
+    EXPECT_EQ(pipeline.getNodeId("End"), end->getId());
+    EXPECT_EQ(pipeline.getNodeId("Extra"), 2u);
+
+    // 参数相同的识别对象被复用
+    EXPECT_EQ(pipeline.getNode("Extra")->getRecognition(), start->getRecognition());
+
+    // 已有变量保持当前值，新变量按定义初始化
+    auto count = pipeline.getVariableManager().getVariable("%iCount");
+    auto total = pipeline.getVariableManager().getVariable("%iTotal");
+    ASSERT_TRUE(count.has_value());
+    ASSERT_TRUE(total.has_value());
+    EXPECT_EQ(count->getValue<int>(), 5);
+    EXPECT_EQ(total->getValue<int>(), 3);
+
+    // 引用了不存在的节点时重载失败，当前定义不受影响
+    EXPECT_FALSE(pipeline.reloadFromString(R"({"Start": {"next": ["Missing"]}})"));
+    EXPECT_EQ(pipeline.getNodeCount(), 3u);
+    EXPECT_EQ(pipeline.getNode("Start"), start);
+}
+
+// 测试多个流水线实例共享同一个流水线定义
+TEST(JsonParsingTest, SharedDefinition) {
+    const std::string pipelineJson = R"({
+        "var_global": ["%iCount=1"],
+        "Start": {
+            "recognition": {"type": "FindColor", "color": "FFFFFF"},
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit"
+        }
+    })";
+
+    auto definition = Pipeline::PipelineDefinition::loadFromString(pipelineJson);
+    ASSERT_NE(definition, nullptr);
+    EXPECT_EQ(definition->getNodeCount(), 2u);
+    EXPECT_EQ(Pipeline::PipelineDefinition::loadFromString("{invalid"), nullptr);
+
+    Pipeline::Pipeline first(definition);
+    Pipeline::Pipeline second(definition);
+    EXPECT_EQ(first.getDefinition(), second.getDefinition());
+
+    // 节点和识别对象只有一份
+    EXPECT_EQ(first.getNode("Start"), second.getNode("Start"));
+    EXPECT_EQ(first.getNode("Start")->getRecognition(), second.getNode("Start")->getRecognition());
+
+    // 变量属于各自的实例
+    first.getVariableManager().setVariable("%iCount", Pipeline::VariableValue(5));
+    auto firstCount = first.getVariableManager().getVariable("%iCount");
+    auto secondCount = second.getVariableManager().getVariable("%iCount");
+    ASSERT_TRUE(firstCount.has_value());
+    ASSERT_TRUE(secondCount.has_value());
+    EXPECT_EQ(firstCount->getValue<int>(), 5);
+    EXPECT_EQ(secondCount->getValue<int>(), 1);
+
+    // 一个实例热重载不影响共享的定义和其他实例
+    ASSERT_TRUE(first.reloadFromString(R"({"Start": {"next": ["Start"]}})"));
+    EXPECT_NE(first.getDefinition(), definition);
+    EXPECT_EQ(second.getDefinition(), definition);
+    EXPECT_EQ(definition->getNodeCount(), 2u);
+    EXPECT_EQ(second.getNode("Start")->getNextNodeIds()[0], second.getNodeId("End"));
+}
+
+// 测试看门狗的解析，watchdog字段不作为节点
+TEST(JsonParsingTest, Watchdog) {
+    const std::string pipelineJson = R"({
+        "watchdog": {
+            "LoginExpired": {"interval": 5000},
+            "CrashDialog": {"interval": 500, "priority": 10}
+        },
+        "Start": {
+            "recognition": "DirectHit"
+        },
+        "CrashDialog": {
+            "recognition": "DirectHit"
+        },
+        "LoginExpired": {
+            "recognition": "DirectHit"
+        }
+    })";
+
+    auto definition = Pipeline::PipelineDefinition::loadFromString(pipelineJson);
+    ASSERT_NE(definition, nullptr);
+    EXPECT_EQ(definition->getNodeCount(), 3u);
+    EXPECT_EQ(definition->getNodeId("watchdog"), Pipeline::InvalidNodeId);
+
+    // 按优先级从高到低排列
+    const auto& watchdogs = definition->getWatchdogs();
+    ASSERT_EQ(watchdogs.size(), 2u);
+    EXPECT_EQ(watchdogs[0].nodeId, definition->getNodeId("CrashDialog"));
+    EXPECT_EQ(watchdogs[0].interval.count(), 500);
+    EXPECT_EQ(watchdogs[0].priority, 10);
+    EXPECT_EQ(watchdogs[1].nodeId, definition->getNodeId("LoginExpired"));
+    EXPECT_EQ(watchdogs[1].interval.count(), 5000);
+    EXPECT_EQ(watchdogs[1].priority, 0);
+
+    // 节点名数组使用默认的间隔和优先级
+    definition = Pipeline::PipelineDefinition::loadFromString(R"({
+        "watchdog": ["Guard"],
+        "Guard": {"recognition": "DirectHit"}
+    })");
+    ASSERT_NE(definition, nullptr);
+    ASSERT_EQ(definition->getWatchdogs().size(), 1u);
+    EXPECT_EQ(definition->getWatchdogs()[0].interval.count(), 1000);
+
+    // 引用不存在的节点时加载失败
+    EXPECT_EQ(Pipeline::PipelineDefinition::loadFromString(R"({
+        "watchdog": ["Missing"],
+        "Start": {"recognition": "DirectHit"}
+    })"), nullptr);
+}
+
+// 测试画面稳定检测的前置延迟
+TEST(JsonParsingTest, StablePreDelay) {
+    auto definition = Pipeline::PipelineDefinition::loadFromString(R"({
+        "Dialog": {
+            "recognition": "FindColor",
+            "roi": [100, 100, 300, 200],
+            "roi_offset": [10, 10, 10, 10],
+            "pre_delay": "stable",
+            "stable_min": 20,
+            "stable_max": 800,
+            "stable_frames": 2
+        },
+        "Button": {
+            "recognition": "DirectHit",
+            "pre_delay": "stable"
+        },
+        "Fixed": {
+            "recognition": "DirectHit",
+            "pre_delay": 300
+        }
+    })");
+    ASSERT_NE(definition, nullptr);
+
+    auto dialog = definition->getNode("Dialog");
+    EXPECT_TRUE(dialog->isStablePreDelay());
+    EXPECT_EQ(dialog->getStableWait().minDelay, 20u);
+    EXPECT_EQ(dialog->getStableWait().maxDelay, 800u);
+    EXPECT_EQ(dialog->getStableWait().frames, 2u);
+    // 不能观察画面的调用方按上限等待
+    EXPECT_EQ(dialog->getPreDelay(), 800u);
+
+    // 识别区域已应用偏移
+    auto roi = dialog->getRecognition()->getRoi();
+    ASSERT_TRUE(roi.has_value());
+    EXPECT_EQ(roi->x1, 110);
+    EXPECT_EQ(roi->y2, 210);
+
+    // 未设置roi时检测整帧，未设置的参数使用默认值
+    auto button = definition->getNode("Button");
+    EXPECT_TRUE(button->isStablePreDelay());
+    EXPECT_EQ(button->getStableWait().maxDelay, 1000u);
+    EXPECT_FALSE(button->getRecognition()->getRoi().has_value());
+
+    EXPECT_FALSE(definition->getNode("Fixed")->isStablePreDelay());
+    EXPECT_EQ(definition->getNode("Fixed")->getPreDelay(), 300u);
+
+    // 未知的前置延迟模式
+    EXPECT_EQ(Pipeline::PipelineDefinition::loadFromString(R"({
+        "Start": {"pre_delay": "fast"}
+    })"), nullptr);
+}
@@ -104,3 +104,67 @@ TEST(NodeExecutionTest, Delays) {
     // 验证执行时间至少包含了延迟时间
     EXPECT_GE(duration, 200);
 }
+
+// 测试同一帧上参数相同的识别共享缓存结果
+TEST(NodeExecutionTest, RecognitionCache) {
+    const std::string pipelineJson = R"({
+        "NodeA": {
+            "recognition": "DirectHit",
+            "action": "DoNothing"
+        },
+        "NodeB": {
+            "recognition": "DirectHit",
+            "action": "Click"
+        },
+        "NodeC": {
+            "recognition": "DirectHit",
+            "inverse": true
+        }
+    })";
+
+    Pipeline::Pipeline pipeline;
+    EXPECT_TRUE(pipeline.loadFromString(pipelineJson));
+
+    auto nodeA = pipeline.getNode("NodeA");
+    auto nodeB = pipeline.getNode("NodeB");
+    auto nodeC = pipeline.getNode("NodeC");
+    ASSERT_NE(nodeA, nullptr);
+    ASSERT_NE(nodeB, nullptr);
+    ASSERT_NE(nodeC, nullptr);
+
+    Pipeline::RecognitionCache cache;
+    Pipeline::Frame frame;
+    frame.id = 1;
+    frame.epoch = 1;
+
+    // 识别参数相同的节点在同一帧上只识别一次
+    EXPECT_TRUE(nodeA->recognize(frame, Pipeline::CancellationToken::none(), &cache).success);
+    EXPECT_TRUE(nodeB->recognize(frame, Pipeline::CancellationToken::none(), &cache).success);
+    EXPECT_EQ(cache.getStats().hits, 1u);
+    EXPECT_EQ(cache.getStats().misses, 1u);
+
+    // 反转标志不同的识别不共享结果
+    EXPECT_FALSE(nodeC->recognize(frame, Pipeline::CancellationToken::none(), &cache).success);
+    EXPECT_EQ(cache.getStats().misses, 2u);
+
+    // 新帧上重新识别
+    frame.id = 2;
+    frame.epoch = 2;
+    EXPECT_TRUE(nodeA->recognize(frame, Pipeline::CancellationToken::none(), &cache).success);
+    EXPECT_EQ(cache.getStats().hits, 1u);
+    EXPECT_EQ(cache.getStats().misses, 3u);
+
+    // 无效帧不使用缓存
+    cache.resetStats();
+    EXPECT_TRUE(nodeA->recognize(Pipeline::Frame{}, Pipeline::CancellationToken::none(), &cache).success);
+    EXPECT_EQ(cache.getStats().hits, 0u);
+    EXPECT_EQ(cache.getStats().misses, 0u);
+
+    // 没有帧源的逻辑帧每次识别自行截图，同样不使用缓存
+    Pipeline::Frame logical;
+    logical.id = 3;
+    EXPECT_TRUE(nodeA->recognize(logical, Pipeline::CancellationToken::none(), &cache).success);
+    EXPECT_TRUE(nodeA->recognize(logical, Pipeline::CancellationToken::none(), &cache).success);
+    EXPECT_EQ(cache.getStats().hits, 0u);
+    EXPECT_EQ(cache.getStats().misses, 0u);
+}
@@ -1,8 +1,17 @@
 #include <gtest/gtest.h>
 #include <PipelineLib.h>
+#include <Pipeline/WindowFrameSource.h>
+#include <Pipeline/WorkerPool.h>
+#include <Pipeline/ParallelMatch.h>
+#include <vision/engine/WindowVision.h>
 #include <string>
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+#include <filesystem>
+#include <fstream>
 
 // 测试基本的流水线执行
 TEST(PipelineExecutionTest, BasicExecution) {
@@ -131,3 +140,1862 @@ TEST(PipelineExecutionTest, ErrorHandlingExecution) {
     // 停止执行
     executor.stop();
 }
+
+// 测试多个流水线共享同一个运行时
+TEST(PipelineExecutionTest, SharedRuntime) {
+    // 创建一个循环执行的流水线
+    const std::string pipelineJson = R"({
+        "Loop": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 10,
+            "next": ["Loop"]
+        }
+    })";
+
+    // 多个执行器共享两个工作线程
+    auto runtime = std::make_shared<Pipeline::Runtime>(2);
+    std::vector<std::unique_ptr<Pipeline::PipelineExecutor>> executors;
+    for (int i = 0; i < 8; ++i) {
+        executors.push_back(std::make_unique<Pipeline::PipelineExecutor>(runtime));
+        EXPECT_TRUE(executors.back()->executeFromString(pipelineJson, "Loop"));
+    }
+
+    // 等待一段时间，所有流水线都应处于运行状态
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    for (const auto& executor : executors) {
+        EXPECT_EQ(executor->getState(), Pipeline::PipelineState::Running);
+    }
+
+    // 停止执行，stop返回时协程已经退出
+    for (const auto& executor : executors) {
+        executor->stop();
+        EXPECT_EQ(executor->getState(), Pipeline::PipelineState::Stopped);
+    }
+}
+
+// 测试延迟不占用工作线程
+TEST(PipelineExecutionTest, DelaysDoNotBlockWorkers) {
+    // 每条流水线在Start节点后置延迟200毫秒，然后在End节点停止
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 200,
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    // 8条流水线共享一个工作线程
+    auto runtime = std::make_shared<Pipeline::Runtime>(1);
+    std::atomic<int> stoppedCount{0};
+    std::vector<std::unique_ptr<Pipeline::PipelineExecutor>> executors;
+    auto startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < 8; ++i) {
+        executors.push_back(std::make_unique<Pipeline::PipelineExecutor>(runtime));
+        executors.back()->setTaskStopCallback([&stoppedCount](const std::string&, const std::string&) {
+            ++stoppedCount;
+        });
+        EXPECT_TRUE(executors.back()->executeFromString(pipelineJson, "Start"));
+    }
+
+    // 延迟阻塞线程时需要8 * 200毫秒，挂起协程时所有流水线的延迟同时进行
+    while (stoppedCount < 8 && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    EXPECT_EQ(stoppedCount, 8);
+    EXPECT_LT(elapsedTime, 1000);
+}
+
+// 测试虚拟时钟，等待不消耗实际时间，同样的流水线每次得到相同的结果
+TEST(PipelineExecutionTest, VirtualClock) {
+    // Loop每次后置延迟1分钟，执行100次后转到End停止
+    const std::string pipelineJson = R"({
+        "var_global": ["%iCount=0"],
+        "Loop": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 60000,
+            "condition": "%iCount<100",
+            "condition_process": {
+                "true": {"var_operation": "{%iCount++}"}
+            },
+            "next": ["Loop"],
+            "interrupt": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    auto runOnce = [&pipelineJson]() {
+        auto clock = std::make_shared<Pipeline::VirtualClock>();
+        auto runtime = std::make_shared<Pipeline::Runtime>(1, clock);
+        std::atomic<bool> stopped{false};
+        Pipeline::PipelineExecutor executor(runtime);
+        executor.setTaskStopCallback([&stopped](const std::string&, const std::string&) { stopped = true; });
+        EXPECT_TRUE(executor.executeFromString(pipelineJson, "Loop"));
+
+        auto startTime = std::chrono::steady_clock::now();
+        while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        executor.stop();
+        EXPECT_TRUE(stopped);
+        return clock->now().time_since_epoch();
+    };
+
+    auto startTime = std::chrono::steady_clock::now();
+    auto first = runOnce();
+    auto second = runOnce();
+    auto elapsedTime = std::chrono::steady_clock::now() - startTime;
+
+    // 100分钟的虚拟时间在几秒内完成
+    EXPECT_GE(first, std::chrono::minutes(100));
+    EXPECT_LT(elapsedTime, std::chrono::seconds(5));
+    EXPECT_EQ(first, second);
+
+    // 等待即推进时钟，时间不会倒退
+    Pipeline::VirtualClock clock;
+    auto start = clock.now();
+    EXPECT_TRUE(clock.sleepFor(std::chrono::milliseconds(250)));
+    clock.advanceTo(start);
+    EXPECT_EQ(clock.now() - start, std::chrono::milliseconds(250));
+    Pipeline::CancellationToken token;
+    token.cancel();
+    EXPECT_FALSE(clock.sleepFor(std::chrono::milliseconds(250), &token));
+    EXPECT_EQ(clock.now() - start, std::chrono::milliseconds(250));
+}
+
+// 画面在指定时间之前一直变化的帧源，每次采集都产生新帧
+class AnimatedFrameSource : public Pipeline::FrameSource {
+public:
+    explicit AnimatedFrameSource(std::chrono::milliseconds animation)
+        : m_stableTime(std::chrono::steady_clock::now() + animation) {}
+
+    Pipeline::Frame capture() override {
+        Pipeline::Frame frame;
+        frame.epoch = ++m_counter;
+        frame.captureTime = std::chrono::steady_clock::now();
+        return frame;
+    }
+
+    std::optional<double> compareRegion(const Pipeline::Frame&, const Pipeline::Frame& current,
+                                        const std::optional<Pipeline::Rect>&) override {
+        return current.captureTime < m_stableTime ? 1.0 : 0.0;
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_stableTime;
+    std::atomic<uint64_t> m_counter{0};
+};
+
+// 测试画面稳定检测，画面稳定后立即识别，不必等到上限
+TEST(PipelineExecutionTest, StablePreDelay) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": "stable",
+            "stable_max": 3000,
+            "stable_interval": 10,
+            "post_delay": 0
+        }
+    })";
+
+    auto runtime = std::make_shared<Pipeline::Runtime>(1);
+    Pipeline::PipelineExecutor executor(runtime);
+    executor.setFrameSource(std::make_shared<AnimatedFrameSource>(std::chrono::milliseconds(200)));
+    std::atomic<bool> stopped{false};
+    executor.setTaskStopCallback([&stopped](const std::string&, const std::string&) { stopped = true; });
+
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    // 动画结束前不识别，动画结束后很快识别
+    EXPECT_TRUE(stopped);
+    EXPECT_GE(elapsedTime, 200);
+    EXPECT_LT(elapsedTime, 1000);
+}
+
+// 用窗口图像构造一帧，与WindowFrameSource::capture()采集到的帧结构相同
+static Pipeline::Frame makeWindowFrame(const Pipeline::FrameSource& source, const cv::Mat& image, uint64_t epoch) {
+    auto windowFrame = std::make_shared<vision::WindowFrame>();
+    windowFrame->epoch = epoch;
+    windowFrame->image = image.clone();
+
+    Pipeline::Frame frame;
+    frame.id = epoch;
+    frame.epoch = epoch;
+    frame.holder = windowFrame;
+    frame.source = &source;
+    return frame;
+}
+
+// 测试窗口帧源按识别区域比较两帧图像的平均像素差
+TEST(PipelineExecutionTest, WindowFrameCompareRegion) {
+    Pipeline::WindowFrameSource source(nullptr, nullptr);
+
+    // 100x100的黑色画面，左上角(20,20)处10x10的方块变为白色，占整个画面的1%
+    cv::Mat black(100, 100, CV_8UC3, cv::Scalar(0, 0, 0));
+    cv::Mat changed = black.clone();
+    changed(cv::Rect(20, 20, 10, 10)).setTo(cv::Scalar(255, 255, 255));
+    auto previous = makeWindowFrame(source, black, 1);
+    auto current = makeWindowFrame(source, changed, 2);
+
+    EXPECT_DOUBLE_EQ(*source.compareRegion(previous, makeWindowFrame(source, black, 2), std::nullopt), 0.0);
+    EXPECT_DOUBLE_EQ(*source.compareRegion(previous, current, std::nullopt), 0.01);
+    EXPECT_DOUBLE_EQ(*source.compareRegion(previous, current, Pipeline::Rect(20, 20, 30, 30)), 1.0);
+    EXPECT_DOUBLE_EQ(*source.compareRegion(previous, current, Pipeline::Rect(0, 0, 40, 40)), 100.0 / 1600.0);
+    EXPECT_DOUBLE_EQ(*source.compareRegion(previous, current, Pipeline::Rect(50, 50, 100, 100)), 0.0);
+
+    // 超出图像的部分被裁剪
+    EXPECT_DOUBLE_EQ(*source.compareRegion(previous, current, Pipeline::Rect(20, 20, 200, 200)), 100.0 / 6400.0);
+
+    // 窗口大小变化时视为完全变化，区域在图像之外或帧不是窗口帧源产生的时无法比较
+    EXPECT_DOUBLE_EQ(*source.compareRegion(previous, makeWindowFrame(source, cv::Mat(50, 50, CV_8UC3), 2), std::nullopt), 1.0);
+    EXPECT_FALSE(source.compareRegion(previous, current, Pipeline::Rect(200, 200, 300, 300)).has_value());
+    Pipeline::Frame logical;
+    logical.id = 3;
+    EXPECT_FALSE(source.compareRegion(previous, logical, std::nullopt).has_value());
+
+    // 其他帧源产生的帧即使带有帧数据也不按窗口帧解释
+    Pipeline::WindowFrameSource other(nullptr, nullptr);
+    EXPECT_FALSE(source.compareRegion(previous, makeWindowFrame(other, changed, 2), std::nullopt).has_value());
+    Pipeline::Frame foreign = current;
+    foreign.source = nullptr;
+    foreign.holder = std::make_shared<int>(0);
+    EXPECT_FALSE(source.compareRegion(previous, foreign, std::nullopt).has_value());
+}
+
+// 测试窗口图像更新时原地复用不再被引用的快照，被持有的快照不会被之后的更新修改
+TEST(PipelineExecutionTest, WindowFrameReuse) {
+    vision::WindowVision windowVision;
+    HWND hwnd = reinterpret_cast<HWND>(static_cast<uintptr_t>(1));
+    std::vector<unsigned char> black(16 * 16 * 4, 0);
+    std::vector<unsigned char> white(16 * 16 * 4, 255);
+
+    // 当前快照和上一个快照交替使用，没有其他引用时不再创建Vision对象
+    windowVision.updateWindowImage(hwnd, black.data(), 16, 16, 4);
+    auto first = windowVision.acquireFrame(hwnd)->vision;
+    windowVision.updateWindowImage(hwnd, black.data(), 16, 16, 4);
+    auto second = windowVision.acquireFrame(hwnd)->vision;
+    EXPECT_NE(first, second);
+    windowVision.updateWindowImage(hwnd, white.data(), 16, 16, 4);
+    EXPECT_EQ(windowVision.acquireFrame(hwnd)->vision, first);
+    windowVision.updateWindowImage(hwnd, white.data(), 16, 16, 4);
+    EXPECT_EQ(windowVision.acquireFrame(hwnd)->vision, second);
+
+    // 持有的快照在之后的更新中保持原来的纪元、图像和Vision对象
+    auto held = windowVision.acquireFrame(hwnd);
+    uint64_t heldEpoch = held->epoch;
+    windowVision.updateWindowImage(hwnd, black.data(), 16, 16, 4);
+    windowVision.updateWindowImage(hwnd, black.data(), 16, 16, 4);
+    windowVision.updateWindowImage(hwnd, black.data(), 16, 16, 4);
+    EXPECT_EQ(held->epoch, heldEpoch);
+    EXPECT_EQ(held->vision, second);
+    EXPECT_EQ(held->image.at<cv::Vec4b>(0, 0), cv::Vec4b(255, 255, 255, 255));
+
+    auto current = windowVision.acquireFrame(hwnd);
+    EXPECT_GT(current->epoch, heldEpoch);
+    EXPECT_NE(current->vision, second);
+    EXPECT_EQ(current->image.at<cv::Vec4b>(0, 0), cv::Vec4b(0, 0, 0, 0));
+}
+
+// 测试窗口帧源把截取时间换算到运行时的时钟上，虚拟时钟下也能判断帧是否在动作之后截取
+TEST(PipelineExecutionTest, WindowFrameCaptureTimeFollowsClock) {
+    vision::WindowVision windowVision;
+    HWND hwnd = reinterpret_cast<HWND>(static_cast<uintptr_t>(1));
+    std::vector<unsigned char> pixels(16 * 16 * 4, 0);
+    auto clock = std::make_shared<Pipeline::VirtualClock>();
+    Pipeline::WindowFrameSource source(&windowVision, hwnd, clock);
+
+    windowVision.updateWindowImage(hwnd, pixels.data(), 16, 16, 4);
+    auto frame = source.capture();
+    ASSERT_NE(frame.epoch, 0u);
+    EXPECT_LE(frame.captureTime, clock->now());
+    EXPECT_GT(frame.captureTime, clock->now() - std::chrono::seconds(1));
+
+    // 动作在虚拟时间中结束，之前截取的缓存帧仍然早于动作结束的时间
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    clock->advance(std::chrono::milliseconds(50));
+    auto actionEndTime = clock->now();
+    EXPECT_LT(source.capture().captureTime, actionEndTime);
+
+    // 动作之后更新的窗口图像在流水线等待推进时钟后晚于动作结束的时间
+    windowVision.updateWindowImage(hwnd, pixels.data(), 16, 16, 4);
+    clock->advance(std::chrono::milliseconds(20));
+    auto fresh = source.capture();
+    EXPECT_GT(fresh.epoch, frame.epoch);
+    EXPECT_GE(fresh.captureTime, actionEndTime);
+}
+
+// 测试窗口一直刷新但画面不再变化时，画面稳定检测按像素判断稳定，不必等到上限
+TEST(PipelineExecutionTest, StablePreDelayWithWindowFrames) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": "stable",
+            "stable_max": 3000,
+            "stable_interval": 20,
+            "post_delay": 0
+        }
+    })";
+
+    // 每10毫秒更新一次窗口图像，前300毫秒黑白交替，之后保持白色，每次更新都是新的纪元
+    vision::WindowVision windowVision;
+    HWND hwnd = reinterpret_cast<HWND>(static_cast<uintptr_t>(1));
+    std::vector<unsigned char> black(64 * 64 * 4, 0);
+    std::vector<unsigned char> white(64 * 64 * 4, 255);
+    windowVision.updateWindowImage(hwnd, black.data(), 64, 64, 4);
+
+    std::atomic<bool> stopped{false};
+    auto startTime = std::chrono::steady_clock::now();
+    std::thread updater([&]() {
+        bool flip = false;
+        while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+            bool animating = std::chrono::steady_clock::now() - startTime < std::chrono::milliseconds(300);
+            flip = !flip;
+            const auto& pixels = animating && flip ? black : white;
+            windowVision.updateWindowImage(hwnd, pixels.data(), 64, 64, 4);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+
+    auto runtime = std::make_shared<Pipeline::Runtime>(1);
+    Pipeline::PipelineExecutor executor(runtime);
+    executor.setFrameSource(std::make_shared<Pipeline::WindowFrameSource>(&windowVision, hwnd));
+    executor.setTaskStopCallback([&stopped](const std::string&, const std::string&) { stopped = true; });
+
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    bool finished = stopped;
+    executor.stop();
+    stopped = true;
+    updater.join();
+
+    // 画面交替期间不识别，停止变化后很快识别，远早于stable_max
+    EXPECT_TRUE(finished);
+    EXPECT_GE(elapsedTime, 300);
+    EXPECT_LT(elapsedTime, 1500);
+}
+
+// 像vision::WindowVision一样在一段时间内返回缓存帧的帧源
+class CachedFrameSource : public Pipeline::FrameSource {
+public:
+    explicit CachedFrameSource(std::chrono::milliseconds cacheTimeout) : m_cacheTimeout(cacheTimeout) {}
+
+    Pipeline::Frame capture() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = std::chrono::steady_clock::now();
+        if (m_frame.epoch == 0 || now - m_frame.captureTime >= m_cacheTimeout) {
+            m_frame.epoch++;
+            m_frame.captureTime = now;
+        }
+        return m_frame;
+    }
+
+private:
+    std::chrono::milliseconds m_cacheTimeout;
+    std::mutex m_mutex;
+    Pipeline::Frame m_frame;
+};
+
+// 测试动作之后的识别只使用动作结束之后采集的帧，不使用动作之前缓存的帧
+TEST(PipelineExecutionTest, FreshFrameAfterAction) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    auto runtime = std::make_shared<Pipeline::Runtime>(1);
+    Pipeline::PipelineExecutor executor(runtime);
+    executor.setFrameSource(std::make_shared<CachedFrameSource>(std::chrono::milliseconds(300)));
+    std::atomic<bool> stopped{false};
+    executor.setTaskStopCallback([&stopped](const std::string&, const std::string&) { stopped = true; });
+
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    // Start识别时缓存的帧在动作之前采集，End要等到缓存过期后的新帧才能命中
+    EXPECT_TRUE(stopped);
+    EXPECT_GE(elapsedTime, 300);
+    EXPECT_LT(elapsedTime, 1500);
+}
+
+// 每隔一次采集失败一次的帧源，成功采集的帧纪元从1开始递增，每一帧都是不同的画面
+class FlakyFrameSource : public Pipeline::FrameSource {
+public:
+    Pipeline::Frame capture() override {
+        Pipeline::Frame frame;
+        uint64_t count = ++m_count;
+        if (count % 2 == 0) {
+            frame.epoch = count / 2;
+            frame.captureTime = std::chrono::steady_clock::now();
+        }
+        return frame;
+    }
+
+private:
+    std::atomic<uint64_t> m_count{0};
+};
+
+// 测试采集失败时生成的逻辑帧与帧源的帧不共用帧序号，不同画面之间不会错误命中识别缓存
+TEST(PipelineExecutionTest, FrameIdsDoNotCollide) {
+    const std::string pipelineJson = R"({
+        "Loop": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "next": ["Loop"]
+        }
+    })";
+
+    auto runtime = std::make_shared<Pipeline::Runtime>(1);
+    Pipeline::PipelineExecutor executor(runtime);
+    executor.setFrameSource(std::make_shared<FlakyFrameSource>());
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Loop"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    executor.stop();
+
+    // 每次识别都在新采集的一帧上进行
+    auto stats = executor.getRecognitionCacheStats();
+    EXPECT_GT(stats.misses, 10u);
+    EXPECT_EQ(stats.hits, 0u);
+}
+
+// 每次采集都产生新画面的帧源，记录采集次数
+class TickCountingFrameSource : public Pipeline::FrameSource {
+public:
+    Pipeline::Frame capture() override {
+        Pipeline::Frame frame;
+        frame.epoch = ++m_captures;
+        frame.captureTime = std::chrono::steady_clock::now();
+        return frame;
+    }
+
+    uint64_t getCaptureCount() const { return m_captures; }
+
+private:
+    std::atomic<uint64_t> m_captures{0};
+};
+
+// 测试每轮候选节点评估只采集一帧，所有候选节点在这一帧上识别；逻辑帧每次自行截图，不缓存
+TEST(PipelineExecutionTest, OneCapturePerTick) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "timeout": 150,
+            "next": ["MissA", "MissB"],
+            "interrupt": ["MissC"]
+        },
+        "MissA": {
+            "recognition": "DirectHit",
+            "inverse": true,
+            "roi": [0, 0, 10, 10],
+            "pre_delay": 0
+        },
+        "MissB": {
+            "recognition": "DirectHit",
+            "inverse": true,
+            "roi": [10, 10, 20, 20],
+            "pre_delay": 0
+        },
+        "MissC": {
+            "recognition": "DirectHit",
+            "inverse": true,
+            "roi": [20, 20, 30, 30],
+            "pre_delay": 0
+        }
+    })";
+
+    auto runtime = std::make_shared<Pipeline::Runtime>(1);
+    Pipeline::PipelineExecutor executor(runtime);
+    auto frameSource = std::make_shared<TickCountingFrameSource>();
+    executor.setFrameSource(frameSource);
+    executor.setMaxFrameWait(std::chrono::milliseconds(10));
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    executor.stop();
+
+    // 起始节点的识别采集一帧，之后每轮采集一帧，三个候选节点各在这一帧上识别一次
+    uint64_t ticks = frameSource->getCaptureCount() - 1;
+    auto stats = executor.getRecognitionCacheStats();
+    EXPECT_GT(ticks, 2u);
+    EXPECT_EQ(stats.misses, 1 + 3 * ticks);
+    EXPECT_EQ(stats.hits, 0u);
+
+    // 没有帧源时生成的逻辑帧不进入识别缓存
+    Pipeline::PipelineExecutor logical(runtime);
+    logical.setMaxFrameWait(std::chrono::milliseconds(10));
+    EXPECT_TRUE(logical.executeFromString(pipelineJson, "Start"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    logical.stop();
+    auto logicalStats = logical.getRecognitionCacheStats();
+    EXPECT_EQ(logicalStats.hits + logicalStats.misses, 0u);
+}
+
+// 画面一直静止的帧源，记录尚未调用的新帧回调，像窗口静止时的vision::WindowVision一样从不调用回调
+class StaticFrameSource : public Pipeline::FrameSource {
+public:
+    Pipeline::Frame capture() override {
+        Pipeline::Frame frame;
+        frame.epoch = 1;
+        frame.captureTime = std::chrono::steady_clock::now();
+        return frame;
+    }
+
+    bool notifyOnNewFrame(uint64_t, const void* key, std::function<void()>) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.insert(key);
+        ++m_registrations;
+        return true;
+    }
+
+    void cancelNewFrameNotification(const void* key) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.erase(key);
+    }
+
+    size_t getPendingCount() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pending.size();
+    }
+
+    size_t getRegistrationCount() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_registrations;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_set<const void*> m_pending;
+    size_t m_registrations = 0;
+};
+
+// 测试画面静止时等待新帧超时后注销新帧回调，帧源中的回调不会随等待次数累积
+TEST(PipelineExecutionTest, FrameNotificationsReleasedOnTimeout) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "next": ["Miss"]
+        },
+        "Miss": {
+            "recognition": "DirectHit",
+            "inverse": true,
+            "pre_delay": 0
+        }
+    })";
+
+    auto runtime = std::make_shared<Pipeline::Runtime>(1);
+    Pipeline::PipelineExecutor executor(runtime);
+    auto frameSource = std::make_shared<StaticFrameSource>();
+    executor.setFrameSource(frameSource);
+    executor.setMaxFrameWait(std::chrono::milliseconds(5));
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // 每次等待都注册一个回调，超时后注销，最多只有正在进行的一次等待的回调
+    EXPECT_GT(frameSource->getRegistrationCount(), 10u);
+    EXPECT_LE(frameSource->getPendingCount(), 1u);
+
+    // 停止时取消正在进行的等待，回调也被注销
+    executor.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(frameSource->getPendingCount(), 0u);
+}
+
+// 测试自动后置延迟，测量动作之后画面停止变化的时间并以百分位数作为后置延迟
+TEST(PipelineExecutionTest, AutoPostDelay) {
+    // 滑动窗口只保留最近的样本，百分位数按最近秩法计算
+    Pipeline::LatencyModel model(4, 2, 3);
+    EXPECT_FALSE(model.getPercentile(1, 90).has_value());
+    EXPECT_TRUE(model.shouldMeasure(1));
+    for (uint32_t settle : {500u, 100u, 200u, 300u, 400u}) {
+        model.record(1, Pipeline::LatencySample{10, settle});
+    }
+    EXPECT_EQ(model.getSampleCount(1), 4u);
+    EXPECT_EQ(model.getPercentile(1, 50)->settle, 200u);
+    EXPECT_EQ(model.getPercentile(1, 90)->settle, 400u);
+    EXPECT_EQ(model.getPercentile(1, 90)->start, 10u);
+    auto samples = model.getSamples();
+    ASSERT_EQ(samples.size(), 1u);
+    EXPECT_EQ(samples[0].second.front().settle, 100u);
+    EXPECT_EQ(samples[0].second.back().settle, 400u);
+
+    // 样本足够后每3次执行重新测量一次
+    EXPECT_FALSE(model.shouldMeasure(1));
+    EXPECT_FALSE(model.shouldMeasure(1));
+    EXPECT_TRUE(model.shouldMeasure(1));
+
+    // 画面在动作之后变化约150毫秒
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": "auto",
+            "post_delay_max": 1000,
+            "stable_interval": 10,
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    auto runtime = std::make_shared<Pipeline::Runtime>(1);
+    Pipeline::PipelineExecutor executor(runtime);
+    executor.setFrameSource(std::make_shared<AnimatedFrameSource>(std::chrono::milliseconds(150)));
+    std::atomic<bool> stopped{false};
+    executor.setTaskStopCallback([&stopped](const std::string&, const std::string&) { stopped = true; });
+    EXPECT_FALSE(executor.getLearnedPostDelay("Start").has_value());
+
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_TRUE(stopped);
+
+    auto learned = executor.getLearnedPostDelay("Start");
+    ASSERT_TRUE(learned.has_value());
+    EXPECT_GE(*learned, 100u);
+    EXPECT_LT(*learned, 1000u);
+    EXPECT_FALSE(executor.getLearnedPostDelay("End").has_value());
+
+    // 按节点名保存后加载到新的执行器
+    auto modelPath = (std::filesystem::temp_directory_path() / "pipeline_latency_model.json").string();
+    EXPECT_TRUE(executor.saveLatencyModel(modelPath));
+    Pipeline::Pipeline restored;
+    ASSERT_TRUE(restored.loadFromString(pipelineJson));
+    EXPECT_TRUE(restored.loadLatencyModel(modelPath));
+    EXPECT_EQ(restored.getLearnedPostDelay("Start"), learned);
+    std::filesystem::remove(modelPath);
+}
+
+// 每次采集都产生新帧的帧源，前settleFrames帧画面一直变化，之后不再变化
+class SettlingFrameSource : public Pipeline::FrameSource {
+public:
+    explicit SettlingFrameSource(uint64_t settleFrames) : m_settleFrames(settleFrames) {}
+
+    Pipeline::Frame capture() override {
+        Pipeline::Frame frame;
+        frame.epoch = ++m_counter;
+        frame.captureTime = std::chrono::steady_clock::now();
+        return frame;
+    }
+
+    std::optional<double> compareRegion(const Pipeline::Frame&, const Pipeline::Frame& current,
+                                        const std::optional<Pipeline::Rect>&) override {
+        return current.epoch <= m_settleFrames ? 1.0 : 0.0;
+    }
+
+private:
+    uint64_t m_settleFrames;
+    std::atomic<uint64_t> m_counter{0};
+};
+
+// 测试学习到的后置延迟随画面稳定所需的帧数变化，而不是总按post_delay_max记录
+TEST(PipelineExecutionTest, AutoPostDelayTracksSettleFrames) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": "auto",
+            "post_delay_max": 2000,
+            "stable_interval": 10,
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    // 执行一次，返回学习到的后置延迟
+    auto learnPostDelay = [&pipelineJson](uint64_t settleFrames) -> std::optional<uint32_t> {
+        auto runtime = std::make_shared<Pipeline::Runtime>(1);
+        Pipeline::PipelineExecutor executor(runtime);
+        executor.setFrameSource(std::make_shared<SettlingFrameSource>(settleFrames));
+        std::atomic<bool> stopped{false};
+        executor.setTaskStopCallback([&stopped](const std::string&, const std::string&) { stopped = true; });
+
+        auto startTime = std::chrono::steady_clock::now();
+        EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+        while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        EXPECT_TRUE(stopped);
+        return executor.getLearnedPostDelay("Start");
+    };
+
+    // 动作之前识别Start用掉一帧，测量从第2帧开始，每隔约10毫秒采样一次
+    auto fast = learnPostDelay(5);
+    auto slow = learnPostDelay(30);
+    ASSERT_TRUE(fast.has_value());
+    ASSERT_TRUE(slow.has_value());
+    EXPECT_GE(*fast, 10u);
+    EXPECT_GE(*slow, 200u);
+    EXPECT_GT(*slow, *fast + 150u);
+    EXPECT_LT(*slow, 2000u);
+}
+
+// 测试检查点的序列化和从检查点恢复执行
+TEST(PipelineExecutionTest, CheckpointRestore) {
+    // 序列化后再解析得到相同的内容，截断或格式不符的数据无法解析
+    Pipeline::Checkpoint checkpoint;
+    checkpoint.nodeName = "Wait";
+    checkpoint.phase = Pipeline::CheckpointPhase::PostAction;
+    checkpoint.remaining = 150;
+    checkpoint.actionSuccess = false;
+    checkpoint.branches = {{"Wait", 1}};
+    checkpoint.variables = {
+        {"%bDone", Pipeline::Variable(Pipeline::VariableType::Boolean, true)},
+        {"%fRate", Pipeline::Variable(Pipeline::VariableType::Float, 0.25)},
+        {"%iCount", Pipeline::Variable(Pipeline::VariableType::Integer, -3)},
+        {"%pTarget", Pipeline::Variable(Pipeline::VariableType::Point, Pipeline::Point(10, 20))},
+        {"%sName", Pipeline::Variable(Pipeline::VariableType::String, std::string("test"))},
+    };
+    auto data = checkpoint.serialize();
+    auto parsed = Pipeline::Checkpoint::deserialize(data);
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->nodeName, "Wait");
+    EXPECT_EQ(parsed->phase, Pipeline::CheckpointPhase::PostAction);
+    EXPECT_EQ(parsed->remaining, 150u);
+    EXPECT_FALSE(parsed->actionSuccess);
+    EXPECT_EQ(parsed->branches, checkpoint.branches);
+    ASSERT_EQ(parsed->variables.size(), checkpoint.variables.size());
+    for (size_t i = 0; i < checkpoint.variables.size(); ++i) {
+        EXPECT_EQ(parsed->variables[i].first, checkpoint.variables[i].first);
+        EXPECT_EQ(parsed->variables[i].second.getType(), checkpoint.variables[i].second.getType());
+        EXPECT_EQ(parsed->variables[i].second.toString(), checkpoint.variables[i].second.toString());
+    }
+    EXPECT_FALSE(Pipeline::Checkpoint::deserialize(data.data(), data.size() - 1).has_value());
+    data[0] = 'X';
+    EXPECT_FALSE(Pipeline::Checkpoint::deserialize(data).has_value());
+
+    // Start执行后等待永远不会命中的后继节点，超时后转到End
+    const std::string pipelineJson = R"({
+        "var_global": ["%iCount=1"],
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "timeout": 1000,
+            "condition_process": {
+                "true": {"var_operation": "{%iCount++}"}
+            },
+            "next": ["Never"],
+            "on_error": ["End"]
+        },
+        "Never": {
+            "enabled": false
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    Pipeline::PipelineExecutor executor;
+    EXPECT_TRUE(executor.checkpoint().empty());
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    auto saved = executor.checkpoint();
+    executor.stop();
+
+    auto savedCheckpoint = Pipeline::Checkpoint::deserialize(saved);
+    ASSERT_TRUE(savedCheckpoint.has_value());
+    EXPECT_EQ(savedCheckpoint->nodeName, "Start");
+    EXPECT_EQ(savedCheckpoint->phase, Pipeline::CheckpointPhase::Waiting);
+    EXPECT_GT(savedCheckpoint->remaining, 0u);
+    EXPECT_LT(savedCheckpoint->remaining, 1000u);
+    ASSERT_EQ(savedCheckpoint->branches.size(), 1u);
+    EXPECT_EQ(savedCheckpoint->branches[0].first, "Start");
+
+    // 在新的执行器中恢复，继续等待剩余的超时时间，不再重复执行条件处理和动作
+    std::atomic<bool> stopped{false};
+    std::string stopNode;
+    Pipeline::PipelineExecutor restored;
+    restored.setTaskStopCallback([&stopped, &stopNode](const std::string& nodeName, const std::string&) {
+        stopNode = nodeName;
+        stopped = true;
+    });
+    EXPECT_FALSE(restored.restoreFromString(pipelineJson, {}));
+    EXPECT_TRUE(restored.restoreFromString(pipelineJson, saved));
+
+    auto resumed = Pipeline::Checkpoint::deserialize(restored.checkpoint());
+    ASSERT_TRUE(resumed.has_value());
+    EXPECT_EQ(resumed->nodeName, "Start");
+    EXPECT_EQ(resumed->phase, Pipeline::CheckpointPhase::Waiting);
+    EXPECT_LE(resumed->remaining, savedCheckpoint->remaining);
+    bool foundCount = false;
+    for (const auto& [name, variable] : resumed->variables) {
+        if (name == "%iCount") {
+            foundCount = true;
+            EXPECT_EQ(variable.getValue<int>(), 2);
+        }
+    }
+    EXPECT_TRUE(foundCount);
+
+    auto startTime = std::chrono::steady_clock::now();
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    restored.stop();
+
+    EXPECT_TRUE(stopped);
+    EXPECT_EQ(stopNode, "End");
+}
+
+// 测试停止延迟，长时间的延迟或动作进行中调用stop也应很快返回
+TEST(PipelineExecutionTest, StopLatency) {
+    // 分别停在长时间的前置延迟和长时间的滑动动作中
+    const std::vector<std::string> pipelineJsons = {
+        R"({
+            "Start": {
+                "recognition": "DirectHit",
+                "action": "DoNothing",
+                "pre_delay": 10000
+            }
+        })",
+        R"({
+            "Start": {
+                "recognition": "DirectHit",
+                "action": {
+                    "type": "Swipe",
+                    "begin": [0, 0],
+                    "end": [100, 100],
+                    "duration": 10000
+                },
+                "pre_delay": 0
+            }
+        })"
+    };
+
+    for (const auto& pipelineJson : pipelineJsons) {
+        Pipeline::PipelineExecutor executor;
+        EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+
+        // 等待流水线进入延迟或动作
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        EXPECT_EQ(executor.getState(), Pipeline::PipelineState::Running);
+
+        // stop返回时协程已经退出
+        auto startTime = std::chrono::steady_clock::now();
+        executor.stop();
+        auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+
+        EXPECT_EQ(executor.getState(), Pipeline::PipelineState::Stopped);
+        EXPECT_LT(elapsedTime, 50);
+    }
+}
+
+// 测试暂停打断的后置延迟在恢复后补足剩余的时间
+TEST(PipelineExecutionTest, SuspendKeepsRemainingDelay) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 400,
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    std::atomic<bool> stopped{false};
+    Pipeline::PipelineExecutor executor;
+    executor.setTaskStopCallback([&stopped](const std::string&, const std::string&) {
+        stopped = true;
+    });
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+
+    // 在后置延迟进行到大约100毫秒时暂停300毫秒
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    executor.suspend();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    executor.resume();
+
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    executor.stop();
+
+    // 恢复后还要等待剩余的约300毫秒，而不是立即转到End
+    EXPECT_TRUE(stopped);
+    EXPECT_GE(elapsedTime, 650);
+}
+
+// 测试暂停打断的候选节点前置延迟在恢复后补足剩余的时间
+TEST(PipelineExecutionTest, SuspendKeepsRemainingTickPreDelay) {
+    // Start之后的每轮评估都先等待End的400毫秒前置延迟
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 400,
+            "post_delay": 0
+        }
+    })";
+
+    std::atomic<bool> stopped{false};
+    Pipeline::PipelineExecutor executor;
+    executor.setTaskStopCallback([&stopped](const std::string&, const std::string&) {
+        stopped = true;
+    });
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+
+    // 在前置延迟进行到大约100毫秒时暂停300毫秒
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    executor.suspend();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    executor.resume();
+
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    executor.stop();
+
+    // 恢复后还要等待剩余的约300毫秒，而不是立即评估End
+    EXPECT_TRUE(stopped);
+    EXPECT_GE(elapsedTime, 650);
+}
+
+// 测试推测模式，画面稳定后即可切换到后继节点，不必等待完整的后置延迟
+TEST(PipelineExecutionTest, SpeculativeTransition) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 2000,
+            "speculative": true,
+            "settle_time": 50,
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    std::atomic<bool> stopped{false};
+    Pipeline::PipelineExecutor executor;
+    executor.setTaskStopCallback([&stopped](const std::string&, const std::string&) {
+        stopped = true;
+    });
+
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    // 到达End节点只需要画面稳定时间，而不是2000毫秒的后置延迟
+    EXPECT_TRUE(stopped);
+    EXPECT_LT(elapsedTime, 1000);
+}
+
+// 测试自适应顺序记录候选边的统计信息
+TEST(PipelineExecutionTest, AdaptiveOrderStats) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "order": "adaptive",
+            "next": ["Miss", "End"]
+        },
+        "Miss": {
+            "recognition": "DirectHit",
+            "inverse": true,
+            "pre_delay": 0
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    std::atomic<bool> stopped{false};
+    Pipeline::PipelineExecutor executor;
+    executor.setTaskStopCallback([&stopped](const std::string&, const std::string&) {
+        stopped = true;
+    });
+
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    executor.stop();
+    ASSERT_TRUE(stopped);
+
+    // 还没有统计信息时按列表顺序评估，两个候选节点各识别一次
+    auto stats = executor.getEdgeStats("Start");
+    ASSERT_EQ(stats.size(), 2u);
+    for (const auto& edge : stats) {
+        EXPECT_EQ(executor.getNodeName(edge.from), "Start");
+        EXPECT_EQ(edge.attempts, 1u);
+        EXPECT_EQ(edge.hits, executor.getNodeName(edge.to) == "End" ? 1u : 0u);
+    }
+}
+
+// 在协程中执行一轮并行匹配，返回命中的下标
+static Pipeline::Task runParallelMatch(Pipeline::ParallelMatch* match, Pipeline::WorkerPool* workerPool,
+                                       Pipeline::Runtime* runtime, Pipeline::CancellationToken* parent, size_t count,
+                                       Pipeline::ParallelMatch::Evaluator evaluator, size_t* winner) {
+    match->start(*workerPool, runtime, *parent, count, std::move(evaluator));
+    *winner = co_await match->wait();
+}
+
+// 测试并行匹配按优先级选出胜者，等待期间不占用运行时的工作线程，命中后跳过优先级更低的项，取消能传到正在进行的识别
+TEST(PipelineExecutionTest, ParallelMatch) {
+    Pipeline::Runtime runtime(1);
+    Pipeline::WorkerPool workerPool(4);
+    Pipeline::ParallelMatch match;
+    Pipeline::CancellationToken parent;
+    size_t winner = 0;
+
+    // 优先级高但识别慢的项胜过优先级低但识别快的项
+    auto startTime = std::chrono::steady_clock::now();
+    Pipeline::Task slowFirst = runParallelMatch(&match, &workerPool, &runtime, &parent, 3,
+        [](size_t index, const Pipeline::CancellationToken&) {
+            if (index == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            return true;
+        }, &winner);
+    slowFirst.start(runtime);
+
+    // 唯一的工作线程在等待期间可以执行其他协程
+    std::atomic<bool> otherRan{false};
+    auto other = [](std::atomic<bool>* ran) -> Pipeline::Task {
+        ran->store(true);
+        co_return;
+    }(&otherRan);
+    other.start(runtime);
+    other.wait();
+    EXPECT_TRUE(otherRan);
+    EXPECT_LT(std::chrono::steady_clock::now() - startTime, std::chrono::milliseconds(90));
+
+    slowFirst.wait();
+    EXPECT_EQ(winner, 0u);
+    EXPECT_GE(std::chrono::steady_clock::now() - startTime, std::chrono::milliseconds(100));
+
+    // 只有一个线程时，第一项命中后排在后面的项尚未开始，直接跳过而不评估
+    Pipeline::WorkerPool singleThread(1);
+    std::atomic<int> evaluated{0};
+    Pipeline::Task skip = runParallelMatch(&match, &singleThread, &runtime, &parent, 4,
+        [&evaluated](size_t, const Pipeline::CancellationToken&) {
+            ++evaluated;
+            return true;
+        }, &winner);
+    skip.start(runtime);
+    skip.wait();
+    EXPECT_EQ(winner, 0u);
+    EXPECT_EQ(evaluated, 1);
+    EXPECT_EQ(match.getSkippedCount(), 3u);
+
+    // 上级令牌被取消时，正在进行的识别通过各自的令牌尽快结束，被取消的结果不采用
+    std::atomic<int> cancelledCount{0};
+    startTime = std::chrono::steady_clock::now();
+    Pipeline::Task cancelled = runParallelMatch(&match, &workerPool, &runtime, &parent, 2,
+        [&cancelledCount](size_t, const Pipeline::CancellationToken& token) {
+            bool finished = token.waitFor(std::chrono::seconds(5));
+            if (!finished) {
+                ++cancelledCount;
+            }
+            return true;
+        }, &winner);
+    cancelled.start(runtime);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    parent.cancel();
+    cancelled.wait();
+    EXPECT_EQ(winner, 2u);
+    EXPECT_EQ(cancelledCount, 2);
+    EXPECT_LT(std::chrono::steady_clock::now() - startTime, std::chrono::seconds(2));
+
+    // 重置令牌后复用同一个对象继续评估
+    parent.reset();
+    Pipeline::Task reused = runParallelMatch(&match, &workerPool, &runtime, &parent, 2,
+        [](size_t index, const Pipeline::CancellationToken&) { return index == 1; }, &winner);
+    reused.start(runtime);
+    reused.wait();
+    EXPECT_EQ(winner, 1u);
+}
+
+// 测试并行评估的节点按列表顺序选出命中的候选节点
+TEST(PipelineExecutionTest, ParallelCandidates) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "parallel": true,
+            "next": ["Miss", "First", "Second"]
+        },
+        "Miss": {
+            "recognition": "DirectHit",
+            "inverse": true,
+            "pre_delay": 0
+        },
+        "First": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0
+        },
+        "Second": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0
+        }
+    })";
+
+    auto runtime = std::make_shared<Pipeline::Runtime>(1);
+    Pipeline::PipelineExecutor executor(runtime);
+    std::mutex mutex;
+    std::string stoppedAt;
+    executor.setTaskStopCallback([&](const std::string& nodeName, const std::string&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stoppedAt = nodeName;
+    });
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    executor.stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(stoppedAt, "First");
+}
+
+// 测试候选节点调度器按预期耗时排序
+TEST(PipelineExecutionTest, CandidateSchedulerOrder) {
+    using namespace std::chrono_literals;
+
+    Pipeline::CandidateScheduler scheduler;
+    std::vector<Pipeline::NodeId> candidates = {1, 2, 3};
+
+    // 没有统计信息时保持列表顺序
+    scheduler.order(0, candidates);
+    EXPECT_EQ(candidates, (std::vector<Pipeline::NodeId>{1, 2, 3}));
+
+    // 节点1耗时高且很少命中，节点2耗时低且经常命中
+    for (int i = 0; i < 10; ++i) {
+        scheduler.record(0, 1, false, 20ms);
+        scheduler.record(0, 2, i % 2 == 0, 2ms);
+        scheduler.record(0, 3, false, 5ms);
+    }
+    scheduler.order(0, candidates);
+    EXPECT_EQ(candidates, (std::vector<Pipeline::NodeId>{2, 3, 1}));
+
+    // 其他节点的候选边不受影响
+    std::vector<Pipeline::NodeId> otherCandidates = {1, 2, 3};
+    scheduler.order(5, otherCandidates);
+    EXPECT_EQ(otherCandidates, (std::vector<Pipeline::NodeId>{1, 2, 3}));
+}
+
+// 测试最小评估间隔，间隔内复用上次的识别结果
+TEST(PipelineExecutionTest, CandidateSampling) {
+    using namespace std::chrono_literals;
+
+    auto definition = Pipeline::PipelineDefinition::loadFromString(R"({
+        "Ocr": {"recognition": "DirectHit", "min_interval": 500},
+        "Limited": {"recognition": "DirectHit", "min_interval": 100, "max_rate": 4},
+        "Color": {"recognition": "DirectHit"}
+    })");
+    ASSERT_NE(definition, nullptr);
+    EXPECT_EQ(definition->getNode("Ocr")->getMinInterval(), 500u);
+    EXPECT_EQ(definition->getNode("Limited")->getMinInterval(), 250u);
+    EXPECT_EQ(definition->getNode("Color")->getMinInterval(), 0u);
+
+    Pipeline::CandidateScheduler scheduler;
+    auto now = std::chrono::steady_clock::now();
+    EXPECT_FALSE(scheduler.lookupSample(1, now, 500ms).has_value());
+
+    Pipeline::RecognitionResult result;
+    result.success = true;
+    scheduler.storeSample(1, now, result);
+
+    // 间隔内复用，超过间隔后重新识别
+    auto sample = scheduler.lookupSample(1, now + 100ms, 500ms);
+    ASSERT_TRUE(sample.has_value());
+    EXPECT_TRUE(sample->success);
+    EXPECT_FALSE(scheduler.lookupSample(1, now + 500ms, 500ms).has_value());
+    EXPECT_FALSE(scheduler.lookupSample(2, now + 100ms, 500ms).has_value());
+
+    scheduler.clearSamples();
+    EXPECT_FALSE(scheduler.lookupSample(1, now + 100ms, 500ms).has_value());
+}
+
+// 测试节点转移模型的预测和持久化
+TEST(PipelineExecutionTest, TransitionModel) {
+    Pipeline::TransitionModel model;
+    EXPECT_TRUE(model.predict(0, 2).empty());
+
+    model.record(0, 1, 3);
+    model.record(0, 2, 5);
+    model.record(0, 3);
+    EXPECT_EQ(model.predict(0, 2), (std::vector<Pipeline::NodeId>{2, 1}));
+    EXPECT_EQ(model.getCount(0, 2), 5u);
+    EXPECT_DOUBLE_EQ(model.getProbability(0, 3), 1.0 / 9.0);
+    EXPECT_DOUBLE_EQ(model.getProbability(1, 0), 0.0);
+
+    // 执行时记录节点之间的转移
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    Pipeline::Runtime runtime(1);
+    Pipeline::Pipeline pipeline;
+    pipeline.setRuntime(&runtime);
+    ASSERT_TRUE(pipeline.loadFromString(pipelineJson));
+    Pipeline::Task task = pipeline.execute("Start");
+    task.start(runtime);
+    task.wait();
+    EXPECT_EQ(pipeline.getTransitionModel().getCount(pipeline.getNodeId("Start"), pipeline.getNodeId("End")), 1u);
+
+    // 按节点名保存，加载到另一个实例后累加
+    auto filePath = (std::filesystem::temp_directory_path() / "pipeline_transition_model.json").string();
+    ASSERT_TRUE(pipeline.saveTransitionModel(filePath));
+
+    Pipeline::Pipeline restored;
+    ASSERT_TRUE(restored.loadFromString(pipelineJson));
+    ASSERT_TRUE(restored.loadTransitionModel(filePath));
+    ASSERT_TRUE(restored.loadTransitionModel(filePath));
+    EXPECT_EQ(restored.getTransitionModel().getCount(restored.getNodeId("Start"), restored.getNodeId("End")), 2u);
+    EXPECT_EQ(restored.getTransitionModel().predict(restored.getNodeId("Start"), 2),
+              (std::vector<Pipeline::NodeId>{restored.getNodeId("End")}));
+    std::filesystem::remove(filePath);
+}
+
+// 测试学习到的后继顺序在保存加载、重新加载定义和热重载之后保持不变
+TEST(PipelineExecutionTest, TransitionOrderSurvivesReload) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "next": ["Left", "Right"]
+        },
+        "Left": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0
+        },
+        "Right": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    // 节点的声明顺序不同，节点ID随之不同
+    const std::string reorderedJson = R"({
+        "Right": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0
+        },
+        "Left": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0
+        },
+        "Start": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "next": ["Left", "Right"]
+        }
+    })";
+
+    auto modelPath = (std::filesystem::temp_directory_path() / "pipeline_transition_order.json").string();
+    auto savedPath = (std::filesystem::temp_directory_path() / "pipeline_transition_order_saved.json").string();
+    {
+        std::ofstream file(modelPath);
+        file << R"({"Start": {"Left": 1, "Right": 3}})";
+    }
+
+    Pipeline::Pipeline pipeline;
+    ASSERT_TRUE(pipeline.loadFromString(pipelineJson));
+    ASSERT_TRUE(pipeline.loadTransitionModel(modelPath));
+    auto expectedOrder = [](const Pipeline::Pipeline& p) {
+        return std::vector<Pipeline::NodeId>{p.getNodeId("Right"), p.getNodeId("Left")};
+    };
+    EXPECT_EQ(pipeline.getTransitionModel().predict(pipeline.getNodeId("Start"), 2), expectedOrder(pipeline));
+
+    // 热重载保持节点ID，模型不变
+    ASSERT_TRUE(pipeline.reloadFromString(pipelineJson));
+    EXPECT_EQ(pipeline.getTransitionModel().predict(pipeline.getNodeId("Start"), 2), expectedOrder(pipeline));
+
+    // 加载节点ID不同的定义后按节点名迁移
+    ASSERT_TRUE(pipeline.loadFromString(reorderedJson));
+    EXPECT_EQ(pipeline.getTransitionModel().predict(pipeline.getNodeId("Start"), 2), expectedOrder(pipeline));
+
+    // 保存后加载到另一个实例
+    ASSERT_TRUE(pipeline.saveTransitionModel(savedPath));
+    Pipeline::Pipeline restored;
+    ASSERT_TRUE(restored.loadFromString(reorderedJson));
+    ASSERT_TRUE(restored.loadTransitionModel(savedPath));
+    EXPECT_EQ(restored.getTransitionModel().predict(restored.getNodeId("Start"), 1),
+              (std::vector<Pipeline::NodeId>{restored.getNodeId("Right")}));
+
+    // 通过执行器加载，执行中记录的转移累加到加载的模型上
+    Pipeline::PipelineExecutor executor;
+    EXPECT_FALSE(executor.loadTransitionModel(savedPath));
+    ASSERT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    executor.stop();
+    ASSERT_TRUE(executor.loadTransitionModel(savedPath));
+    ASSERT_TRUE(executor.reloadFromString(reorderedJson));
+    ASSERT_TRUE(executor.saveTransitionModel(savedPath));
+
+    Pipeline::Pipeline saved;
+    ASSERT_TRUE(saved.loadFromString(pipelineJson));
+    ASSERT_TRUE(saved.loadTransitionModel(savedPath));
+    EXPECT_EQ(saved.getTransitionModel().getCount(saved.getNodeId("Start"), saved.getNodeId("Right")), 3u);
+    EXPECT_EQ(saved.getTransitionModel().getCount(saved.getNodeId("Start"), saved.getNodeId("Left")), 2u);
+    std::filesystem::remove(modelPath);
+    std::filesystem::remove(savedPath);
+}
+
+// 测试运行中热重载在节点之间生效
+TEST(PipelineExecutionTest, HotReloadWhileRunning) {
+    const std::string pipelineJson = R"({
+        "Loop": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 20,
+            "next": ["Loop"]
+        }
+    })";
+
+    std::atomic<bool> stopped{false};
+    std::string stopNode;
+    Pipeline::PipelineExecutor executor;
+    executor.setTaskStopCallback([&stopped, &stopNode](const std::string& nodeName, const std::string&) {
+        stopNode = nodeName;
+        stopped = true;
+    });
+
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Loop"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(executor.getState(), Pipeline::PipelineState::Running);
+    EXPECT_FALSE(stopped);
+
+    // 将Loop的后继节点改为新增的End
+    const std::string reloadedJson = R"({
+        "Loop": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 20,
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+    EXPECT_TRUE(executor.reloadFromString(reloadedJson));
+
+    auto startTime = std::chrono::steady_clock::now();
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    executor.stop();
+
+    EXPECT_TRUE(stopped);
+    EXPECT_EQ(stopNode, "End");
+}
+
+// 测试多个执行器同时运行同一个流水线定义
+TEST(PipelineExecutionTest, SharedDefinition) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 0,
+            "post_delay": 10,
+            "condition_process": {
+                "true": {"override_next": ["End"]}
+            },
+            "next": ["Start"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    auto definition = Pipeline::PipelineDefinition::loadFromString(pipelineJson);
+    ASSERT_NE(definition, nullptr);
+
+    auto runtime = std::make_shared<Pipeline::Runtime>(2);
+    std::atomic<int> stoppedCount{0};
+    std::vector<std::unique_ptr<Pipeline::PipelineExecutor>> executors;
+    for (int i = 0; i < 4; ++i) {
+        auto executor = std::make_unique<Pipeline::PipelineExecutor>(runtime);
+        executor->setTaskStopCallback([&stoppedCount](const std::string& nodeName, const std::string&) {
+            if (nodeName == "End") {
+                ++stoppedCount;
+            }
+        });
+        EXPECT_TRUE(executor->execute(definition, "Start"));
+        executors.push_back(std::move(executor));
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    while (stoppedCount < 4 && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (auto& executor : executors) {
+        executor->stop();
+    }
+
+    EXPECT_EQ(stoppedCount, 4);
+}
+
+// 测试暂停和继续，控制接口立即返回，流水线代码只在运行时的工作线程上执行
+TEST(PipelineExecutionTest, SuspendResume) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 300,
+            "post_delay": 0,
+            "next": ["End"]
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    std::atomic<bool> stopped{false};
+    std::thread::id stopThread;
+    Pipeline::PipelineExecutor executor;
+    executor.setTaskStopCallback([&stopped, &stopThread](const std::string&, const std::string&) {
+        stopThread = std::this_thread::get_id();
+        stopped = true;
+    });
+
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    executor.suspend();
+    EXPECT_EQ(executor.getState(), Pipeline::PipelineState::Suspended);
+
+    // 暂停期间不会执行后续节点
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    EXPECT_FALSE(stopped);
+
+    auto startTime = std::chrono::steady_clock::now();
+    executor.resume();
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    EXPECT_LT(elapsedTime, 50);
+    EXPECT_FALSE(stopped);
+
+    startTime = std::chrono::steady_clock::now();
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    executor.stop();
+
+    EXPECT_TRUE(stopped);
+    EXPECT_NE(stopThread, std::this_thread::get_id());
+}
+
+// 测试分层时间轮，定时器按到期时间取出，不会提前到期，取消的定时器不再取出
+TEST(PipelineExecutionTest, TimerWheel) {
+    auto start = std::chrono::steady_clock::now();
+    Pipeline::TimerWheel wheel(start);
+
+    // 分别落在第0层、第1层、第2层和超出时间轮范围
+    std::vector<std::chrono::milliseconds> offsets = {
+        std::chrono::milliseconds(5), std::chrono::milliseconds(63), std::chrono::milliseconds(64),
+        std::chrono::milliseconds(1000), std::chrono::milliseconds(5000), std::chrono::hours(10)};
+    std::vector<Pipeline::TimerWheel::Entry> entries(offsets.size());
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        entries[i].deadline = start + offsets[i];
+        wheel.arm(entries[i]);
+    }
+    Pipeline::TimerWheel::Entry cancelled;
+    cancelled.deadline = start + std::chrono::milliseconds(500);
+    wheel.arm(cancelled);
+    EXPECT_EQ(wheel.size(), entries.size() + 1);
+    EXPECT_TRUE(wheel.cancel(cancelled));
+    EXPECT_FALSE(wheel.cancel(cancelled));
+    EXPECT_EQ(wheel.size(), entries.size());
+
+    // 每次推进到下一次唤醒时间，取出的定时器都已到期且按到期时间排列
+    std::vector<Pipeline::TimerWheel::Entry*> expired;
+    auto last = start;
+    while (auto wakeup = wheel.nextWakeup()) {
+        EXPECT_GE(*wakeup, last);
+        last = *wakeup;
+        size_t before = expired.size();
+        wheel.advance(*wakeup, expired);
+        for (size_t i = before; i < expired.size(); ++i) {
+            EXPECT_LE(expired[i]->deadline, *wakeup);
+        }
+    }
+    ASSERT_EQ(expired.size(), entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        EXPECT_EQ(expired[i], &entries[i]);
+        EXPECT_FALSE(entries[i].linked);
+    }
+    EXPECT_TRUE(wheel.empty());
+
+    // 运行时通过时间轮唤醒大量同时等待的协程
+    Pipeline::Runtime runtime(2);
+    std::atomic<int> wokenCount{0};
+    auto sleeper = [](Pipeline::Runtime* runtime, std::atomic<int>* woken, int delayMs) -> Pipeline::Task {
+        co_await Pipeline::delay(runtime, std::chrono::milliseconds(delayMs));
+        ++*woken;
+    };
+    std::vector<Pipeline::Task> tasks;
+    for (int i = 0; i < 1000; ++i) {
+        tasks.push_back(sleeper(&runtime, &wokenCount, 20 + i % 100));
+        tasks.back().start(runtime);
+    }
+    for (auto& task : tasks) {
+        task.wait();
+    }
+    EXPECT_EQ(wokenCount, 1000);
+    EXPECT_EQ(runtime.getTimerCount(), 0u);
+}
+
+// 测试分叉和汇合，all等待全部子流程，race以第一个结束的子流程为准
+TEST(PipelineExecutionTest, ForkJoin) {
+    const std::string pipelineJson = R"({
+        "ForkAll": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "fork": ["BranchA", "BranchB"],
+            "next": ["ForkRace"]
+        },
+        "BranchA": {
+            "recognition": "DirectHit",
+            "pre_delay": 50,
+            "post_delay": 0
+        },
+        "BranchB": {
+            "recognition": "DirectHit",
+            "pre_delay": 100,
+            "post_delay": 0
+        },
+        "ForkRace": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "fork": ["Slow", "Fast"],
+            "join": "race",
+            "next": ["ForkFail"]
+        },
+        "Slow": {
+            "recognition": "DirectHit",
+            "pre_delay": 10000
+        },
+        "Fast": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0
+        },
+        "ForkFail": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "fork": ["BranchA", "Disabled"],
+            "next": ["End"],
+            "on_error": "Recover"
+        },
+        "Disabled": {
+            "enabled": false
+        },
+        "End": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        },
+        "Recover": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    std::atomic<bool> stopped{false};
+    std::string stopNode;
+    Pipeline::PipelineExecutor executor(std::make_shared<Pipeline::Runtime>(2));
+    executor.setTaskStopCallback([&stopped, &stopNode](const std::string& nodeName, const std::string&) {
+        stopNode = nodeName;
+        stopped = true;
+    });
+
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "ForkAll"));
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    executor.stop();
+
+    // race模式下Slow被取消，不必等待它的前置延迟；all模式下任一子流程失败即进入错误处理
+    EXPECT_TRUE(stopped);
+    EXPECT_EQ(stopNode, "Recover");
+    EXPECT_LT(elapsedTime, 2000);
+}
+
+// 测试停止流水线时子流程一起退出
+TEST(PipelineExecutionTest, StopDuringFork) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "fork": ["Wait", "Loop"]
+        },
+        "Wait": {
+            "recognition": "DirectHit",
+            "pre_delay": 10000
+        },
+        "Loop": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 10,
+            "next": ["Loop"]
+        }
+    })";
+
+    Pipeline::PipelineExecutor executor(std::make_shared<Pipeline::Runtime>(2));
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // 子流程运行期间主流程停在分叉节点上
+    EXPECT_EQ(executor.getCurrentNodeName(), "Start");
+    executor.suspend();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    executor.resume();
+
+    auto startTime = std::chrono::steady_clock::now();
+    executor.stop();
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    EXPECT_EQ(executor.getState(), Pipeline::PipelineState::Stopped);
+    EXPECT_LT(elapsedTime, 100);
+}
+
+// 测试暂停和继续之后停止，停止仍然传到各级子流程
+TEST(PipelineExecutionTest, StopAfterSuspendDuringFork) {
+    const std::string pipelineJson = R"({
+        "Start": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "fork": ["Inner"]
+        },
+        "Inner": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 0,
+            "fork": ["Wait", "Loop"]
+        },
+        "Wait": {
+            "recognition": "DirectHit",
+            "pre_delay": 10000
+        },
+        "Loop": {
+            "recognition": "DirectHit",
+            "pre_delay": 0,
+            "post_delay": 10,
+            "next": ["Loop"]
+        }
+    })";
+
+    Pipeline::PipelineExecutor executor(std::make_shared<Pipeline::Runtime>(2));
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // 每次继续之后子流程都重新进入等待
+    for (int i = 0; i < 2; ++i) {
+        executor.suspend();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        executor.resume();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_EQ(executor.getState(), Pipeline::PipelineState::Running);
+
+    auto startTime = std::chrono::steady_clock::now();
+    executor.stop();
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    EXPECT_EQ(executor.getState(), Pipeline::PipelineState::Stopped);
+    EXPECT_LT(elapsedTime, 100);
+}
+
+// 测试看门狗按自己的间隔评估，命中时抢占主流程的当前节点
+TEST(PipelineExecutionTest, WatchdogPreemption) {
+    const std::string pipelineJson = R"({
+        "watchdog": {
+            "Guard": {"interval": 200, "priority": 1}
+        },
+        "Start": {
+            "recognition": "DirectHit",
+            "action": "DoNothing",
+            "pre_delay": 10000
+        },
+        "Guard": {
+            "recognition": "DirectHit",
+            "action": "StopTask",
+            "pre_delay": 0,
+            "post_delay": 0
+        }
+    })";
+
+    std::atomic<bool> stopped{false};
+    std::string stopNode;
+    Pipeline::PipelineExecutor executor(std::make_shared<Pipeline::Runtime>(1));
+    executor.setTaskStopCallback([&stopped, &stopNode](const std::string& nodeName, const std::string&) {
+        stopNode = nodeName;
+        stopped = true;
+    });
+
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(executor.executeFromString(pipelineJson, "Start"));
+    while (!stopped && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    executor.stop();
+
+    // 主流程停在Start的前置延迟中，看门狗命中后不必等待延迟结束
+    EXPECT_TRUE(stopped);
+    EXPECT_EQ(stopNode, "Guard");
+    EXPECT_LT(elapsedTime, 1000);
+}